@@ -10,6 +10,7 @@
 
 #include <string>
 #include <tuple>
+#include <vector>
 
 #include "test/codec_factory.h"
 #include "test/decode_test_driver.h"
@@ -110,6 +111,77 @@ TEST_P(DecodePerfTest, PerfTest) {
 INSTANTIATE_TEST_SUITE_P(VP9, DecodePerfTest,
                          ::testing::ValuesIn(kVP9DecodePerfVectors));
 
+/*
+ DecodeThreadScalingPerfTest decodes the same stream with row based
+ multi-threading at increasing thread counts and reports the speedup over a
+ single thread. The compressed frames are read into memory up front so only
+ decoding is timed.
+ */
+const char *const kVP9DecodeScalingVectors[] = {
+  "vp90-2-bbb_1920x1080_tile_1x4_2586kbps.webm",
+  "vp90-2-sintel_1280x546_tile_1x4_1257kbps.webm",
+  "vp90-2-tos_1920x800_tile_1x4_fpm_2335kbps.webm",
+};
+
+const unsigned int kScalingThreads[] = { 1, 2, 4, 8, 16 };
+const size_t kNumScalingThreads =
+    sizeof(kScalingThreads) / sizeof(kScalingThreads[0]);
+
+class DecodeThreadScalingPerfTest
+    : public ::testing::TestWithParam<const char *> {};
+
+TEST_P(DecodeThreadScalingPerfTest, PerfTest) {
+  const char *const video_name = GetParam();
+
+  libvpx_test::WebMVideoSource video(video_name);
+  video.Init();
+  std::vector<std::vector<uint8_t> > frames;
+  for (video.Begin(); video.cxdata() != nullptr; video.Next()) {
+    frames.emplace_back(video.cxdata(), video.cxdata() + video.frame_size());
+  }
+  ASSERT_FALSE(frames.empty());
+
+  printf("{\n");
+  printf("\t\"type\" : \"decode_thread_scaling_perf_test\",\n");
+  printf("\t\"version\" : \"%s\",\n", vpx_codec_version_str());
+  printf("\t\"videoName\" : \"%s\",\n", video_name);
+  printf("\t\"totalFrames\" : %u,\n", static_cast<unsigned>(frames.size()));
+  printf("\t\"results\" : [\n");
+
+  double single_thread_fps = 0.0;
+  for (size_t i = 0; i < kNumScalingThreads; ++i) {
+    const unsigned int threads = kScalingThreads[i];
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    cfg.threads = threads;
+    libvpx_test::VP9Decoder decoder(cfg, 0);
+    decoder.Control(VP9D_SET_ROW_MT, 1);
+
+    vpx_usec_timer t;
+    vpx_usec_timer_start(&t);
+
+    for (const std::vector<uint8_t> &frame : frames) {
+      ASSERT_EQ(VPX_CODEC_OK, decoder.DecodeFrame(frame.data(), frame.size()));
+    }
+
+    vpx_usec_timer_mark(&t);
+    const double elapsed_secs =
+        static_cast<double>(vpx_usec_timer_elapsed(&t)) / kUsecsInSec;
+    const double fps = static_cast<double>(frames.size()) / elapsed_secs;
+    if (threads == 1) single_thread_fps = fps;
+
+    printf("\t\t{ \"threadCount\" : %u, \"decodeTimeSecs\" : %f, ", threads,
+           elapsed_secs);
+    printf("\"framesPerSecond\" : %f, \"speedup\" : %f }%s\n", fps,
+           fps / single_thread_fps,
+           i + 1 < kNumScalingThreads ? "," : "");
+  }
+  printf("\t]\n");
+  printf("}\n");
+}
+
+INSTANTIATE_TEST_SUITE_P(VP9, DecodeThreadScalingPerfTest,
+                         ::testing::ValuesIn(kVP9DecodeScalingVectors));
+
 class VP9NewEncodeDecodePerfTest
     : public ::libvpx_test::EncoderTest,
       public ::libvpx_test::CodecTestWithParam<libvpx_test::TestMode> {
@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdlib>
 #include <memory>
 #include <new>
 #include <ostream>
@@ -22,6 +23,7 @@
 #include "test/codec_factory.h"
 #include "test/decode_test_driver.h"
 #include "test/ivf_video_source.h"
+#include "test/md5_helper.h"
 #include "test/test_vectors.h"
 #include "test/util.h"
 #if CONFIG_WEBM_IO
@@ -80,16 +82,16 @@ class PostProcTest : public ::libvpx_test::DecoderTest,
     }
   }
 
-  void DecodeTest();
+  void DecodeTest(int threads = 2);
 
  private:
   int postproc_flags_;
 };
 
-void PostProcTest::DecodeTest() {
+void PostProcTest::DecodeTest(int threads) {
   const std::string filename = GET_PARAM(1).filename;
   vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
-  cfg.threads = 2;
+  cfg.threads = threads;
 
   // Open compressed video file.
   std::unique_ptr<libvpx_test::CompressedVideoSource> video;
@@ -174,6 +176,35 @@ class PostProcTestInvalidFiles : public PostProcTest {
 
 TEST_P(PostProcTestInvalidFiles, Decode) { DecodeTest(); }
 
+// With more than one thread the decoder spreads post-processing over its tile
+// workers. The output must match post-processing on a single thread.
+class PostProcThreadTest : public PostProcTest {
+ protected:
+  void DecompressedFrameHook(const vpx_image_t &img,
+                             const unsigned int /*frame_number*/) override {
+    libvpx_test::MD5 md5;
+    md5.Add(&img);
+    md5s_.push_back(md5.Get());
+  }
+
+  std::vector<std::string> md5s_;
+};
+
+TEST_P(PostProcThreadTest, MatchesSingleThread) {
+  // Demacroblocking draws its dither offset from rand().
+  srand(0);
+  ASSERT_NO_FATAL_FAILURE(DecodeTest(1));
+  if (IsSkipped()) return;
+  const std::vector<std::string> expected = md5s_;
+  ASSERT_FALSE(expected.empty());
+  for (const int threads : { 2, 5 }) {
+    md5s_.clear();
+    srand(0);
+    ASSERT_NO_FATAL_FAILURE(DecodeTest(threads));
+    EXPECT_EQ(expected, md5s_) << "threads: " << threads;
+  }
+}
+
 #if CONFIG_VP8_DECODER && CONFIG_POSTPROC
 VP8_INSTANTIATE_TEST_SUITE(
     PostProcTest,
@@ -233,6 +264,18 @@ VP9_INSTANTIATE_TEST_SUITE(PostProcTestInvalidFiles,
                            ::testing::ValuesIn(GenerateTestParams(
                                GeneratePostProcFlags(), kVP9InvalidFiles)));
 
+constexpr std::array<const char *, 4> kVP9ThreadFiles = {
+  "vp90-2-08-tile-4x4.webm", "vp90-2-08-tile_1x8.webm",
+  "vp90-2-02-size-lf-1920x1080.webm", "vp91-2-04-yuv444.webm"
+};
+
+VP9_INSTANTIATE_TEST_SUITE(
+    PostProcThreadTest,
+    ::testing::ValuesIn(GenerateTestParams(
+        std::vector<int>{ VP8_DEBLOCK, VP8_DEMACROBLOCK, VP8_MFQE,
+                          VP8_MFQE | VP8_DEBLOCK, VP8_MFQE | VP8_DEMACROBLOCK },
+        kVP9ThreadFiles)));
+
 #endif  // CONFIG_VP9_DECODER && CONFIG_VP9_POSTPROC
 
 }  // namespace
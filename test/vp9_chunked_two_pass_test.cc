@@ -0,0 +1,261 @@
+/*
+ *  Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "test/acm_random.h"
+#include "./vpx_config.h"
+#include "vp9/encoder/vp9_firstpass_stats.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vp8dx.h"
+#include "vpx/vpx_decoder.h"
+#include "vpx/vpx_encoder.h"
+
+namespace {
+
+const int kWidth = 176;
+const int kHeight = 144;
+const int kChunkFrames = 12;
+const int kClipFrames = 2 * kChunkFrames;
+
+// Frame n of a clip of moving gradients whose second chunk is noisier, and so
+// harder to code, than its first.
+void FillFrame(vpx_image_t *img, int n) {
+  ::libvpx_test::ACMRandom rnd(n + 1);
+  const int noise = n < kChunkFrames ? 4 : 24;
+  for (int y = 0; y < kHeight; ++y) {
+    uint8_t *const row = img->planes[VPX_PLANE_Y] + y * img->stride[0];
+    for (int x = 0; x < kWidth; ++x) {
+      row[x] = static_cast<uint8_t>(((x + 3 * n) ^ (y - n)) +
+                                    rnd.Rand8() % noise);
+    }
+  }
+  for (int plane = VPX_PLANE_U; plane <= VPX_PLANE_V; ++plane) {
+    for (int y = 0; y < kHeight / 2; ++y) {
+      memset(img->planes[plane] + y * img->stride[plane], 128 + plane,
+             kWidth / 2);
+    }
+  }
+}
+
+vpx_codec_enc_cfg_t GetConfig(vpx_enc_pass pass, const std::string *stats) {
+  vpx_codec_enc_cfg_t cfg;
+  EXPECT_EQ(vpx_codec_enc_config_default(vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_OK);
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_timebase.num = 1;
+  cfg.g_timebase.den = 30;
+  cfg.g_pass = pass;
+  cfg.rc_end_usage = VPX_VBR;
+  cfg.rc_target_bitrate = 200;
+  if (stats != nullptr) {
+    cfg.rc_twopass_stats_in.buf = const_cast<char *>(stats->data());
+    cfg.rc_twopass_stats_in.sz = stats->size();
+  }
+  return cfg;
+}
+
+// Encodes frames first_frame to first_frame + num_frames - 1 of the clip,
+// appending the first pass stats to *stats_out and the size of the second
+// pass frames to *bytes. The second pass frames are checked to decode.
+void EncodeFrames(const vpx_codec_enc_cfg_t &cfg,
+                  vpx_two_pass_chunk_t *chunk, int first_frame,
+                  int num_frames, std::string *stats_out, size_t *bytes) {
+  vpx_codec_ctx_t enc;
+  vpx_codec_ctx_t dec;
+  vpx_image_t img;
+  ASSERT_EQ(vpx_codec_enc_init(&enc, vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_OK);
+  ASSERT_EQ(vpx_codec_dec_init(&dec, vpx_codec_vp9_dx(), nullptr, 0),
+            VPX_CODEC_OK);
+  ASSERT_NE(vpx_img_alloc(&img, VPX_IMG_FMT_I420, kWidth, kHeight, 1),
+            nullptr);
+  EXPECT_EQ(vpx_codec_control(&enc, VP8E_SET_CPUUSED, 4), VPX_CODEC_OK);
+  if (chunk != nullptr) {
+    EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_TWO_PASS_CHUNK, chunk),
+              VPX_CODEC_OK);
+  }
+
+  int frames_in = 0;
+  int frames_out = 0;
+  bool flushed = false;
+  while (!flushed) {
+    const bool flush = frames_in == num_frames;
+    if (!flush) FillFrame(&img, first_frame + frames_in);
+    ASSERT_EQ(vpx_codec_encode(&enc, flush ? nullptr : &img, frames_in, 1, 0,
+                               VPX_DL_GOOD_QUALITY),
+              VPX_CODEC_OK);
+    if (!flush) ++frames_in;
+
+    bool got_data = false;
+    vpx_codec_iter_t iter = nullptr;
+    while (const vpx_codec_cx_pkt_t *pkt = vpx_codec_get_cx_data(&enc, &iter)) {
+      got_data = true;
+      if (pkt->kind == VPX_CODEC_STATS_PKT) {
+        stats_out->append(static_cast<char *>(pkt->data.twopass_stats.buf),
+                          pkt->data.twopass_stats.sz);
+      } else if (pkt->kind == VPX_CODEC_CX_FRAME_PKT) {
+        // Each chunk starts with a key frame.
+        if (frames_out == 0) {
+          EXPECT_NE(pkt->data.frame.flags & VPX_FRAME_IS_KEY, 0u);
+        }
+        *bytes += pkt->data.frame.sz;
+        ASSERT_EQ(
+            vpx_codec_decode(&dec, static_cast<uint8_t *>(pkt->data.frame.buf),
+                             static_cast<unsigned int>(pkt->data.frame.sz),
+                             nullptr, 0),
+            VPX_CODEC_OK);
+        vpx_codec_iter_t dec_iter = nullptr;
+        while (vpx_codec_get_frame(&dec, &dec_iter) != nullptr) ++frames_out;
+      }
+    }
+    flushed = flush && !got_data;
+  }
+  if (cfg.g_pass == VPX_RC_LAST_PASS) {
+    EXPECT_EQ(frames_out, num_frames);
+  }
+
+  vpx_img_free(&img);
+  EXPECT_EQ(vpx_codec_destroy(&dec), VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
+}
+
+void FirstPass(int first_frame, int num_frames, std::string *stats) {
+  size_t bytes = 0;
+  EncodeFrames(GetConfig(VPX_RC_FIRST_PASS, nullptr), nullptr, first_frame,
+               num_frames, stats, &bytes);
+}
+
+void SecondPass(const std::string &stats, vpx_two_pass_chunk_t *chunk,
+                int first_frame, int num_frames, size_t *bytes) {
+  std::string stats_out;
+  EncodeFrames(GetConfig(VPX_RC_LAST_PASS, &stats), chunk, first_frame,
+               num_frames, &stats_out, bytes);
+}
+
+vpx_codec_err_t Merge(const std::string &chunk0, const std::string &chunk1,
+                      std::string *stats) {
+  vpx_fixed_buf_t chunk_stats[2] = {
+    { const_cast<char *>(chunk0.data()), chunk0.size() },
+    { const_cast<char *>(chunk1.data()), chunk1.size() },
+  };
+  stats->resize(chunk0.size() + chunk1.size());
+  vpx_fixed_buf_t merged = { &(*stats)[0], stats->size() };
+  const int num_chunks = chunk1.empty() ? 1 : 2;
+  const vpx_codec_err_t res =
+      vpx_codec_vp9_merge_first_pass_stats(chunk_stats, num_chunks, &merged);
+  if (res == VPX_CODEC_OK) stats->resize(merged.sz);
+  return res;
+}
+
+TEST(VP9ChunkedTwoPassTest, MergesFirstPassStats) {
+  std::string clip_stats, stats0, stats1, merged;
+  ASSERT_NO_FATAL_FAILURE(FirstPass(0, kClipFrames, &clip_stats));
+  ASSERT_NO_FATAL_FAILURE(FirstPass(0, kChunkFrames, &stats0));
+  ASSERT_NO_FATAL_FAILURE(FirstPass(kChunkFrames, kChunkFrames, &stats1));
+  ASSERT_EQ(clip_stats.size(), (kClipFrames + 1) * sizeof(FIRSTPASS_STATS));
+
+  // The stats of a single chunk are unchanged.
+  ASSERT_EQ(Merge(clip_stats, std::string(), &merged), VPX_CODEC_OK);
+  EXPECT_EQ(merged, clip_stats);
+
+  // The first chunk has the same first pass as the clip, and the second
+  // chunk follows it.
+  ASSERT_EQ(Merge(stats0, stats1, &merged), VPX_CODEC_OK);
+  ASSERT_EQ(merged.size(), clip_stats.size());
+  const size_t chunk0_size = kChunkFrames * sizeof(FIRSTPASS_STATS);
+  EXPECT_EQ(merged.compare(0, chunk0_size, clip_stats, 0, chunk0_size), 0);
+  const FIRSTPASS_STATS *const stats =
+      reinterpret_cast<const FIRSTPASS_STATS *>(merged.data());
+  for (int i = 0; i < kClipFrames; ++i) EXPECT_EQ(stats[i].frame, i);
+  EXPECT_EQ(stats[kClipFrames].count, kClipFrames);
+
+  // Incomplete stats are rejected.
+  EXPECT_EQ(Merge(stats0, stats1.substr(0, stats1.size() - 1), &merged),
+            VPX_CODEC_INVALID_PARAM);
+  EXPECT_EQ(Merge(stats0, stats1.substr(0, chunk0_size), &merged),
+            VPX_CODEC_INVALID_PARAM);
+}
+
+TEST(VP9ChunkedTwoPassTest, ChunksShareClipBits) {
+  std::string stats0, stats1, merged;
+  ASSERT_NO_FATAL_FAILURE(FirstPass(0, kChunkFrames, &stats0));
+  ASSERT_NO_FATAL_FAILURE(FirstPass(kChunkFrames, kChunkFrames, &stats1));
+  ASSERT_EQ(Merge(stats0, stats1, &merged), VPX_CODEC_OK);
+
+  size_t bytes0 = 0, bytes1 = 0, chunk_bytes0 = 0, chunk_bytes1 = 0;
+  ASSERT_NO_FATAL_FAILURE(
+      SecondPass(stats0, nullptr, 0, kChunkFrames, &bytes0));
+  ASSERT_NO_FATAL_FAILURE(
+      SecondPass(stats1, nullptr, kChunkFrames, kChunkFrames, &bytes1));
+  vpx_two_pass_chunk_t chunk0 = { 0, kChunkFrames };
+  vpx_two_pass_chunk_t chunk1 = { kChunkFrames, kChunkFrames };
+  ASSERT_NO_FATAL_FAILURE(
+      SecondPass(merged, &chunk0, 0, kChunkFrames, &chunk_bytes0));
+  ASSERT_NO_FATAL_FAILURE(
+      SecondPass(merged, &chunk1, kChunkFrames, kChunkFrames, &chunk_bytes1));
+
+  // Coded separately, each chunk gets the bits of its duration. Coded as
+  // chunks of the clip, the harder chunk gets bits from the easier one, as
+  // when the clip is coded by a single encoder.
+  EXPECT_LT(chunk_bytes0, bytes0);
+  EXPECT_GT(chunk_bytes1, bytes1);
+  size_t clip_bytes = 0;
+  ASSERT_NO_FATAL_FAILURE(
+      SecondPass(merged, nullptr, 0, kClipFrames, &clip_bytes));
+  EXPECT_GE(chunk_bytes0 + chunk_bytes1, clip_bytes * 9 / 10);
+  EXPECT_LE(chunk_bytes0 + chunk_bytes1, clip_bytes * 11 / 10);
+}
+
+TEST(VP9ChunkedTwoPassTest, RejectsInvalidChunks) {
+  std::string stats;
+  ASSERT_NO_FATAL_FAILURE(FirstPass(0, kChunkFrames, &stats));
+  const vpx_codec_enc_cfg_t cfg = GetConfig(VPX_RC_LAST_PASS, &stats);
+  vpx_codec_ctx_t enc;
+  ASSERT_EQ(vpx_codec_enc_init(&enc, vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_OK);
+
+  vpx_two_pass_chunk_t outside[] = {
+    { -1, 2 }, { 0, 0 }, { 0, kChunkFrames + 1 }, { kChunkFrames, 1 }
+  };
+  for (vpx_two_pass_chunk_t &chunk : outside) {
+    EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_TWO_PASS_CHUNK, &chunk),
+              VPX_CODEC_INVALID_PARAM);
+  }
+  vpx_two_pass_chunk_t chunk = { 2, kChunkFrames - 2 };
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_TWO_PASS_CHUNK, &chunk),
+            VPX_CODEC_OK);
+
+  // The chunk can't change once the encoder has frames.
+  vpx_image_t img;
+  ASSERT_NE(vpx_img_alloc(&img, VPX_IMG_FMT_I420, kWidth, kHeight, 1),
+            nullptr);
+  FillFrame(&img, 2);
+  ASSERT_EQ(vpx_codec_encode(&enc, &img, 0, 1, 0, VPX_DL_GOOD_QUALITY),
+            VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_TWO_PASS_CHUNK, &chunk),
+            VPX_CODEC_INVALID_PARAM);
+  vpx_img_free(&img);
+  EXPECT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
+
+  // A one pass encoder has no stats to take the chunk from.
+  const vpx_codec_enc_cfg_t one_pass_cfg =
+      GetConfig(VPX_RC_ONE_PASS, nullptr);
+  ASSERT_EQ(vpx_codec_enc_init(&enc, vpx_codec_vp9_cx(), &one_pass_cfg, 0),
+            VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_TWO_PASS_CHUNK, &chunk),
+            VPX_CODEC_INVALID_PARAM);
+  EXPECT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
+}
+
+}  // namespace
@@ -0,0 +1,237 @@
+/*
+ *  Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "./vpx_config.h"
+#include "test/codec_factory.h"
+#include "test/decode_test_driver.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vp8dx.h"
+
+namespace {
+
+enum DecodeMode { kSerial, kTileMt, kLpfOpt, kRowMt, kFrameParallel };
+
+const int kNumFrames = 12;
+
+// Diagonal ramps moving by half a pixel a frame.
+class MovingRampSource : public ::libvpx_test::DummyVideoSource {
+ protected:
+  void FillFrame() override {
+    if (img_ == nullptr) return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const unsigned int w = plane ? (img_->d_w + 1) / 2 : img_->d_w;
+      const unsigned int h = plane ? (img_->d_h + 1) / 2 : img_->d_h;
+      const unsigned int shift = frame_ >> (plane ? 2 : 1);
+      for (unsigned int y = 0; y < h; ++y) {
+        uint8_t *const row = img_->planes[plane] + y * img_->stride[plane];
+        for (unsigned int x = 0; x < w; ++x) {
+          const unsigned int u = x - shift, v = y - shift;
+          row[x] = static_cast<uint8_t>(((u * 3) ^ (v * 5)) + (u & v));
+        }
+      }
+    }
+  }
+};
+
+// md5s of a decoded frame, of all of it and of its luma plane only.
+struct FrameMd5 {
+  std::string all;
+  std::string luma;
+  int complexity_level;
+};
+
+// Encodes a clip with two tile columns in which every third frame updates no
+// reference frame, then checks the frames decoded at each complexity level
+// against a full decode.
+class VP9ComplexityLevelTest
+    : public ::libvpx_test::EncoderTest,
+      public ::libvpx_test::CodecTestWithParam<DecodeMode> {
+ protected:
+  VP9ComplexityLevelTest() : EncoderTest(GET_PARAM(0)), mode_(GET_PARAM(1)) {}
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = VPX_VBR;
+    cfg_.rc_target_bitrate = 200;
+  }
+
+  void BeginPassHook(unsigned int /*pass*/) override {
+    encoder_initialized_ = false;
+    frames_.clear();
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (!encoder_initialized_) {
+      encoder->Control(VP8E_SET_CPUUSED, 4);
+      encoder->Control(VP9E_SET_TILE_COLUMNS, 1);
+      encoder_initialized_ = true;
+    }
+    frame_flags_ = IsReference(video->frame()) ? 0
+                                               : VP8_EFLAG_NO_UPD_LAST |
+                                                     VP8_EFLAG_NO_UPD_GF |
+                                                     VP8_EFLAG_NO_UPD_ARF;
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    const uint8_t *const buf =
+        static_cast<const uint8_t *>(pkt->data.frame.buf);
+    frames_.emplace_back(buf, buf + pkt->data.frame.sz);
+  }
+
+  static bool IsReference(size_t frame) { return frame % 3 != 2; }
+
+  // Decodes all the frames, at level levels[i] for frame i, and returns the
+  // frames output.
+  std::vector<FrameMd5> Decode(const std::vector<int> &levels,
+                               int skip_loop_filter) {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    cfg.threads = mode_ == kSerial ? 1 : 4;
+    libvpx_test::VP9Decoder decoder(cfg, 0);
+    decoder.Control(VP9D_SET_LOOP_FILTER_OPT, mode_ == kLpfOpt);
+    decoder.Control(VP9D_SET_ROW_MT, mode_ == kRowMt);
+    decoder.Control(VP9D_SET_FRAME_PARALLEL, mode_ == kFrameParallel);
+    decoder.Control(VP9_SET_SKIP_LOOP_FILTER, skip_loop_filter);
+
+    std::vector<FrameMd5> md5s;
+    for (size_t i = 0; i < frames_.size(); ++i) {
+      decoder.Control(VP9D_SET_COMPLEXITY_LEVEL, levels[i]);
+      const vpx_codec_err_t res =
+          decoder.DecodeFrame(frames_[i].data(), frames_[i].size());
+      EXPECT_EQ(VPX_CODEC_OK, res) << decoder.DecodeError();
+      GetOutput(&decoder, &md5s);
+    }
+    EXPECT_EQ(VPX_CODEC_OK, decoder.DecodeFrame(nullptr, 0));
+    GetOutput(&decoder, &md5s);
+    EXPECT_EQ(frames_.size(), md5s.size());
+    return md5s;
+  }
+
+  static void GetOutput(libvpx_test::VP9Decoder *decoder,
+                        std::vector<FrameMd5> *md5s) {
+    libvpx_test::DxDataIterator dec_iter = decoder->GetDxData();
+    while (const vpx_image_t *img = dec_iter.Next()) {
+      FrameMd5 frame;
+      libvpx_test::MD5 all, luma;
+      all.Add(img);
+      for (unsigned int y = 0; y < img->d_h; ++y) {
+        luma.Add(img->planes[VPX_PLANE_Y] + y * img->stride[VPX_PLANE_Y],
+                 img->d_w);
+      }
+      frame.all = all.Get();
+      frame.luma = luma.Get();
+      EXPECT_EQ(VPX_CODEC_OK,
+                vpx_codec_control(decoder->GetDecoder(),
+                                  VP9D_GET_COMPLEXITY_LEVEL,
+                                  &frame.complexity_level));
+      md5s->push_back(frame);
+    }
+  }
+
+  void Encode() {
+    MovingRampSource video;
+    video.SetSize(352, 288);
+    video.set_limit(kNumFrames);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    ASSERT_EQ(static_cast<size_t>(kNumFrames), frames_.size());
+  }
+
+  DecodeMode mode_;
+  bool encoder_initialized_;
+  std::vector<std::vector<uint8_t> > frames_;
+};
+
+TEST_P(VP9ComplexityLevelTest, ReferenceFramesUnchanged) {
+  ASSERT_NO_FATAL_FAILURE(Encode());
+  const std::vector<FrameMd5> full = Decode(std::vector<int>(kNumFrames), 0);
+
+  for (int level = 1; level <= 2; ++level) {
+    const std::vector<FrameMd5> md5s =
+        Decode(std::vector<int>(kNumFrames, level), 0);
+    int num_changed = 0;
+    ASSERT_EQ(full.size(), md5s.size());
+    for (size_t i = 0; i < md5s.size(); ++i) {
+      if (IsReference(i)) {
+        EXPECT_EQ(full[i].all, md5s[i].all) << "level " << level << " " << i;
+      } else {
+        num_changed += full[i].all != md5s[i].all;
+      }
+      EXPECT_EQ(level, md5s[i].complexity_level);
+    }
+    // The non-reference frames have subpel motion.
+    if (level == 2) {
+      EXPECT_GT(num_changed, 0);
+    }
+  }
+}
+
+TEST_P(VP9ComplexityLevelTest, LumaUnchangedWithoutChromaFilter) {
+  ASSERT_NO_FATAL_FAILURE(Encode());
+  const std::vector<FrameMd5> full = Decode(std::vector<int>(kNumFrames), 0);
+  const std::vector<FrameMd5> md5s =
+      Decode(std::vector<int>(kNumFrames, 3), 0);
+  ASSERT_EQ(full.size(), md5s.size());
+  for (size_t i = 0; i < md5s.size(); ++i) {
+    if (IsReference(i)) {
+      EXPECT_EQ(full[i].luma, md5s[i].luma) << i;
+    }
+    EXPECT_EQ(3, md5s[i].complexity_level);
+  }
+  // The key frame is loop filtered.
+  EXPECT_NE(full[0].all, md5s[0].all);
+}
+
+TEST_P(VP9ComplexityLevelTest, MatchesSkipLoopFilter) {
+  ASSERT_NO_FATAL_FAILURE(Encode());
+  const std::vector<FrameMd5> skip_lf = Decode(std::vector<int>(kNumFrames), 1);
+  const std::vector<FrameMd5> level2 =
+      Decode(std::vector<int>(kNumFrames, 2), 1);
+  const std::vector<FrameMd5> level4 =
+      Decode(std::vector<int>(kNumFrames, 4), 0);
+  ASSERT_EQ(skip_lf.size(), level4.size());
+  for (size_t i = 0; i < level4.size(); ++i) {
+    EXPECT_EQ(level2[i].all, level4[i].all) << i;
+    if (IsReference(i)) {
+      EXPECT_EQ(skip_lf[i].all, level4[i].all) << i;
+    }
+  }
+}
+
+TEST_P(VP9ComplexityLevelTest, ChangesBetweenFrames) {
+  ASSERT_NO_FATAL_FAILURE(Encode());
+  std::vector<int> levels(kNumFrames);
+  for (int i = 0; i < kNumFrames; ++i) levels[i] = (i / 2) % 3;
+  const std::vector<FrameMd5> full = Decode(std::vector<int>(kNumFrames), 0);
+  const std::vector<FrameMd5> md5s = Decode(levels, 0);
+  ASSERT_EQ(full.size(), md5s.size());
+  for (size_t i = 0; i < md5s.size(); ++i) {
+    if (IsReference(i) || levels[i] == 0) {
+      EXPECT_EQ(full[i].all, md5s[i].all) << i;
+    }
+    EXPECT_EQ(levels[i], md5s[i].complexity_level) << i;
+  }
+}
+
+VP9_INSTANTIATE_TEST_SUITE(VP9ComplexityLevelTest,
+                           ::testing::Values(kSerial, kTileMt, kLpfOpt, kRowMt,
+                                             kFrameParallel));
+
+}  // namespace
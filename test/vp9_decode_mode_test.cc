@@ -0,0 +1,222 @@
+/*
+ *  Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "./vpx_config.h"
+#include "test/codec_factory.h"
+#include "test/decode_test_driver.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vp8dx.h"
+
+namespace {
+
+enum DecodeMode { kSerial, kTileMt, kFrameParallel };
+
+const int kKeyFrameInterval = 6;
+const int kNumFrames = 20;
+
+// Diagonal ramps moving right and down.
+class MovingRampSource : public ::libvpx_test::DummyVideoSource {
+ protected:
+  void FillFrame() override {
+    if (img_ == nullptr) return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const unsigned int w = plane ? (img_->d_w + 1) / 2 : img_->d_w;
+      const unsigned int h = plane ? (img_->d_h + 1) / 2 : img_->d_h;
+      const unsigned int shift = (2 * frame_) >> (plane ? 1 : 0);
+      for (unsigned int y = 0; y < h; ++y) {
+        uint8_t *const row = img_->planes[plane] + y * img_->stride[plane];
+        for (unsigned int x = 0; x < w; ++x) {
+          const unsigned int u = x - shift, v = y - shift;
+          row[x] = static_cast<uint8_t>(((u * 3) ^ (v * 5)) + (u & v));
+        }
+      }
+    }
+  }
+};
+
+// Encodes a clip with a key frame every kKeyFrameInterval frames, in which
+// every third frame updates no reference frame, then checks the frames output
+// in each decode mode against a regular decode.
+class VP9DecodeModeTest
+    : public ::libvpx_test::EncoderTest,
+      public ::libvpx_test::CodecTestWithParam<DecodeMode> {
+ protected:
+  VP9DecodeModeTest() : EncoderTest(GET_PARAM(0)), mode_(GET_PARAM(1)) {}
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = VPX_VBR;
+    cfg_.rc_target_bitrate = 300;
+    cfg_.kf_min_dist = kKeyFrameInterval;
+    cfg_.kf_max_dist = kKeyFrameInterval;
+  }
+
+  void BeginPassHook(unsigned int /*pass*/) override {
+    encoder_initialized_ = false;
+    frames_.clear();
+    is_key_frame_.clear();
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (!encoder_initialized_) {
+      encoder->Control(VP8E_SET_CPUUSED, 4);
+      encoder->Control(VP9E_SET_TILE_COLUMNS, 1);
+      encoder_initialized_ = true;
+    }
+    frame_flags_ = video->frame() % 3 == 2 ? VP8_EFLAG_NO_UPD_LAST |
+                                                 VP8_EFLAG_NO_UPD_GF |
+                                                 VP8_EFLAG_NO_UPD_ARF
+                                           : 0;
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    const uint8_t *const buf =
+        static_cast<const uint8_t *>(pkt->data.frame.buf);
+    frames_.emplace_back(buf, buf + pkt->data.frame.sz);
+    is_key_frame_.push_back((pkt->data.frame.flags & VPX_FRAME_IS_KEY) != 0);
+  }
+
+  std::unique_ptr<libvpx_test::VP9Decoder> CreateDecoder() {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    cfg.threads = mode_ == kSerial ? 1 : 4;
+    std::unique_ptr<libvpx_test::VP9Decoder> decoder(
+        new libvpx_test::VP9Decoder(cfg, 0));
+    decoder->Control(VP9D_SET_FRAME_PARALLEL, mode_ == kFrameParallel);
+    return decoder;
+  }
+
+  static void GetOutput(libvpx_test::VP9Decoder *decoder,
+                        std::vector<std::string> *md5s) {
+    libvpx_test::DxDataIterator dec_iter = decoder->GetDxData();
+    while (const vpx_image_t *img = dec_iter.Next()) {
+      libvpx_test::MD5 md5;
+      md5.Add(img);
+      md5s->push_back(md5.Get());
+    }
+  }
+
+  // Decodes frames_[begin, end), appending the md5 of each output frame to
+  // 'md5s', and returns the number of frames that failed to decode.
+  int DecodeFrames(libvpx_test::VP9Decoder *decoder, size_t begin, size_t end,
+                   std::vector<std::string> *md5s) {
+    int num_errors = 0;
+    for (size_t i = begin; i < end; ++i) {
+      if (decoder->DecodeFrame(frames_[i].data(), frames_[i].size()) !=
+          VPX_CODEC_OK) {
+        ++num_errors;
+      }
+      GetOutput(decoder, md5s);
+    }
+    return num_errors;
+  }
+
+  static void Flush(libvpx_test::VP9Decoder *decoder,
+                    std::vector<std::string> *md5s) {
+    EXPECT_EQ(VPX_CODEC_OK, decoder->DecodeFrame(nullptr, 0));
+    GetOutput(decoder, md5s);
+  }
+
+  void EncodeAndDecode() {
+    MovingRampSource video;
+    video.SetSize(352, 288);
+    video.set_limit(kNumFrames);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    ASSERT_EQ(static_cast<size_t>(kNumFrames), frames_.size());
+    for (int i = 0; i < kNumFrames; ++i) {
+      ASSERT_EQ(i % kKeyFrameInterval == 0, is_key_frame_[i]) << "frame " << i;
+    }
+
+    std::unique_ptr<libvpx_test::VP9Decoder> decoder = CreateDecoder();
+    ASSERT_EQ(0, DecodeFrames(decoder.get(), 0, kNumFrames, &expected_));
+    Flush(decoder.get(), &expected_);
+    ASSERT_EQ(static_cast<size_t>(kNumFrames), expected_.size());
+  }
+
+  DecodeMode mode_;
+  bool encoder_initialized_;
+  std::vector<std::vector<uint8_t> > frames_;
+  std::vector<bool> is_key_frame_;
+  std::vector<std::string> expected_;
+};
+
+TEST_P(VP9DecodeModeTest, KeyFrames) {
+  ASSERT_NO_FATAL_FAILURE(EncodeAndDecode());
+
+  std::unique_ptr<libvpx_test::VP9Decoder> decoder = CreateDecoder();
+  decoder->Control(VP9D_SET_DECODE_MODE, VPX_DECODE_KEY_FRAMES);
+  std::vector<std::string> md5s;
+  // Starts in the middle of a group of frames.
+  EXPECT_EQ(0, DecodeFrames(decoder.get(), 2, kNumFrames, &md5s));
+  Flush(decoder.get(), &md5s);
+
+  std::vector<std::string> key_frame_md5s;
+  for (int i = kKeyFrameInterval; i < kNumFrames; i += kKeyFrameInterval)
+    key_frame_md5s.push_back(expected_[i]);
+  EXPECT_EQ(key_frame_md5s, md5s);
+}
+
+TEST_P(VP9DecodeModeTest, SeekWithReferences) {
+  ASSERT_NO_FATAL_FAILURE(EncodeAndDecode());
+
+  for (int target = kKeyFrameInterval; target < 2 * kKeyFrameInterval;
+       ++target) {
+    std::unique_ptr<libvpx_test::VP9Decoder> decoder = CreateDecoder();
+    decoder->Control(VP9D_SET_DECODE_MODE, VPX_DECODE_REFERENCES);
+    std::vector<std::string> md5s;
+    EXPECT_EQ(0, DecodeFrames(decoder.get(), kKeyFrameInterval, target, &md5s));
+    decoder->Control(VP9D_SET_DECODE_MODE, VPX_DECODE_ALL_FRAMES);
+    EXPECT_EQ(0, DecodeFrames(decoder.get(), target, kNumFrames, &md5s));
+    Flush(decoder.get(), &md5s);
+
+    const std::vector<std::string> tail(expected_.begin() + target,
+                                        expected_.end());
+    EXPECT_EQ(tail, md5s) << "target " << target;
+  }
+}
+
+TEST_P(VP9DecodeModeTest, AllFramesAfterKeyFrames) {
+  ASSERT_NO_FATAL_FAILURE(EncodeAndDecode());
+
+  std::unique_ptr<libvpx_test::VP9Decoder> decoder = CreateDecoder();
+  decoder->Control(VP9D_SET_DECODE_MODE, VPX_DECODE_KEY_FRAMES);
+  std::vector<std::string> md5s;
+  EXPECT_EQ(0, DecodeFrames(decoder.get(), 0, 8, &md5s));
+  // The inter frames up to the next key frame predict from skipped frames.
+  decoder->Control(VP9D_SET_DECODE_MODE, VPX_DECODE_ALL_FRAMES);
+  EXPECT_EQ(2 * kKeyFrameInterval - 8,
+            DecodeFrames(decoder.get(), 8, 2 * kKeyFrameInterval, &md5s));
+  EXPECT_EQ(0, DecodeFrames(decoder.get(), 2 * kKeyFrameInterval, kNumFrames,
+                            &md5s));
+  Flush(decoder.get(), &md5s);
+
+  std::vector<std::string> expected(1, expected_[0]);
+  expected.push_back(expected_[kKeyFrameInterval]);
+  expected.insert(expected.end(), expected_.begin() + 2 * kKeyFrameInterval,
+                  expected_.end());
+  EXPECT_EQ(expected, md5s);
+}
+
+VP9_INSTANTIATE_TEST_SUITE(VP9DecodeModeTest,
+                           ::testing::Values(kSerial, kTileMt,
+                                             kFrameParallel));
+
+}  // namespace
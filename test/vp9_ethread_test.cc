@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <string>
 #include <vector>
 #include "gtest/gtest.h"
@@ -15,6 +17,7 @@
 #include "test/encode_test_driver.h"
 #include "test/md5_helper.h"
 #include "test/util.h"
+#include "test/video_source.h"
 #include "test/y4m_video_source.h"
 #include "vp9/encoder/vp9_firstpass.h"
 #include "vpx_config.h"
@@ -398,6 +401,433 @@ TEST_P(VPxEncoderThreadTest, EncoderResultTest) {
   EXPECT_NEAR(single_thr_psnr, multi_thr_psnr, 0.2);
 }
 
+// A texture moving right and down by a pixel and a half a frame.
+class MovingRampSource : public ::libvpx_test::DummyVideoSource {
+ protected:
+  void FillFrame() override {
+    if (img_ == nullptr) return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const unsigned int w = plane ? (img_->d_w + 1) / 2 : img_->d_w;
+      const unsigned int h = plane ? (img_->d_h + 1) / 2 : img_->d_h;
+      const unsigned int shift = (3 * frame_ / 2) >> (plane ? 1 : 0);
+      for (unsigned int y = 0; y < h; ++y) {
+        uint8_t *const row = img_->planes[plane] + y * img_->stride[plane];
+        for (unsigned int x = 0; x < w; ++x) {
+          const unsigned int u = x - shift, v = y - shift;
+          row[x] = static_cast<uint8_t>(((u * u) ^ (v * v * 3)) + (u & v));
+        }
+      }
+    }
+  }
+};
+
+#if !CONFIG_REALTIME_ONLY
+// Checks that building the TPL model of the alt-ref groups with row based
+// multi-threading gives the same bitstream as building it on one thread.
+class VPxTplEncoderThreadTest
+    : public ::libvpx_test::EncoderTest,
+      public ::libvpx_test::CodecTestWithParam<int> {
+ protected:
+  VPxTplEncoderThreadTest()
+      : EncoderTest(GET_PARAM(0)), encoder_initialized_(false),
+        threads_(GET_PARAM(1)), row_mt_mode_(0) {}
+  ~VPxTplEncoderThreadTest() override = default;
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kTwoPassGood);
+    cfg_.rc_end_usage = VPX_VBR;
+    cfg_.rc_target_bitrate = 500;
+    cfg_.g_lag_in_frames = 16;
+  }
+
+  void BeginPassHook(unsigned int /*pass*/) override {
+    encoder_initialized_ = false;
+    md5_.clear();
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource * /*video*/,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (!encoder_initialized_) {
+      encoder->Control(VP8E_SET_CPUUSED, 2);
+      encoder->Control(VP8E_SET_ENABLEAUTOALTREF, 1);
+      encoder->Control(VP9E_SET_TPL, 1);
+      encoder->Control(VP9E_SET_ROW_MT, row_mt_mode_);
+      encoder_initialized_ = true;
+    }
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    ::libvpx_test::MD5 md5_res;
+    md5_res.Add(static_cast<const uint8_t *>(pkt->data.frame.buf),
+                pkt->data.frame.sz);
+    md5_.push_back(md5_res.Get());
+  }
+
+  std::vector<std::string> Encode(int row_mt_mode, unsigned int threads) {
+    MovingRampSource video;
+    video.SetSize(208, 144);
+    video.set_limit(20);
+    row_mt_mode_ = row_mt_mode;
+    cfg_.g_threads = threads;
+    EXPECT_NO_FATAL_FAILURE(RunLoop(&video));
+    return md5_;
+  }
+
+  bool encoder_initialized_;
+  int threads_;
+  int row_mt_mode_;
+  std::vector<std::string> md5_;
+};
+
+TEST_P(VPxTplEncoderThreadTest, TplResultTest) {
+  const std::vector<std::string> single_thr_md5 = Encode(0, 1);
+  ASSERT_EQ(20u, single_thr_md5.size());
+  EXPECT_EQ(single_thr_md5, Encode(1, 1));
+  EXPECT_EQ(single_thr_md5, Encode(1, threads_));
+}
+
+VP9_INSTANTIATE_TEST_SUITE(VPxTplEncoderThreadTest,
+                           ::testing::Values(2, 4));  // threads
+
+// Checks that filtering the alt-ref frames ahead of time in frame pipelining
+// mode gives the same bitstream as filtering them in turn.
+class VPxFramePipelineTest
+    : public ::libvpx_test::EncoderTest,
+      public ::libvpx_test::CodecTestWith2Params<int, int> {
+ protected:
+  VPxFramePipelineTest()
+      : EncoderTest(GET_PARAM(0)), encoder_initialized_(false),
+        auto_alt_ref_(GET_PARAM(1)), threads_(GET_PARAM(2)), row_mt_mode_(0),
+        frame_pipelining_(0) {}
+  ~VPxFramePipelineTest() override = default;
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kTwoPassGood);
+    cfg_.rc_end_usage = VPX_VBR;
+    cfg_.rc_target_bitrate = 300;
+    cfg_.g_lag_in_frames = 25;
+    cfg_.g_threads = threads_;
+  }
+
+  void BeginPassHook(unsigned int /*pass*/) override {
+    encoder_initialized_ = false;
+    md5_.clear();
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource * /*video*/,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (!encoder_initialized_) {
+      encoder->Control(VP8E_SET_CPUUSED, 3);
+      encoder->Control(VP8E_SET_ENABLEAUTOALTREF, auto_alt_ref_);
+      encoder->Control(VP9E_SET_TILE_COLUMNS, 1);
+      encoder->Control(VP9E_SET_ROW_MT, row_mt_mode_);
+      encoder->Control(VP9E_SET_FRAME_PIPELINING, frame_pipelining_);
+      encoder_initialized_ = true;
+    }
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    ::libvpx_test::MD5 md5_res;
+    md5_res.Add(static_cast<const uint8_t *>(pkt->data.frame.buf),
+                pkt->data.frame.sz);
+    md5_.push_back(md5_res.Get());
+  }
+
+  std::vector<std::string> Encode(int row_mt_mode, int frame_pipelining) {
+    MovingRampSource video;
+    video.SetSize(208, 144);
+    video.set_limit(30);
+    row_mt_mode_ = row_mt_mode;
+    frame_pipelining_ = frame_pipelining;
+    EXPECT_NO_FATAL_FAILURE(RunLoop(&video));
+    return md5_;
+  }
+
+  bool encoder_initialized_;
+  int auto_alt_ref_;
+  int threads_;
+  int row_mt_mode_;
+  int frame_pipelining_;
+  std::vector<std::string> md5_;
+};
+
+TEST_P(VPxFramePipelineTest, FramePipelineResultTest) {
+  const std::vector<std::string> serial_md5 = Encode(0, 0);
+  ASSERT_EQ(30u, serial_md5.size());
+  EXPECT_EQ(serial_md5, Encode(0, 1));
+  EXPECT_EQ(Encode(1, 0), Encode(1, 1));
+}
+
+VP9_INSTANTIATE_TEST_SUITE(VPxFramePipelineTest,
+                           ::testing::Values(1, 6),  // auto_alt_ref
+                           ::testing::Values(2, 4));  // threads
+
+// Smooth waves moving right and down, which get loop filtered at low rates.
+class MovingWaveSource : public ::libvpx_test::DummyVideoSource {
+ protected:
+  void FillFrame() override {
+    if (img_ == nullptr) return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int w = plane ? (img_->d_w + 1) / 2 : img_->d_w;
+      const int h = plane ? (img_->d_h + 1) / 2 : img_->d_h;
+      const int shift = (3 * frame_ / 2) >> (plane ? 1 : 0);
+      for (int y = 0; y < h; ++y) {
+        uint8_t *const row = img_->planes[plane] + y * img_->stride[plane];
+        for (int x = 0; x < w; ++x) {
+          const int u = x - shift, v = y - shift;
+          row[x] = static_cast<uint8_t>(128 + 50 * std::sin(u * 0.05) +
+                                        40 * std::cos(v * 0.07 + u * 0.02) +
+                                        20 * std::sin((u + v) * 0.13));
+        }
+      }
+    }
+  }
+};
+
+// Checks that the loop filter level search, which filters the candidate
+// levels a superblock row at a time on the loop filter workers, gives the
+// same bitstream with any number of threads.
+class VPxLpfSearchThreadTest
+    : public ::libvpx_test::EncoderTest,
+      public ::libvpx_test::CodecTestWithParam<int> {
+ protected:
+  VPxLpfSearchThreadTest()
+      : EncoderTest(GET_PARAM(0)), encoder_initialized_(false),
+        threads_(GET_PARAM(1)), row_mt_mode_(0), max_filter_level_(0) {}
+  ~VPxLpfSearchThreadTest() override = default;
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kOnePassGood);
+    cfg_.rc_end_usage = VPX_VBR;
+    cfg_.rc_target_bitrate = 150;
+    cfg_.g_lag_in_frames = 0;
+  }
+
+  void BeginPassHook(unsigned int /*pass*/) override {
+    encoder_initialized_ = false;
+    md5_.clear();
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource * /*video*/,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (!encoder_initialized_) {
+      encoder->Control(VP8E_SET_CPUUSED, 4);
+      encoder->Control(VP9E_SET_TILE_COLUMNS, 1);
+      encoder->Control(VP9E_SET_ROW_MT, row_mt_mode_);
+      encoder_initialized_ = true;
+    }
+  }
+
+  void PostEncodeFrameHook(::libvpx_test::Encoder *encoder) override {
+    int filter_level = 0;
+    encoder->Control(VP9E_GET_LOOPFILTER_LEVEL, &filter_level);
+    max_filter_level_ = std::max(max_filter_level_, filter_level);
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    ::libvpx_test::MD5 md5_res;
+    md5_res.Add(static_cast<const uint8_t *>(pkt->data.frame.buf),
+                pkt->data.frame.sz);
+    md5_.push_back(md5_res.Get());
+  }
+
+  std::vector<std::string> Encode(int row_mt_mode, unsigned int threads) {
+    MovingWaveSource video;
+    video.SetSize(640, 480);
+    video.set_limit(10);
+    row_mt_mode_ = row_mt_mode;
+    cfg_.g_threads = threads;
+    EXPECT_NO_FATAL_FAILURE(RunLoop(&video));
+    return md5_;
+  }
+
+  bool encoder_initialized_;
+  int threads_;
+  int row_mt_mode_;
+  int max_filter_level_;
+  std::vector<std::string> md5_;
+};
+
+TEST_P(VPxLpfSearchThreadTest, LpfSearchResultTest) {
+  const std::vector<std::string> single_thr_md5 = Encode(0, 1);
+  ASSERT_EQ(10u, single_thr_md5.size());
+  EXPECT_GT(max_filter_level_, 0);
+  // Without row based multi-threading the two tile columns cap the workers.
+  EXPECT_EQ(single_thr_md5, Encode(0, threads_));
+  EXPECT_EQ(Encode(1, 2), Encode(1, threads_));
+}
+
+VP9_INSTANTIATE_TEST_SUITE(VPxLpfSearchThreadTest,
+                           ::testing::Values(3, 6));  // threads
+
+// Checks that packing the bitstream with row based multi-threading, where the
+// workers record the symbols of the superblock rows and the main thread codes
+// them, gives a bitstream that decodes to the encoder's reconstruction and
+// does not depend on the number of threads.
+class VPxRowMtPackingTest
+    : public ::libvpx_test::EncoderTest,
+      public ::libvpx_test::CodecTestWith2Params<int, int> {
+ protected:
+  VPxRowMtPackingTest()
+      : EncoderTest(GET_PARAM(0)), encoder_initialized_(false),
+        tile_columns_(GET_PARAM(1)), tile_rows_(GET_PARAM(2)) {}
+  ~VPxRowMtPackingTest() override = default;
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kOnePassGood);
+    cfg_.rc_end_usage = VPX_VBR;
+    cfg_.rc_target_bitrate = 1000;
+    cfg_.g_lag_in_frames = 0;
+  }
+
+  void BeginPassHook(unsigned int /*pass*/) override {
+    encoder_initialized_ = false;
+    md5_.clear();
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource * /*video*/,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (!encoder_initialized_) {
+      encoder->Control(VP8E_SET_CPUUSED, 4);
+      encoder->Control(VP9E_SET_TILE_COLUMNS, tile_columns_);
+      encoder->Control(VP9E_SET_TILE_ROWS, tile_rows_);
+      encoder->Control(VP9E_SET_ROW_MT, 1);
+      encoder_initialized_ = true;
+    }
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    ::libvpx_test::MD5 md5_res;
+    md5_res.Add(static_cast<const uint8_t *>(pkt->data.frame.buf),
+                pkt->data.frame.sz);
+    md5_.push_back(md5_res.Get());
+  }
+
+  std::vector<std::string> Encode(unsigned int threads) {
+    MovingRampSource video;
+    video.SetSize(416, 240);
+    video.set_limit(8);
+    cfg_.g_threads = threads;
+    EXPECT_NO_FATAL_FAILURE(RunLoop(&video));
+    return md5_;
+  }
+
+  bool encoder_initialized_;
+  int tile_columns_;
+  int tile_rows_;
+  std::vector<std::string> md5_;
+};
+
+TEST_P(VPxRowMtPackingTest, PackingResultTest) {
+  const std::vector<std::string> two_thr_md5 = Encode(2);
+  ASSERT_EQ(8u, two_thr_md5.size());
+  EXPECT_EQ(two_thr_md5, Encode(3));
+  EXPECT_EQ(two_thr_md5, Encode(5));
+}
+
+// Tile rows are only used with threads when there is one tile column.
+VP9_INSTANTIATE_TEST_SUITE(VPxRowMtPackingTest,
+                           ::testing::Values(0, 1),  // tile_columns
+                           ::testing::Values(0, 2));  // tile_rows
+
+const int kNumFrames = 30;
+
+// Checks that the frame parallel first pass, which analyses a frame per
+// thread, outputs the stats of every frame in order, close to those of the
+// default first pass, and that the second pass gives about the same size
+// with them.
+class VPxFrameParallelFirstPassTest
+    : public ::libvpx_test::EncoderTest,
+      public ::libvpx_test::CodecTestWithParam<int> {
+ protected:
+  VPxFrameParallelFirstPassTest()
+      : EncoderTest(GET_PARAM(0)), encoder_initialized_(false),
+        threads_(GET_PARAM(1)), frame_parallel_(0), bytes_(0) {}
+  ~VPxFrameParallelFirstPassTest() override = default;
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kTwoPassGood);
+    cfg_.rc_end_usage = VPX_VBR;
+    cfg_.rc_target_bitrate = 300;
+    cfg_.g_lag_in_frames = 25;
+    cfg_.g_threads = threads_;
+  }
+
+  void BeginPassHook(unsigned int pass) override {
+    encoder_initialized_ = false;
+    if (pass == 0) stats_.clear();
+    bytes_ = 0;
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource * /*video*/,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (!encoder_initialized_) {
+      encoder->Control(VP8E_SET_CPUUSED, 3);
+      encoder->Control(VP8E_SET_ENABLEAUTOALTREF, 1);
+      encoder->Control(VP9E_SET_FRAME_PARALLEL_FIRST_PASS, frame_parallel_);
+      encoder_initialized_ = true;
+    }
+  }
+
+  void StatsPktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    ASSERT_EQ(sizeof(FIRSTPASS_STATS), pkt->data.twopass_stats.sz);
+    FIRSTPASS_STATS stats;
+    memcpy(&stats, pkt->data.twopass_stats.buf, sizeof(stats));
+    stats_.push_back(stats);
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    bytes_ += pkt->data.frame.sz;
+  }
+
+  size_t Encode(int frame_parallel) {
+    MovingWaveSource video;
+    video.SetSize(176, 144);
+    video.set_limit(kNumFrames);
+    frame_parallel_ = frame_parallel;
+    EXPECT_NO_FATAL_FAILURE(RunLoop(&video));
+    return bytes_;
+  }
+
+  bool encoder_initialized_;
+  int threads_;
+  int frame_parallel_;
+  size_t bytes_;
+  std::vector<FIRSTPASS_STATS> stats_;
+};
+
+TEST_P(VPxFrameParallelFirstPassTest, FirstPassStatsTest) {
+  const size_t serial_bytes = Encode(0);
+  const std::vector<FIRSTPASS_STATS> serial_stats = stats_;
+  ASSERT_EQ(static_cast<size_t>(kNumFrames + 1), serial_stats.size());
+
+  const size_t parallel_bytes = Encode(1);
+  ASSERT_EQ(serial_stats.size(), stats_.size());
+  for (int i = 0; i < kNumFrames; ++i) {
+    EXPECT_EQ(i, stats_[i].frame);
+    EXPECT_EQ(serial_stats[i].duration, stats_[i].duration);
+    EXPECT_NEAR(serial_stats[i].intra_error, stats_[i].intra_error,
+                serial_stats[i].intra_error * 0.05)
+        << "frame " << i;
+    EXPECT_NEAR(serial_stats[i].coded_error, stats_[i].coded_error,
+                serial_stats[i].coded_error * 0.25)
+        << "frame " << i;
+  }
+  EXPECT_EQ(kNumFrames, stats_[kNumFrames].count);
+
+  EXPECT_GE(parallel_bytes, serial_bytes * 9 / 10);
+  EXPECT_LE(parallel_bytes, serial_bytes * 11 / 10);
+}
+
+VP9_INSTANTIATE_TEST_SUITE(VPxFrameParallelFirstPassTest,
+                           ::testing::Values(2, 4, 16));  // threads
+#endif  // !CONFIG_REALTIME_ONLY
+
 INSTANTIATE_TEST_SUITE_P(
     VP9, VPxFirstPassEncoderThreadTest,
     ::testing::Combine(
@@ -448,4 +878,74 @@ INSTANTIATE_TEST_SUITE_P(
         ::testing::Range(2, 5)));  // threads
 #endif
 
+// Checks that with thread_invariant, the bitstream encoded with row based
+// multi-threading does not depend on the number of threads.
+class VPxThreadInvariantTest
+    : public ::libvpx_test::EncoderTest,
+      public ::libvpx_test::CodecTestWith2Params<libvpx_test::TestMode, int> {
+ protected:
+  VPxThreadInvariantTest()
+      : EncoderTest(GET_PARAM(0)), encoder_initialized_(false),
+        encoding_mode_(GET_PARAM(1)), set_cpu_used_(GET_PARAM(2)) {}
+  ~VPxThreadInvariantTest() override = default;
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(encoding_mode_);
+    cfg_.rc_end_usage =
+        encoding_mode_ == ::libvpx_test::kRealTime ? VPX_CBR : VPX_VBR;
+    cfg_.rc_target_bitrate = 500;
+    cfg_.g_lag_in_frames = 0;
+  }
+
+  void BeginPassHook(unsigned int /*pass*/) override {
+    encoder_initialized_ = false;
+    md5_.clear();
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource * /*video*/,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (!encoder_initialized_) {
+      encoder->Control(VP8E_SET_CPUUSED, set_cpu_used_);
+      encoder->Control(VP9E_SET_TILE_COLUMNS, 1);
+      encoder->Control(VP9E_SET_TILE_ROWS, 1);
+      encoder->Control(VP9E_SET_ROW_MT, 1);
+      encoder->Control(VP9E_SET_THREAD_INVARIANT, 1);
+      encoder_initialized_ = true;
+    }
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    ::libvpx_test::MD5 md5_res;
+    md5_res.Add(static_cast<const uint8_t *>(pkt->data.frame.buf),
+                pkt->data.frame.sz);
+    md5_.push_back(md5_res.Get());
+  }
+
+  std::vector<std::string> Encode(unsigned int threads) {
+    MovingRampSource video;
+    video.SetSize(352, 288);
+    video.set_limit(8);
+    cfg_.g_threads = threads;
+    EXPECT_NO_FATAL_FAILURE(RunLoop(&video));
+    return md5_;
+  }
+
+  bool encoder_initialized_;
+  ::libvpx_test::TestMode encoding_mode_;
+  int set_cpu_used_;
+  std::vector<std::string> md5_;
+};
+
+TEST_P(VPxThreadInvariantTest, EncoderResultTest) {
+  const std::vector<std::string> single_thr_md5 = Encode(1);
+  ASSERT_EQ(8u, single_thr_md5.size());
+  EXPECT_EQ(single_thr_md5, Encode(2));
+  EXPECT_EQ(single_thr_md5, Encode(4));
+}
+
+VP9_INSTANTIATE_TEST_SUITE(VPxThreadInvariantTest,
+                           ::testing::ValuesIn(kOnePassTestModes),
+                           ::testing::Values(4, 7));  // cpu_used
+
 }  // namespace
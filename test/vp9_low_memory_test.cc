@@ -0,0 +1,165 @@
+/*
+ *  Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "./vpx_config.h"
+#include "test/codec_factory.h"
+#include "test/decode_test_driver.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8dx.h"
+
+namespace {
+
+enum DecodeMode { kSerial, kSerialRowMt, kTileMt, kRowMt, kFrameParallel };
+
+const int kNumDecoders = 3;
+
+// Diagonal ramps moving right and down, so that blocks along the left and top
+// edges predict from outside of the reference frame.
+class MovingRampSource : public ::libvpx_test::DummyVideoSource {
+ protected:
+  void FillFrame() override {
+    if (img_ == nullptr) return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const unsigned int w = plane ? (img_->d_w + 1) / 2 : img_->d_w;
+      const unsigned int h = plane ? (img_->d_h + 1) / 2 : img_->d_h;
+      const unsigned int shift = (3 * frame_) >> (plane ? 1 : 0);
+      for (unsigned int y = 0; y < h; ++y) {
+        uint8_t *const row = img_->planes[plane] + y * img_->stride[plane];
+        for (unsigned int x = 0; x < w; ++x) {
+          const unsigned int u = x - shift, v = y - shift;
+          row[x] = static_cast<uint8_t>(((u * 7) ^ (v * 5)) + (u & v));
+        }
+      }
+    }
+  }
+};
+
+// Encodes a clip whose size is not a multiple of 8, then decodes it in low
+// memory mode with several decoders taking turns on one thread, and checks
+// that the output matches a regular decoder while using less memory.
+class VP9LowMemoryTest
+    : public ::libvpx_test::EncoderTest,
+      public ::libvpx_test::CodecTestWithParam<DecodeMode> {
+ protected:
+  VP9LowMemoryTest() : EncoderTest(GET_PARAM(0)), mode_(GET_PARAM(1)) {}
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = VPX_VBR;
+    cfg_.rc_target_bitrate = 300;
+  }
+
+  void BeginPassHook(unsigned int /*pass*/) override {
+    encoder_initialized_ = false;
+    frames_.clear();
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource * /*video*/,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (!encoder_initialized_) {
+      encoder->Control(VP8E_SET_CPUUSED, 4);
+      encoder_initialized_ = true;
+    }
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    const uint8_t *const buf =
+        static_cast<const uint8_t *>(pkt->data.frame.buf);
+    frames_.emplace_back(buf, buf + pkt->data.frame.sz);
+  }
+
+  std::unique_ptr<libvpx_test::VP9Decoder> CreateDecoder(int low_memory) {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    cfg.threads = (mode_ == kSerial || mode_ == kSerialRowMt) ? 1 : 4;
+    std::unique_ptr<libvpx_test::VP9Decoder> decoder(
+        new libvpx_test::VP9Decoder(cfg, 0));
+    decoder->Control(VP9D_SET_LOW_MEMORY, low_memory);
+    decoder->Control(VP9D_SET_ROW_MT,
+                     mode_ == kSerialRowMt || mode_ == kRowMt);
+    decoder->Control(VP9D_SET_FRAME_PARALLEL, mode_ == kFrameParallel);
+    return decoder;
+  }
+
+  // Decodes frames_ with each of 'decoders' in turn, frame by frame. Returns
+  // the md5 of the output of each decoder.
+  std::vector<std::string> Decode(
+      const std::vector<std::unique_ptr<libvpx_test::VP9Decoder> > &decoders) {
+    std::vector<libvpx_test::MD5> md5s(decoders.size());
+    for (const std::vector<uint8_t> &frame : frames_) {
+      for (size_t i = 0; i < decoders.size(); ++i) {
+        const vpx_codec_err_t res =
+            decoders[i]->DecodeFrame(frame.data(), frame.size());
+        EXPECT_EQ(VPX_CODEC_OK, res) << decoders[i]->DecodeError();
+        libvpx_test::DxDataIterator dec_iter = decoders[i]->GetDxData();
+        while (const vpx_image_t *img = dec_iter.Next()) md5s[i].Add(img);
+      }
+    }
+    std::vector<std::string> digests;
+    for (size_t i = 0; i < decoders.size(); ++i) {
+      EXPECT_EQ(VPX_CODEC_OK, decoders[i]->DecodeFrame(nullptr, 0));
+      libvpx_test::DxDataIterator dec_iter = decoders[i]->GetDxData();
+      while (const vpx_image_t *img = dec_iter.Next()) md5s[i].Add(img);
+      digests.push_back(md5s[i].Get());
+    }
+    return digests;
+  }
+
+  static size_t GetPeakMemory(libvpx_test::VP9Decoder *decoder) {
+    size_t peak_memory = 0;
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(decoder->GetDecoder(), VP9D_GET_PEAK_MEMORY,
+                                &peak_memory));
+    return peak_memory;
+  }
+
+  DecodeMode mode_;
+  bool encoder_initialized_;
+  std::vector<std::vector<uint8_t> > frames_;
+};
+
+TEST_P(VP9LowMemoryTest, MatchesRegularDecode) {
+  MovingRampSource video;
+  video.SetSize(318, 238);
+  video.set_limit(8);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  ASSERT_FALSE(frames_.empty());
+
+  std::vector<std::unique_ptr<libvpx_test::VP9Decoder> > regular;
+  regular.push_back(CreateDecoder(0));
+  const std::vector<std::string> expected = Decode(regular);
+  const size_t regular_peak = GetPeakMemory(regular[0].get());
+  EXPECT_GT(regular_peak, 0u);
+
+  std::vector<std::unique_ptr<libvpx_test::VP9Decoder> > low_memory;
+  for (int i = 0; i < kNumDecoders; ++i) low_memory.push_back(CreateDecoder(1));
+  const std::vector<std::string> digests = Decode(low_memory);
+  for (int i = 0; i < kNumDecoders; ++i) {
+    EXPECT_EQ(expected[0], digests[i]) << "decoder " << i;
+    const size_t peak = GetPeakMemory(low_memory[i].get());
+    EXPECT_GT(peak, 0u);
+    EXPECT_LT(peak, regular_peak) << "decoder " << i;
+  }
+}
+
+VP9_INSTANTIATE_TEST_SUITE(VP9LowMemoryTest,
+                           ::testing::Values(kSerial, kSerialRowMt, kTileMt,
+                                             kRowMt, kFrameParallel));
+
+}  // namespace
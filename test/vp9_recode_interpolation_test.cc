@@ -0,0 +1,123 @@
+/*
+ *  Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "./vpx_config.h"
+#include "test/acm_random.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8cx.h"
+
+namespace {
+
+const int kNumFrames = 24;
+
+// Moving sinusoids whose frequency and amount of noise change every 6 frames,
+// which makes the encoder recode frames to meet its rate targets.
+class SceneChangeSource : public ::libvpx_test::DummyVideoSource {
+ protected:
+  void FillFrame() override {
+    if (img_ == nullptr) return;
+    const int scene = frame_ / 6;
+    const int noise = (scene % 3) * 12;
+    ::libvpx_test::ACMRandom rnd(frame_ + 1);
+    for (int plane = 0; plane < 3; ++plane) {
+      const int w = plane ? (img_->d_w + 1) / 2 : img_->d_w;
+      const int h = plane ? (img_->d_h + 1) / 2 : img_->d_h;
+      for (int y = 0; y < h; ++y) {
+        uint8_t *const row = img_->planes[plane] + y * img_->stride[plane];
+        for (int x = 0; x < w; ++x) {
+          const double v =
+              128 +
+              60 * sin((x + (1.5 + scene) * frame_) * (0.05 + 0.02 * scene) +
+                       plane) *
+                  cos((y - 0.7 * frame_) * 0.05);
+          const int n = noise ? rnd.Rand8() % (noise + 1) - noise / 2 : 0;
+          row[x] = static_cast<uint8_t>(
+              std::min(std::max(static_cast<int>(v) + n, 0), 255));
+        }
+      }
+    }
+  }
+};
+
+class RecodeInterpolationTest
+    : public ::libvpx_test::EncoderTest,
+      public ::libvpx_test::CodecTestWithParam<int> {
+ protected:
+  RecodeInterpolationTest()
+      : EncoderTest(GET_PARAM(0)), cpu_used_(GET_PARAM(1)),
+        recode_interpolation_(0), frames_(0), bytes_(0) {}
+  ~RecodeInterpolationTest() override = default;
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kTwoPassGood);
+    cfg_.rc_end_usage = VPX_VBR;
+    cfg_.rc_target_bitrate = 100;
+    cfg_.rc_undershoot_pct = 5;
+    cfg_.rc_overshoot_pct = 5;
+    cfg_.rc_2pass_vbr_maxsection_pct = 150;
+  }
+
+  void BeginPassHook(unsigned int /*pass*/) override {
+    frames_ = 0;
+    bytes_ = 0;
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, cpu_used_);
+      encoder->Control(VP8E_SET_ENABLEAUTOALTREF, 1);
+      encoder->Control(VP9E_SET_RECODE_INTERPOLATION, recode_interpolation_);
+    }
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    if (pkt->data.frame.flags & VPX_FRAME_IS_INVISIBLE) return;
+    ++frames_;
+    bytes_ += pkt->data.frame.sz;
+  }
+
+  // Returns the size of the clip encoded with the given recode_interpolation,
+  // checking that it decodes to the encoder's reconstruction.
+  size_t Encode(int recode_interpolation) {
+    SceneChangeSource video;
+    video.SetSize(176, 144);
+    video.set_limit(kNumFrames);
+    recode_interpolation_ = recode_interpolation;
+    EXPECT_NO_FATAL_FAILURE(RunLoop(&video));
+    EXPECT_EQ(kNumFrames, frames_);
+    return bytes_;
+  }
+
+  int cpu_used_;
+  int recode_interpolation_;
+  int frames_;
+  size_t bytes_;
+};
+
+TEST_P(RecodeInterpolationTest, MeetsRateTargets) {
+  const size_t bisection_bytes = Encode(0);
+  const size_t interpolation_bytes = Encode(1);
+  // Both searches aim for the same frame sizes.
+  EXPECT_GE(interpolation_bytes, bisection_bytes * 9 / 10);
+  EXPECT_LE(interpolation_bytes, bisection_bytes * 11 / 10);
+}
+
+VP9_INSTANTIATE_TEST_SUITE(RecodeInterpolationTest,
+                           ::testing::Values(1, 2));  // cpu_used
+}  // namespace
@@ -0,0 +1,189 @@
+/*
+ *  Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "./vpx_config.h"
+#include "test/codec_factory.h"
+#include "test/decode_test_driver.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8dx.h"
+
+namespace {
+
+enum DecodeMode { kSerial, kTileMt, kLpfOpt, kRowMt, kFrameParallel };
+
+// Moving diagonal ramps. Coded at a low rate they show blocking artifacts, so
+// most block edges get loop filtered.
+class RampVideoSource : public ::libvpx_test::DummyVideoSource {
+ protected:
+  void FillFrame() override {
+    if (img_ == nullptr) return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const unsigned int w = plane ? (img_->d_w + 1) / 2 : img_->d_w;
+      const unsigned int h = plane ? (img_->d_h + 1) / 2 : img_->d_h;
+      for (unsigned int y = 0; y < h; ++y) {
+        uint8_t *const row = img_->planes[plane] + y * img_->stride[plane];
+        for (unsigned int x = 0; x < w; ++x) {
+          row[x] = static_cast<uint8_t>((x + 2 * y + 4 * frame_) >> plane);
+        }
+      }
+    }
+  }
+};
+
+// Luma rows of a frame as they were when reported by the rows ready callback.
+struct ReportedFrame {
+  unsigned int rows;
+  std::vector<uint8_t> luma;
+};
+
+// Encodes a clip with two tile columns, then decodes it with the rows ready
+// callback set and checks that each shown frame is reported in order, in
+// full, and that the reported rows do not change afterwards.
+class VP9RowsReadyTest
+    : public ::libvpx_test::EncoderTest,
+      public ::libvpx_test::CodecTestWith2Params<DecodeMode, int> {
+ protected:
+  VP9RowsReadyTest()
+      : EncoderTest(GET_PARAM(0)), mode_(GET_PARAM(1)),
+        skip_loop_filter_(GET_PARAM(2)) {}
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = VPX_VBR;
+    cfg_.rc_target_bitrate = 200;
+  }
+
+  void BeginPassHook(unsigned int /*pass*/) override {
+    encoder_initialized_ = false;
+    frames_.clear();
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource * /*video*/,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (!encoder_initialized_) {
+      encoder->Control(VP8E_SET_CPUUSED, 4);
+      encoder->Control(VP9E_SET_TILE_COLUMNS, 1);
+      encoder_initialized_ = true;
+    }
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    const uint8_t *const buf =
+        static_cast<const uint8_t *>(pkt->data.frame.buf);
+    frames_.emplace_back(buf, buf + pkt->data.frame.sz);
+  }
+
+  static void RowsReady(void *cb_priv, const vpx_image_t *img,
+                        unsigned int row_start, unsigned int row_end) {
+    static_cast<VP9RowsReadyTest *>(cb_priv)->OnRowsReady(img, row_start,
+                                                          row_end);
+  }
+
+  void OnRowsReady(const vpx_image_t *img, unsigned int row_start,
+                   unsigned int row_end) {
+    const int bytes_per_sample = (img->fmt & VPX_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+    const size_t row_bytes = img->d_w * bytes_per_sample;
+    std::lock_guard<std::mutex> lock(mutex_);
+    ReportedFrame &frame = reported_[img->planes[VPX_PLANE_Y]];
+    if (row_start == 0) {
+      frame.rows = 0;
+      frame.luma.clear();
+    }
+    EXPECT_EQ(frame.rows, row_start);
+    EXPECT_LT(row_start, row_end);
+    EXPECT_LE(row_end, img->d_h);
+    for (unsigned int r = row_start; r < row_end; ++r) {
+      const uint8_t *const row =
+          img->planes[VPX_PLANE_Y] + r * img->stride[VPX_PLANE_Y];
+      frame.luma.insert(frame.luma.end(), row, row + row_bytes);
+    }
+    frame.rows = row_end;
+  }
+
+  void CheckFrame(const vpx_image_t *img) {
+    const int bytes_per_sample = (img->fmt & VPX_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+    const size_t row_bytes = img->d_w * bytes_per_sample;
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = reported_.find(img->planes[VPX_PLANE_Y]);
+    ASSERT_NE(it, reported_.end());
+    ASSERT_EQ(it->second.rows, img->d_h);
+    for (unsigned int r = 0; r < img->d_h; ++r) {
+      const uint8_t *const row =
+          img->planes[VPX_PLANE_Y] + r * img->stride[VPX_PLANE_Y];
+      ASSERT_EQ(0, memcmp(row, &it->second.luma[r * row_bytes], row_bytes))
+          << "row " << r;
+    }
+    reported_.erase(it);
+    ++checked_frames_;
+  }
+
+  void Decode() {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    cfg.threads = mode_ == kSerial ? 1 : 4;
+    libvpx_test::VP9Decoder decoder(cfg, 0);
+    const vpx_rows_ready_cb_t rows_ready = { RowsReady, this };
+    decoder.Control(VP9D_SET_ROWS_READY_CB, &rows_ready);
+    decoder.Control(VP9D_SET_LOOP_FILTER_OPT, mode_ == kLpfOpt);
+    decoder.Control(VP9D_SET_ROW_MT, mode_ == kRowMt);
+    decoder.Control(VP9D_SET_FRAME_PARALLEL, mode_ == kFrameParallel);
+    decoder.Control(VP9_SET_SKIP_LOOP_FILTER, skip_loop_filter_);
+
+    checked_frames_ = 0;
+    for (const std::vector<uint8_t> &frame : frames_) {
+      const vpx_codec_err_t res =
+          decoder.DecodeFrame(frame.data(), frame.size());
+      ASSERT_EQ(VPX_CODEC_OK, res) << decoder.DecodeError();
+      libvpx_test::DxDataIterator dec_iter = decoder.GetDxData();
+      while (const vpx_image_t *img = dec_iter.Next()) {
+        ASSERT_NO_FATAL_FAILURE(CheckFrame(img));
+      }
+    }
+    ASSERT_EQ(VPX_CODEC_OK, decoder.DecodeFrame(nullptr, 0));
+    libvpx_test::DxDataIterator dec_iter = decoder.GetDxData();
+    while (const vpx_image_t *img = dec_iter.Next()) {
+      ASSERT_NO_FATAL_FAILURE(CheckFrame(img));
+    }
+    EXPECT_EQ(frames_.size(), checked_frames_);
+  }
+
+  DecodeMode mode_;
+  int skip_loop_filter_;
+  bool encoder_initialized_;
+  std::vector<std::vector<uint8_t> > frames_;
+  std::mutex mutex_;
+  std::map<const uint8_t *, ReportedFrame> reported_;
+  size_t checked_frames_;
+};
+
+TEST_P(VP9RowsReadyTest, ReportsFinalRows) {
+  RampVideoSource video;
+  video.SetSize(640, 480);
+  video.set_limit(5);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  ASSERT_FALSE(frames_.empty());
+  Decode();
+}
+
+VP9_INSTANTIATE_TEST_SUITE(VP9RowsReadyTest,
+                           ::testing::Values(kSerial, kTileMt, kLpfOpt,
+                                             kRowMt, kFrameParallel),
+                           ::testing::Values(0, 1));
+
+}  // namespace
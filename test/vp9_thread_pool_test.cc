@@ -0,0 +1,197 @@
+/*
+ *  Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "./vpx_config.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#if CONFIG_VP9_DECODER
+#include "test/decode_test_driver.h"
+#endif
+#include "vpx/vpx_thread_pool.h"
+
+namespace {
+
+#if CONFIG_MULTITHREAD
+// Encodes the same clip with and without a shared thread pool and checks that
+// the streams match. The pool has fewer threads than the encoder uses, so
+// workers have to queue for pool threads. The streams are then decoded with
+// and without a pool.
+class VP9ThreadPoolTest
+    : public ::libvpx_test::EncoderTest,
+      public ::libvpx_test::CodecTestWith2Params<int, int> {
+ protected:
+  VP9ThreadPoolTest()
+      : EncoderTest(GET_PARAM(0)), row_mt_(GET_PARAM(1)),
+        pool_threads_(GET_PARAM(2)), pool_(nullptr) {}
+
+  ~VP9ThreadPoolTest() override { vpx_thread_pool_destroy(pool_); }
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kOnePassGood);
+    cfg_.g_threads = 4;
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = VPX_VBR;
+    cfg_.rc_target_bitrate = 1000;
+  }
+
+  void BeginPassHook(unsigned int /*pass*/) override {
+    encoder_initialized_ = false;
+    frames_.clear();
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource * /*video*/,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (!encoder_initialized_) {
+      encoder->Control(VP8E_SET_CPUUSED, 4);
+      encoder->Control(VP9E_SET_TILE_COLUMNS, 2);
+      encoder->Control(VP9E_SET_ROW_MT, row_mt_);
+      if (pool_ != nullptr) encoder->Control(VP9E_SET_THREAD_POOL, pool_);
+      encoder_initialized_ = true;
+    }
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    const uint8_t *const buf =
+        static_cast<const uint8_t *>(pkt->data.frame.buf);
+    frames_.emplace_back(buf, buf + pkt->data.frame.sz);
+  }
+
+  std::vector<std::vector<uint8_t> > Encode(
+      int seed = ::libvpx_test::ACMRandom::DeterministicSeed()) {
+    ::libvpx_test::RandomVideoSource video(seed);
+    video.SetSize(640, 480);
+    video.set_limit(5);
+    init_flags_ = VPX_CODEC_USE_PSNR;
+    EXPECT_NO_FATAL_FAILURE(RunLoop(&video));
+    return frames_;
+  }
+
+#if CONFIG_VP9_DECODER
+  std::string Decode(const std::vector<std::vector<uint8_t> > &frames,
+                     vpx_thread_pool_t *pool) {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    cfg.threads = 4;
+    libvpx_test::VP9Decoder decoder(cfg, 0);
+    decoder.Control(VP9D_SET_ROW_MT, row_mt_);
+    if (pool != nullptr) decoder.Control(VP9D_SET_THREAD_POOL, pool);
+
+    libvpx_test::MD5 md5;
+    for (const std::vector<uint8_t> &frame : frames) {
+      const vpx_codec_err_t res =
+          decoder.DecodeFrame(frame.data(), frame.size());
+      EXPECT_EQ(VPX_CODEC_OK, res) << decoder.DecodeError();
+      if (res != VPX_CODEC_OK) break;
+      libvpx_test::DxDataIterator dec_iter = decoder.GetDxData();
+      while (const vpx_image_t *img = dec_iter.Next()) md5.Add(img);
+    }
+    return md5.Get();
+  }
+
+  // Decodes the streams in lockstep with vpx_codec_decode_batch(). Every
+  // other instance uses several threads of its own on 'pool'.
+  std::vector<std::string> DecodeBatch(
+      const std::vector<std::vector<std::vector<uint8_t> > > &streams,
+      vpx_thread_pool_t *pool) {
+    const size_t num_streams = streams.size();
+    std::vector<vpx_codec_ctx_t> ctxs(num_streams);
+    std::vector<libvpx_test::MD5> md5s(num_streams);
+    std::vector<vpx_codec_decode_job_t> jobs(num_streams);
+    for (size_t i = 0; i < num_streams; ++i) {
+      vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+      cfg.threads = (i & 1) ? 4 : 1;
+      EXPECT_EQ(VPX_CODEC_OK,
+                vpx_codec_dec_init(&ctxs[i], vpx_codec_vp9_dx(), &cfg, 0));
+      vpx_codec_control(&ctxs[i], VP9D_SET_ROW_MT, row_mt_);
+      if ((i & 1) && pool != nullptr) {
+        vpx_codec_control(&ctxs[i], VP9D_SET_THREAD_POOL, pool);
+      }
+    }
+
+    for (size_t f = 0; f < streams[0].size(); ++f) {
+      for (size_t i = 0; i < num_streams; ++i) {
+        jobs[i].ctx = &ctxs[i];
+        jobs[i].data = streams[i][f].data();
+        jobs[i].data_sz = static_cast<unsigned int>(streams[i][f].size());
+        jobs[i].user_priv = nullptr;
+      }
+      EXPECT_EQ(VPX_CODEC_OK,
+                vpx_codec_decode_batch(jobs.data(),
+                                       static_cast<unsigned int>(num_streams),
+                                       pool));
+      for (size_t i = 0; i < num_streams; ++i) {
+        EXPECT_EQ(VPX_CODEC_OK, jobs[i].res) << "stream " << i;
+        vpx_codec_iter_t iter = nullptr;
+        while (const vpx_image_t *img = vpx_codec_get_frame(&ctxs[i], &iter)) {
+          md5s[i].Add(img);
+        }
+      }
+    }
+
+    std::vector<std::string> digests;
+    for (size_t i = 0; i < num_streams; ++i) {
+      vpx_codec_destroy(&ctxs[i]);
+      digests.push_back(md5s[i].Get());
+    }
+    return digests;
+  }
+#endif  // CONFIG_VP9_DECODER
+
+  int row_mt_;
+  int pool_threads_;
+  vpx_thread_pool_t *pool_;
+  bool encoder_initialized_;
+  std::vector<std::vector<uint8_t> > frames_;
+};
+
+TEST_P(VP9ThreadPoolTest, MatchesPrivateThreads) {
+  const std::vector<std::vector<uint8_t> > expected = Encode();
+  ASSERT_FALSE(expected.empty());
+
+  pool_ = vpx_thread_pool_create(pool_threads_);
+  ASSERT_NE(pool_, nullptr);
+  const std::vector<std::vector<uint8_t> > pooled = Encode();
+  EXPECT_EQ(expected, pooled);
+
+#if CONFIG_VP9_DECODER
+  EXPECT_EQ(Decode(expected, nullptr), Decode(expected, pool_));
+#endif
+}
+
+#if CONFIG_VP9_DECODER
+TEST_P(VP9ThreadPoolTest, DecodeBatchMatchesDecode) {
+  const int kNumStreams = 3;
+  std::vector<std::vector<std::vector<uint8_t> > > streams;
+  std::vector<std::string> expected;
+  for (int i = 0; i < kNumStreams; ++i) {
+    streams.push_back(Encode(i + 1));
+    ASSERT_EQ(streams[0].size(), streams[i].size());
+    expected.push_back(Decode(streams[i], nullptr));
+  }
+
+  pool_ = vpx_thread_pool_create(pool_threads_);
+  ASSERT_NE(pool_, nullptr);
+  EXPECT_EQ(expected, DecodeBatch(streams, pool_));
+  EXPECT_EQ(expected, DecodeBatch(streams, nullptr));
+}
+#endif  // CONFIG_VP9_DECODER
+
+VP9_INSTANTIATE_TEST_SUITE(VP9ThreadPoolTest, ::testing::Values(0, 1),
+                           ::testing::Values(1, 3));
+#endif  // CONFIG_MULTITHREAD
+
+}  // namespace
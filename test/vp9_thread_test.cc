@@ -8,7 +8,9 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <atomic>
 #include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "./vpx_config.h"
@@ -145,6 +147,127 @@ TEST(VPxWorkerThreadTest, TestInterfaceAPI) {
   }
 }
 
+#if CONFIG_MULTITHREAD
+struct PoolJob {
+  std::atomic<bool> *release;  // if not null, wait for it before returning
+  std::vector<int> *order;
+  std::atomic<int> *done;
+  int id;
+};
+
+int PoolHook(void *data, void * /*unused*/) {
+  PoolJob *const job = reinterpret_cast<PoolJob *>(data);
+  if (job->release != nullptr) {
+    while (!job->release->load()) {
+    }
+  }
+  job->order->push_back(job->id);
+  ++*job->done;
+  return job->id >= 0;
+}
+
+TEST(VPxThreadPoolTest, InvalidParams) {
+  EXPECT_EQ(vpx_thread_pool_create(0), nullptr);
+  EXPECT_EQ(vpx_thread_pool_client_create(nullptr), nullptr);
+  vpx_thread_pool_destroy(nullptr);
+}
+
+// Workers of two clients are queued behind a blocked job on a single pool
+// thread and must then be run alternating between the clients.
+TEST(VPxThreadPoolTest, RoundRobinClients) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  const int kJobsPerClient = 3;
+  vpx_thread_pool_t *const pool = vpx_thread_pool_create(1);
+  ASSERT_NE(pool, nullptr);
+  VPxThreadPoolClient *clients[3];
+  for (VPxThreadPoolClient *&client : clients) {
+    client = vpx_thread_pool_client_create(pool);
+    ASSERT_NE(client, nullptr);
+  }
+
+  std::atomic<bool> release(false);
+  std::atomic<int> done(0);
+  std::vector<int> order;
+  PoolJob jobs[1 + 2 * kJobsPerClient];
+  VPxWorker workers[1 + 2 * kJobsPerClient];
+  for (int i = 0; i < 1 + 2 * kJobsPerClient; ++i) {
+    // Job 0 blocks the pool thread. Jobs 1..3 belong to the first client and
+    // 4..6 to the second; job 5 fails.
+    const int client = i == 0 ? 0 : 1 + (i - 1) / kJobsPerClient;
+    jobs[i].release = i == 0 ? &release : nullptr;
+    jobs[i].order = &order;
+    jobs[i].done = &done;
+    jobs[i].id = i == 5 ? -i : i;
+    winterface->init(&workers[i]);
+    workers[i].pool_client = clients[client];
+    workers[i].hook = PoolHook;
+    workers[i].data1 = &jobs[i];
+    ASSERT_NE(winterface->reset(&workers[i]), 0);
+  }
+  for (VPxWorker &worker : workers) winterface->launch(&worker);
+  release = true;
+  // sync() would run jobs still queued on this thread, so let the pool thread
+  // drain the queue first.
+  while (done.load() != 1 + 2 * kJobsPerClient) {
+  }
+  for (int i = 0; i < 1 + 2 * kJobsPerClient; ++i) {
+    EXPECT_EQ(winterface->sync(&workers[i]), i != 5) << "job " << i;
+  }
+
+  const std::vector<int> expected = { 0, 1, 4, 2, -5, 3, 6 };
+  EXPECT_EQ(order, expected);
+
+  for (VPxWorker &worker : workers) winterface->end(&worker);
+  for (VPxThreadPoolClient *client : clients) {
+    vpx_thread_pool_client_destroy(client);
+  }
+  vpx_thread_pool_destroy(pool);
+}
+
+// A job queued behind a blocked job on a single pool thread is run by sync()
+// on the calling thread instead of waiting for the pool thread.
+TEST(VPxThreadPoolTest, SyncRunsQueuedJob) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  vpx_thread_pool_t *const pool = vpx_thread_pool_create(1);
+  ASSERT_NE(pool, nullptr);
+  VPxThreadPoolClient *const client = vpx_thread_pool_client_create(pool);
+  ASSERT_NE(client, nullptr);
+
+  std::atomic<bool> release(false);
+  std::atomic<int> done(0);
+  std::vector<int> order[2];
+  PoolJob jobs[2];
+  VPxWorker workers[2];
+  for (int i = 0; i < 2; ++i) {
+    jobs[i].release = i == 0 ? &release : nullptr;
+    jobs[i].order = &order[i];
+    jobs[i].done = &done;
+    jobs[i].id = i;
+    winterface->init(&workers[i]);
+    workers[i].pool_client = client;
+    workers[i].hook = PoolHook;
+    workers[i].data1 = &jobs[i];
+    ASSERT_NE(winterface->reset(&workers[i]), 0);
+    winterface->launch(&workers[i]);
+  }
+  EXPECT_NE(winterface->sync(&workers[1]), 0);
+  EXPECT_EQ(done.load(), 1);
+  release = true;
+  EXPECT_NE(winterface->sync(&workers[0]), 0);
+  EXPECT_EQ(done.load(), 2);
+
+  // The queue is empty again, so further jobs still run on the pool thread.
+  winterface->launch(&workers[1]);
+  while (done.load() != 3) {
+  }
+  EXPECT_NE(winterface->sync(&workers[1]), 0);
+
+  for (VPxWorker &worker : workers) winterface->end(&worker);
+  vpx_thread_pool_client_destroy(client);
+  vpx_thread_pool_destroy(pool);
+}
+#endif  // CONFIG_MULTITHREAD
+
 // -----------------------------------------------------------------------------
 // Multi-threaded decode tests
 #if CONFIG_WEBM_IO
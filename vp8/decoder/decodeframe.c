@@ -889,6 +889,7 @@ int vp8_decode_frame(VP8D_COMP *pbi) {
   const int *const mb_feature_data_bits = vp8_mb_feature_data_bits;
   int corrupt_tokens = 0;
   int prev_independent_partitions = pbi->independent_partitions;
+  int mt_decode = 0;
 
   YV12_BUFFER_CONFIG *yv12_fb_new = pbi->dec_fb_ref[INTRA_FRAME];
 
@@ -1190,25 +1191,34 @@ int vp8_decode_frame(VP8D_COMP *pbi) {
   /* clear out the coeff buffer */
   memset(xd->qcoeff, 0, sizeof(xd->qcoeff));
 
-  vp8_decode_mode_mvs(pbi);
+#if CONFIG_MULTITHREAD
+  mt_decode = vpx_atomic_load_acquire(&pbi->b_multithreaded_rd) &&
+              pc->multi_token_partition != ONE_PARTITION;
+#endif
+
+  /* The multithreaded decoder parses the modes and motion vectors itself,
+   * overlapped with reconstruction, unless error concealment needs all of
+   * them up front. */
+  if (!mt_decode || pbi->ec_active) {
+    vp8_decode_mode_mvs(pbi);
 
 #if CONFIG_ERROR_CONCEALMENT
-  if (pbi->ec_active &&
-      pbi->mvs_corrupt_from_mb < (unsigned int)pc->mb_cols * pc->mb_rows) {
-    /* Motion vectors are missing in this frame. We will try to estimate
-     * them and then continue decoding the frame as usual */
-    vp8_estimate_missing_mvs(pbi);
-  }
+    if (pbi->ec_active &&
+        pbi->mvs_corrupt_from_mb < (unsigned int)pc->mb_cols * pc->mb_rows) {
+      /* Motion vectors are missing in this frame. We will try to estimate
+       * them and then continue decoding the frame as usual */
+      vp8_estimate_missing_mvs(pbi);
+    }
 #endif
+  }
 
   memset(pc->above_context, 0, sizeof(ENTROPY_CONTEXT_PLANES) * pc->mb_cols);
   pbi->frame_corrupt_residual = 0;
 
 #if CONFIG_MULTITHREAD
-  if (vpx_atomic_load_acquire(&pbi->b_multithreaded_rd) &&
-      pc->multi_token_partition != ONE_PARTITION) {
+  if (mt_decode) {
     unsigned int thread;
-    if (vp8mt_decode_mb_rows(pbi, xd)) {
+    if (vp8mt_decode_mb_rows(pbi, xd, !pbi->ec_active)) {
       vp8_decoder_remove_threads(pbi);
       pbi->restart_threads = 1;
       vpx_internal_error(&pbi->common.error, VPX_CODEC_CORRUPT_FRAME, NULL);
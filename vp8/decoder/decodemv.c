@@ -558,5 +558,10 @@ void vp8_decode_mode_mvs(VP8D_COMP *pbi) {
     pbi->mb.mb_to_bottom_edge -= (16 << 3);
 
     mi++; /* skip left predictor each row */
+
+#if CONFIG_MULTITHREAD
+    /* let the decoding threads start on this row */
+    vpx_atomic_store_release(&pbi->mt_mb_rows_parsed, mb_row + 1);
+#endif
   }
 }
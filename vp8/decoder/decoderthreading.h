@@ -16,7 +16,10 @@ extern "C" {
 #endif
 
 #if CONFIG_MULTITHREAD
-int vp8mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd);
+/* Decodes the macroblock rows on all threads. If decode_mode_mvs is set the
+ * modes and motion vectors are parsed here as well, overlapped with the
+ * reconstruction of the rows parsed so far. */
+int vp8mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd, int decode_mode_mvs);
 void vp8_decoder_remove_threads(VP8D_COMP *pbi);
 void vp8_decoder_create_threads(VP8D_COMP *pbi);
 void vp8mt_alloc_temp_buffers(VP8D_COMP *pbi, int width, int prev_mb_rows);
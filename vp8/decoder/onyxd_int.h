@@ -83,6 +83,10 @@ typedef struct VP8D_COMP {
   int sync_range;
   /* Each row remembers its already decoded column. */
   vpx_atomic_int *mt_current_mb_col;
+  /* Next macroblock row to be claimed by a decoding thread. */
+  vpx_atomic_int mt_next_mb_row;
+  /* Number of macroblock rows with parsed modes and motion vectors. */
+  vpx_atomic_int mt_mb_rows_parsed;
 
   unsigned char **mt_yabove_row; /* mb_rows x width */
   unsigned char **mt_uabove_row;
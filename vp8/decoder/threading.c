@@ -22,6 +22,7 @@
 #include "vp8/common/extend.h"
 #include "vpx_ports/vpx_timer.h"
 #include "decoderthreading.h"
+#include "decodemv.h"
 #include "detokenize.h"
 #include "vp8/common/reconintra4x4.h"
 #include "vp8/common/reconinter.h"
@@ -258,8 +259,15 @@ static void mt_decode_macroblock(VP8D_COMP *pbi, MACROBLOCKD *xd,
   }
 }
 
-static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
-                              int start_mb_row) {
+/* Waits until the modes and motion vectors of mb_row have been parsed. */
+static void wait_for_mode_mvs(const VP8D_COMP *pbi, int mb_row) {
+  while (vpx_atomic_load_acquire(&pbi->mt_mb_rows_parsed) <= mb_row) {
+    x86_pause_hint();
+    thread_sleep(0);
+  }
+}
+
+static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd) {
   const vpx_atomic_int *last_row_current_mb_col;
   vpx_atomic_int *current_mb_col;
   int mb_row;
@@ -268,7 +276,6 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
   const vpx_atomic_int first_row_no_sync_above =
       VPX_ATOMIC_INIT(pc->mb_cols + nsync);
   int num_part = 1 << pbi->common.multi_token_partition;
-  int last_mb_row = start_mb_row;
 
   YV12_BUFFER_CONFIG *yv12_fb_new = pbi->dec_fb_ref[INTRA_FRAME];
   YV12_BUFFER_CONFIG *yv12_fb_lst = pbi->dec_fb_ref[LAST_FRAME];
@@ -297,23 +304,33 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
   dst_buffer[1] = yv12_fb_new->u_buffer;
   dst_buffer[2] = yv12_fb_new->v_buffer;
 
-  xd->up_available = (start_mb_row != 0);
-
-  xd->mode_info_context = pc->mi + pc->mode_info_stride * start_mb_row;
   xd->mode_info_stride = pc->mode_info_stride;
 
-  for (mb_row = start_mb_row; mb_row < pc->mb_rows;
-       mb_row += (pbi->decoding_thread_count + 1)) {
+  /* Rows are claimed in order by whichever thread is free, so a thread never
+   * waits on a row that has not been started. */
+  while ((mb_row = vpx_atomic_fetch_add(&pbi->mt_next_mb_row, 1)) <
+         pc->mb_rows) {
     int recon_yoffset, recon_uvoffset;
     int mb_col;
     int filter_level;
     loop_filter_info_n *lfi_n = &pc->lf_info;
 
-    /* save last row processed by this thread */
-    last_mb_row = mb_row;
+    wait_for_mode_mvs(pbi, mb_row);
+
     /* select bool coder for current partition */
     xd->current_bc = &pbi->mbc[mb_row % num_part];
 
+    /* The previous row using this partition may be on another thread. It is
+     * normally finished already, as no more rows than partitions are decoded
+     * at once, but its tokens must have been read before ours. */
+    if (mb_row >= num_part) {
+      vp8_atomic_spin_wait(pc->mb_cols,
+                           &pbi->mt_current_mb_col[mb_row - num_part], nsync);
+    }
+
+    xd->mode_info_context = pc->mi + pc->mode_info_stride * mb_row;
+    xd->up_available = (mb_row != 0);
+
     if (mb_row > 0) {
       last_row_current_mb_col = &pbi->mt_current_mb_col[mb_row - 1];
     } else {
@@ -416,13 +433,13 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
       xd->corrupted |= ref_fb_corrupted[xd->mode_info_context->mbmi.ref_frame];
 
       if (xd->corrupted) {
-        // Move current decoding marcoblock to the end of row for all rows
-        // assigned to this thread, such that other threads won't be waiting.
-        for (; mb_row < pc->mb_rows;
-             mb_row += (pbi->decoding_thread_count + 1)) {
+        // Move current decoding marcoblock to the end of row for this row and
+        // all rows not yet claimed, such that other threads won't be waiting.
+        do {
           current_mb_col = &pbi->mt_current_mb_col[mb_row];
           vpx_atomic_store_release(current_mb_col, pc->mb_cols + nsync);
-        }
+        } while ((mb_row = vpx_atomic_fetch_add(&pbi->mt_next_mb_row, 1)) <
+                 pc->mb_rows);
         vpx_internal_error(&xd->error_info, VPX_CODEC_CORRUPT_FRAME,
                            "Corrupted reference frame");
       }
@@ -577,17 +594,10 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
 
     /* last MB of row is ready just after extension is done */
     vpx_atomic_store_release(current_mb_col, mb_col + nsync);
-
-    ++xd->mode_info_context; /* skip prediction column */
-    xd->up_available = 1;
-
-    /* since we have multithread */
-    xd->mode_info_context += xd->mode_info_stride * pbi->decoding_thread_count;
   }
 
   /* signal end of decoding of current thread for current frame */
-  if (last_mb_row + (int)pbi->decoding_thread_count + 1 >= pc->mb_rows)
-    vp8_sem_post(&pbi->h_event_end_decoding);
+  vp8_sem_post(&pbi->h_event_end_decoding);
 }
 
 static THREADFN thread_decoding_proc(void *p_data) {
@@ -612,7 +622,7 @@ static THREADFN thread_decoding_proc(void *p_data) {
           continue;
         }
         xd->error_info.setjmp = 1;
-        mt_decode_mb_rows(pbi, xd, ithread + 1);
+        mt_decode_mb_rows(pbi, xd);
         xd->error_info.setjmp = 0;
       }
     }
@@ -851,7 +861,8 @@ void vp8_decoder_remove_threads(VP8D_COMP *pbi) {
   }
 }
 
-int vp8mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd) {
+int vp8mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
+                         int decode_mode_mvs) {
   VP8_COMMON *pc = &pbi->common;
   unsigned int i;
   int j;
@@ -893,10 +904,23 @@ int vp8mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd) {
   setup_decoding_thread_data(pbi, xd, pbi->mb_row_di,
                              pbi->decoding_thread_count);
 
+  vpx_atomic_store_release(&pbi->mt_next_mb_row, 0);
+  vpx_atomic_store_release(&pbi->mt_mb_rows_parsed,
+                           decode_mode_mvs ? 0 : pc->mb_rows);
+
   for (i = 0; i < pbi->decoding_thread_count; ++i) {
     vp8_sem_post(&pbi->h_event_start_decoding[i]);
   }
 
+  if (decode_mode_mvs) {
+    /* The modes and motion vectors are parsed from the first partition while
+     * the workers reconstruct the rows parsed so far. vp8_decode_mode_mvs()
+     * publishes each row as it is done. The main thread then joins the
+     * reconstruction. */
+    vp8_decode_mode_mvs(pbi);
+    vpx_atomic_store_release(&pbi->mt_mb_rows_parsed, pc->mb_rows);
+  }
+
   if (setjmp(xd->error_info.jmp)) {
     xd->error_info.setjmp = 0;
     xd->corrupted = 1;
@@ -909,7 +933,7 @@ int vp8mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd) {
   }
 
   xd->error_info.setjmp = 1;
-  mt_decode_mb_rows(pbi, xd, 0);
+  mt_decode_mb_rows(pbi, xd);
   xd->error_info.setjmp = 0;
 
   for (i = 0; i < pbi->decoding_thread_count + 1; ++i)
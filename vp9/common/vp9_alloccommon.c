@@ -98,6 +98,9 @@ void vp9_free_postproc_buffers(VP9_COMMON *cm) {
   vpx_free(cm->postproc_state.generated_noise);
   cm->postproc_state.generated_noise = NULL;
   cm->postproc_state.generated_noise_size = 0;
+  vpx_free(cm->postproc_state.worker_data);
+  cm->postproc_state.worker_data = NULL;
+  cm->postproc_state.num_worker_data = 0;
 #else
   (void)cm;
 #endif
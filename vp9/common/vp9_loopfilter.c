@@ -1463,6 +1463,7 @@ static void loop_filter_rows(YV12_BUFFER_CONFIG *frame_buffer, VP9_COMMON *cm,
         }
       }
     }
+    if (cm->lf.row_done_cb) cm->lf.row_done_cb(cm->lf.row_done_priv, mi_row);
   }
 }
 
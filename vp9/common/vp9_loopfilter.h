@@ -87,6 +87,11 @@ struct loopfilter {
 
   LOOP_FILTER_MASK *lfm;
   int lfm_stride;
+
+  // Called, if set, once the superblock row starting at mi_row has been
+  // filtered, from the thread that filtered it.
+  void (*row_done_cb)(void *priv, int mi_row);
+  void *row_done_priv;
 };
 
 /* assorted loopfilter functions which get used elsewhere */
@@ -355,45 +355,50 @@ static void mfqe_partition(VP9_COMMON *cm, MODE_INFO *mi, BLOCK_SIZE bs,
   }
 }
 
-void vp9_mfqe(VP9_COMMON *cm) {
-  int mi_row, mi_col;
+void vp9_mfqe_sb_row(VP9_COMMON *cm, int mi_row) {
+  int mi_col;
   // Current decoded frame.
   const YV12_BUFFER_CONFIG *show = cm->frame_to_show;
   // Last decoded frame and will store the MFQE result.
   YV12_BUFFER_CONFIG *dest = &cm->post_proc_buffer;
-  vpx_yv12_copy_frame(show, dest);
-  // Loop through each super block.
-  for (mi_row = 0; mi_row < cm->mi_rows; mi_row += MI_BLOCK_SIZE) {
-    for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE) {
-      MODE_INFO *mi;
-      MODE_INFO *mi_local = cm->mi + (mi_row * cm->mi_stride + mi_col);
-      // Motion Info in last frame.
-      MODE_INFO *mi_prev =
-          cm->postproc_state.prev_mi + (mi_row * cm->mi_stride + mi_col);
-      const uint32_t y_stride = show->y_stride;
-      const uint32_t uv_stride = show->uv_stride;
-      const uint32_t yd_stride = dest->y_stride;
-      const uint32_t uvd_stride = dest->uv_stride;
-      const uint32_t row_offset_y = mi_row << 3;
-      const uint32_t row_offset_uv = mi_row << 2;
-      const uint32_t col_offset_y = mi_col << 3;
-      const uint32_t col_offset_uv = mi_col << 2;
-      const uint8_t *y =
-          show->y_buffer + row_offset_y * y_stride + col_offset_y;
-      const uint8_t *u =
-          show->u_buffer + row_offset_uv * uv_stride + col_offset_uv;
-      const uint8_t *v =
-          show->v_buffer + row_offset_uv * uv_stride + col_offset_uv;
-      uint8_t *yd = dest->y_buffer + row_offset_y * yd_stride + col_offset_y;
-      uint8_t *ud = dest->u_buffer + row_offset_uv * uvd_stride + col_offset_uv;
-      uint8_t *vd = dest->v_buffer + row_offset_uv * uvd_stride + col_offset_uv;
-      if (frame_is_intra_only(cm)) {
-        mi = mi_prev;
-      } else {
-        mi = mi_local;
-      }
-      mfqe_partition(cm, mi, BLOCK_64X64, mi_row, mi_col, y, u, v, y_stride,
-                     uv_stride, yd, ud, vd, yd_stride, uvd_stride);
+  // Loop through each super block in the row.
+  for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE) {
+    MODE_INFO *mi;
+    MODE_INFO *mi_local = cm->mi + (mi_row * cm->mi_stride + mi_col);
+    // Motion Info in last frame.
+    MODE_INFO *mi_prev =
+        cm->postproc_state.prev_mi + (mi_row * cm->mi_stride + mi_col);
+    const uint32_t y_stride = show->y_stride;
+    const uint32_t uv_stride = show->uv_stride;
+    const uint32_t yd_stride = dest->y_stride;
+    const uint32_t uvd_stride = dest->uv_stride;
+    const uint32_t row_offset_y = mi_row << 3;
+    const uint32_t row_offset_uv = mi_row << 2;
+    const uint32_t col_offset_y = mi_col << 3;
+    const uint32_t col_offset_uv = mi_col << 2;
+    const uint8_t *y = show->y_buffer + row_offset_y * y_stride + col_offset_y;
+    const uint8_t *u =
+        show->u_buffer + row_offset_uv * uv_stride + col_offset_uv;
+    const uint8_t *v =
+        show->v_buffer + row_offset_uv * uv_stride + col_offset_uv;
+    uint8_t *yd = dest->y_buffer + row_offset_y * yd_stride + col_offset_y;
+    uint8_t *ud = dest->u_buffer + row_offset_uv * uvd_stride + col_offset_uv;
+    uint8_t *vd = dest->v_buffer + row_offset_uv * uvd_stride + col_offset_uv;
+    if (frame_is_intra_only(cm)) {
+      mi = mi_prev;
+    } else {
+      mi = mi_local;
     }
+    mfqe_partition(cm, mi, BLOCK_64X64, mi_row, mi_col, y, u, v, y_stride,
+                   uv_stride, yd, ud, vd, yd_stride, uvd_stride);
+  }
+}
+
+void vp9_mfqe(VP9_COMMON *cm) {
+  int mi_row;
+  vpx_yv12_copy_frame(cm->frame_to_show, &cm->post_proc_buffer);
+  // Loop through each super block row.
+  for (mi_row = 0; mi_row < cm->mi_rows; mi_row += MI_BLOCK_SIZE) {
+    vp9_mfqe_sb_row(cm, mi_row);
   }
 }
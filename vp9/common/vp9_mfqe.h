@@ -24,6 +24,11 @@ extern "C" {
 // difference, etc.
 void vp9_mfqe(struct VP9Common *cm);
 
+// Applies MFQE to the superblock row starting at mi_row. Superblock rows are
+// independent, but the current frame must already have been copied to
+// cm->post_proc_buffer.
+void vp9_mfqe_sb_row(struct VP9Common *cm, int mi_row);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -13,6 +13,8 @@
 
 #include "./vpx_config.h"
 #include "vpx/internal/vpx_codec_internal.h"
+#include "vpx_util/vpx_atomics.h"
+#include "vpx_util/vpx_pthread.h"
 #include "./vp9_rtcd.h"
 #include "vp9/common/vp9_alloccommon.h"
 #include "vp9/common/vp9_loopfilter.h"
@@ -78,6 +80,13 @@ typedef struct {
                            // show_idx defined in EncodeFrameInfo.
   int frame_coding_index;  // The coding order (starting from zero) of this
                            // frame.
+
+#if CONFIG_MULTITHREAD
+  // Number of luma rows from the top of the frame that are fully decoded and
+  // loop filtered. Only used in frame parallel decode.
+  vpx_atomic_int row;
+#endif
+
   vpx_codec_frame_buffer_t raw_frame_buffer;
   YV12_BUFFER_CONFIG buf;
 } RefCntBuffer;
@@ -93,6 +102,12 @@ typedef struct BufferPool {
 
   // Frame buffers allocated internally by the codec.
   InternalFrameBufferList int_frame_buffers;
+
+#if CONFIG_MULTITHREAD
+  // Guards the row progress of frame_bufs. Only used in frame parallel decode.
+  pthread_mutex_t row_mutex;
+  pthread_cond_t row_cond;
+#endif
 } BufferPool;
 
 typedef struct VP9Common {
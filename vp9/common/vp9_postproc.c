@@ -19,6 +19,7 @@
 
 #include "vpx_dsp/vpx_dsp_common.h"
 #include "vpx_dsp/postproc.h"
+#include "vpx_mem/vpx_mem.h"
 #include "vpx_ports/mem.h"
 #include "vpx_ports/system_state.h"
 #include "vpx_scale/vpx_scale.h"
@@ -183,96 +184,220 @@ void vp9_highbd_mbpost_proc_down_c(uint16_t *dst, int pitch, int rows, int cols,
 }
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
-static void deblock_and_de_macro_block(VP9_COMMON *cm,
-                                       YV12_BUFFER_CONFIG *source,
-                                       YV12_BUFFER_CONFIG *post, int q,
-                                       int low_var_thresh, int flag,
-                                       uint8_t *limits) {
-  (void)low_var_thresh;
-  (void)flag;
+// Deblocks macroblock row mb_row of src into dst. If mbpost_flimit is not 0
+// the horizontal demacroblock pass is applied to the luma rows as well. Rows
+// only depend on src, so they may be filtered in any order.
+static void deblock_mb_row(const YV12_BUFFER_CONFIG *src,
+                           YV12_BUFFER_CONFIG *dst, int ppl, uint8_t *limits,
+                           int mbpost_flimit, int mb_row) {
 #if CONFIG_VP9_HIGHBITDEPTH
-  if (source->flags & YV12_FLAG_HIGHBITDEPTH) {
-    double level = 6.0e-05 * q * q * q - .0067 * q * q + .306 * q + .0065;
-    int ppl = (int)(level + .5);
-    vp9_highbd_post_proc_down_and_across(
-        CONVERT_TO_SHORTPTR(source->y_buffer),
-        CONVERT_TO_SHORTPTR(post->y_buffer), source->y_stride, post->y_stride,
-        source->y_height, source->y_width, ppl);
-
-    vp9_highbd_mbpost_proc_across_ip(CONVERT_TO_SHORTPTR(post->y_buffer),
-                                     post->y_stride, post->y_height,
-                                     post->y_width, q2mbl(q));
+  if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
+    const int uv_size = 16 >> src->subsampling_y;
+    const int y_row = 16 * mb_row;
+    const int uv_row = uv_size * mb_row;
+    const int y_rows = VPXMIN(16, src->y_height - y_row);
+    const int uv_rows = VPXMIN(uv_size, src->uv_height - uv_row);
+    if (y_rows > 0) {
+      vp9_highbd_post_proc_down_and_across(
+          CONVERT_TO_SHORTPTR(src->y_buffer) + y_row * src->y_stride,
+          CONVERT_TO_SHORTPTR(dst->y_buffer) + y_row * dst->y_stride,
+          src->y_stride, dst->y_stride, y_rows, src->y_width, ppl);
+    }
+    if (uv_rows > 0) {
+      vp9_highbd_post_proc_down_and_across(
+          CONVERT_TO_SHORTPTR(src->u_buffer) + uv_row * src->uv_stride,
+          CONVERT_TO_SHORTPTR(dst->u_buffer) + uv_row * dst->uv_stride,
+          src->uv_stride, dst->uv_stride, uv_rows, src->uv_width, ppl);
+      vp9_highbd_post_proc_down_and_across(
+          CONVERT_TO_SHORTPTR(src->v_buffer) + uv_row * src->uv_stride,
+          CONVERT_TO_SHORTPTR(dst->v_buffer) + uv_row * dst->uv_stride,
+          src->uv_stride, dst->uv_stride, uv_rows, src->uv_width, ppl);
+    }
+    if (mbpost_flimit && VPXMIN(16, dst->y_height - y_row) > 0) {
+      vp9_highbd_mbpost_proc_across_ip(
+          CONVERT_TO_SHORTPTR(dst->y_buffer) + y_row * dst->y_stride,
+          dst->y_stride, VPXMIN(16, dst->y_height - y_row), dst->y_width,
+          mbpost_flimit);
+    }
+    return;
+  }
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  vpx_post_proc_down_and_across_mb_row(
+      src->y_buffer + 16 * mb_row * src->y_stride,
+      dst->y_buffer + 16 * mb_row * dst->y_stride, src->y_stride,
+      dst->y_stride, src->y_width, limits, 16);
+  vpx_post_proc_down_and_across_mb_row(
+      src->u_buffer + 8 * mb_row * src->uv_stride,
+      dst->u_buffer + 8 * mb_row * dst->uv_stride, src->uv_stride,
+      dst->uv_stride, src->uv_width, limits, 8);
+  vpx_post_proc_down_and_across_mb_row(
+      src->v_buffer + 8 * mb_row * src->uv_stride,
+      dst->v_buffer + 8 * mb_row * dst->uv_stride, src->uv_stride,
+      dst->uv_stride, src->uv_width, limits, 8);
+  if (mbpost_flimit && dst->y_height > 16 * mb_row) {
+    vpx_mbpost_proc_across_ip(dst->y_buffer + 16 * mb_row * dst->y_stride,
+                              dst->y_stride,
+                              VPXMIN(16, dst->y_height - 16 * mb_row),
+                              dst->y_width, mbpost_flimit);
+  }
+}
 
-    vp9_highbd_mbpost_proc_down(CONVERT_TO_SHORTPTR(post->y_buffer),
-                                post->y_stride, post->y_height, post->y_width,
-                                q2mbl(q));
+static int get_ppl(int q) {
+  return (int)(6.0e-05 * q * q * q - 0.0067 * q * q + 0.306 * q + 0.0065 +
+               0.5);
+}
 
-    vp9_highbd_post_proc_down_and_across(
-        CONVERT_TO_SHORTPTR(source->u_buffer),
-        CONVERT_TO_SHORTPTR(post->u_buffer), source->uv_stride, post->uv_stride,
-        source->uv_height, source->uv_width, ppl);
-    vp9_highbd_post_proc_down_and_across(
-        CONVERT_TO_SHORTPTR(source->v_buffer),
-        CONVERT_TO_SHORTPTR(post->v_buffer), source->uv_stride, post->uv_stride,
-        source->uv_height, source->uv_width, ppl);
-  } else {
-#endif  // CONFIG_VP9_HIGHBITDEPTH
-    vp9_deblock(cm, source, post, q, limits);
-    vpx_mbpost_proc_across_ip(post->y_buffer, post->y_stride, post->y_height,
-                              post->y_width, q2mbl(q));
-    vpx_mbpost_proc_down(post->y_buffer, post->y_stride, post->y_height,
-                         post->y_width, q2mbl(q));
+static int get_deblock_mb_rows(const VP9_COMMON *cm,
+                               const YV12_BUFFER_CONFIG *src) {
 #if CONFIG_VP9_HIGHBITDEPTH
+  if (src->flags & YV12_FLAG_HIGHBITDEPTH) return (src->y_height + 15) >> 4;
+#else
+  (void)src;
+#endif
+  return cm->mb_rows;
+}
+
+struct PostProcWorkerData {
+  VP9_COMMON *cm;
+  const YV12_BUFFER_CONFIG *src;
+  YV12_BUFFER_CONFIG *dst;
+  int ppl;
+  int mbpost_flimit;
+  // This worker handles rows start, start + step, start + 2 * step, ...
+  int start;
+  int step;
+};
+
+static int deblock_rows_worker(void *arg1, void *arg2) {
+  struct PostProcWorkerData *const data = (struct PostProcWorkerData *)arg1;
+  const int mb_rows = get_deblock_mb_rows(data->cm, data->src);
+  int mb_row;
+  (void)arg2;
+  for (mb_row = data->start; mb_row < mb_rows; mb_row += data->step) {
+    deblock_mb_row(data->src, data->dst, data->ppl,
+                   data->cm->postproc_state.limits, data->mbpost_flimit,
+                   mb_row);
   }
-#endif  // CONFIG_VP9_HIGHBITDEPTH
+  return 1;
 }
 
-void vp9_deblock(struct VP9Common *cm, const YV12_BUFFER_CONFIG *src,
-                 YV12_BUFFER_CONFIG *dst, int q, uint8_t *limits) {
-  const int ppl =
-      (int)(6.0e-05 * q * q * q - 0.0067 * q * q + 0.306 * q + 0.0065 + 0.5);
-#if CONFIG_VP9_HIGHBITDEPTH
-  if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
-    int i;
-    const uint8_t *const srcs[3] = { src->y_buffer, src->u_buffer,
-                                     src->v_buffer };
-    const int src_strides[3] = { src->y_stride, src->uv_stride,
-                                 src->uv_stride };
-    const int src_widths[3] = { src->y_width, src->uv_width, src->uv_width };
-    const int src_heights[3] = { src->y_height, src->uv_height,
-                                 src->uv_height };
-
-    uint8_t *const dsts[3] = { dst->y_buffer, dst->u_buffer, dst->v_buffer };
-    const int dst_strides[3] = { dst->y_stride, dst->uv_stride,
-                                 dst->uv_stride };
-    for (i = 0; i < MAX_MB_PLANE; ++i) {
-      vp9_highbd_post_proc_down_and_across(
-          CONVERT_TO_SHORTPTR(srcs[i]), CONVERT_TO_SHORTPTR(dsts[i]),
-          src_strides[i], dst_strides[i], src_heights[i], src_widths[i], ppl);
+static int mfqe_rows_worker(void *arg1, void *arg2) {
+  struct PostProcWorkerData *const data = (struct PostProcWorkerData *)arg1;
+  VP9_COMMON *const cm = data->cm;
+  int mi_row;
+  (void)arg2;
+  for (mi_row = data->start * MI_BLOCK_SIZE; mi_row < cm->mi_rows;
+       mi_row += data->step * MI_BLOCK_SIZE) {
+    vp9_mfqe_sb_row(cm, mi_row);
+  }
+  return 1;
+}
+
+// Runs hook on up to num_workers workers, each taking every num_workers-th
+// row of the pass. Rows within a pass are independent, so no worker ever
+// waits on another.
+static void post_proc_rows_mt(VP9_COMMON *cm, VPxWorkerHook hook,
+                              const YV12_BUFFER_CONFIG *src,
+                              YV12_BUFFER_CONFIG *dst, int ppl,
+                              int mbpost_flimit, int rows, VPxWorker *workers,
+                              int num_workers) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  struct postproc_state *const ppstate = &cm->postproc_state;
+  int i;
+
+  num_workers = VPXMIN(num_workers, rows);
+  if (ppstate->num_worker_data < num_workers) {
+    vpx_free(ppstate->worker_data);
+    ppstate->num_worker_data = 0;
+    CHECK_MEM_ERROR(&cm->error, ppstate->worker_data,
+                    vpx_calloc(num_workers, sizeof(*ppstate->worker_data)));
+    ppstate->num_worker_data = num_workers;
+  }
+
+  for (i = 0; i < num_workers; ++i) {
+    VPxWorker *const worker = &workers[i];
+    struct PostProcWorkerData *const data = &ppstate->worker_data[i];
+    data->cm = cm;
+    data->src = src;
+    data->dst = dst;
+    data->ppl = ppl;
+    data->mbpost_flimit = mbpost_flimit;
+    data->start = i;
+    data->step = num_workers;
+
+    worker->hook = hook;
+    worker->data1 = data;
+    worker->data2 = NULL;
+
+    if (i == num_workers - 1) {
+      winterface->execute(worker);
+    } else {
+      winterface->launch(worker);
     }
-  } else {
-#endif  // CONFIG_VP9_HIGHBITDEPTH
-    int mbr;
-    const int mb_rows = cm->mb_rows;
+  }
+
+  for (i = 0; i < num_workers; ++i) {
+    winterface->sync(&workers[i]);
+  }
+}
+
+static void deblock_mt(VP9_COMMON *cm, const YV12_BUFFER_CONFIG *src,
+                       YV12_BUFFER_CONFIG *dst, int q, int mbpost_flimit,
+                       uint8_t *limits, VPxWorker *workers, int num_workers) {
+  const int ppl = get_ppl(q);
+  const int mb_rows = get_deblock_mb_rows(cm, src);
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (!(src->flags & YV12_FLAG_HIGHBITDEPTH))
+#endif
     memset(limits, (unsigned char)ppl, cm->postproc_state.limits_size);
 
-    for (mbr = 0; mbr < mb_rows; mbr++) {
-      vpx_post_proc_down_and_across_mb_row(
-          src->y_buffer + 16 * mbr * src->y_stride,
-          dst->y_buffer + 16 * mbr * dst->y_stride, src->y_stride,
-          dst->y_stride, src->y_width, limits, 16);
-      vpx_post_proc_down_and_across_mb_row(
-          src->u_buffer + 8 * mbr * src->uv_stride,
-          dst->u_buffer + 8 * mbr * dst->uv_stride, src->uv_stride,
-          dst->uv_stride, src->uv_width, limits, 8);
-      vpx_post_proc_down_and_across_mb_row(
-          src->v_buffer + 8 * mbr * src->uv_stride,
-          dst->v_buffer + 8 * mbr * dst->uv_stride, src->uv_stride,
-          dst->uv_stride, src->uv_width, limits, 8);
+  if (num_workers > 1) {
+    post_proc_rows_mt(cm, deblock_rows_worker, src, dst, ppl, mbpost_flimit,
+                      mb_rows, workers, num_workers);
+  } else {
+    int mb_row;
+    for (mb_row = 0; mb_row < mb_rows; ++mb_row) {
+      deblock_mb_row(src, dst, ppl, limits, mbpost_flimit, mb_row);
     }
+  }
+}
+
+static void mfqe_mt(VP9_COMMON *cm, VPxWorker *workers, int num_workers) {
+  if (num_workers > 1) {
+    const int sb_rows =
+        mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
+    vpx_yv12_copy_frame(cm->frame_to_show, &cm->post_proc_buffer);
+    post_proc_rows_mt(cm, mfqe_rows_worker, NULL, NULL, 0, 0, sb_rows, workers,
+                      num_workers);
+  } else {
+    vp9_mfqe(cm);
+  }
+}
+
+static void deblock_and_de_macro_block(VP9_COMMON *cm,
+                                       YV12_BUFFER_CONFIG *source,
+                                       YV12_BUFFER_CONFIG *post, int q,
+                                       uint8_t *limits, VPxWorker *workers,
+                                       int num_workers) {
+  // The horizontal pass runs on each row right after it is deblocked. The
+  // vertical pass spans the whole frame and draws its dither offset from
+  // rand(), so it stays on the calling thread.
+  deblock_mt(cm, source, post, q, q2mbl(q), limits, workers, num_workers);
 #if CONFIG_VP9_HIGHBITDEPTH
+  if (source->flags & YV12_FLAG_HIGHBITDEPTH) {
+    vp9_highbd_mbpost_proc_down(CONVERT_TO_SHORTPTR(post->y_buffer),
+                                post->y_stride, post->y_height, post->y_width,
+                                q2mbl(q));
+    return;
   }
 #endif  // CONFIG_VP9_HIGHBITDEPTH
+  vpx_mbpost_proc_down(post->y_buffer, post->y_stride, post->y_height,
+                       post->y_width, q2mbl(q));
+}
+
+void vp9_deblock(struct VP9Common *cm, const YV12_BUFFER_CONFIG *src,
+                 YV12_BUFFER_CONFIG *dst, int q, uint8_t *limits) {
+  deblock_mt(cm, src, dst, q, 0, limits, NULL, 0);
 }
 
 void vp9_denoise(struct VP9Common *cm, const YV12_BUFFER_CONFIG *src,
@@ -299,6 +424,12 @@ static void swap_mi_and_prev_mi(VP9_COMMON *cm) {
 
 int vp9_post_proc_frame(struct VP9Common *cm, YV12_BUFFER_CONFIG *dest,
                         vp9_ppflags_t *ppflags, int unscaled_width) {
+  return vp9_post_proc_frame_mt(cm, dest, ppflags, unscaled_width, NULL, 0);
+}
+
+int vp9_post_proc_frame_mt(struct VP9Common *cm, YV12_BUFFER_CONFIG *dest,
+                           vp9_ppflags_t *ppflags, int unscaled_width,
+                           VPxWorker *workers, int num_workers) {
   const int q = VPXMIN(105, cm->lf.filter_level * 2);
   YV12_BUFFER_CONFIG *const ppbuf = &cm->post_proc_buffer;
   struct postproc_state *const ppstate = &cm->postproc_state;
@@ -411,7 +542,7 @@ int vp9_post_proc_frame(struct VP9Common *cm, YV12_BUFFER_CONFIG *dest,
       cm->height == cm->prev_frame->buf.y_height && cm->bit_depth == 8 &&
       ppstate->last_base_qindex <= last_q_thresh &&
       cm->base_qindex - ppstate->last_base_qindex >= q_diff_thresh) {
-    vp9_mfqe(cm);
+    mfqe_mt(cm, workers, num_workers);
     // TODO(jackychen): Consider whether enable deblocking by default
     // if mfqe is enabled. Need to take both the quality and the speed
     // into consideration.
@@ -420,20 +551,22 @@ int vp9_post_proc_frame(struct VP9Common *cm, YV12_BUFFER_CONFIG *dest,
     }
     if ((flags & VP9D_DEMACROBLOCK) && cm->post_proc_buffer_int.buffer_alloc) {
       deblock_and_de_macro_block(cm, &cm->post_proc_buffer_int, ppbuf,
-                                 q + (ppflags->deblocking_level - 5) * 10, 1, 0,
-                                 cm->postproc_state.limits);
+                                 q + (ppflags->deblocking_level - 5) * 10,
+                                 cm->postproc_state.limits, workers,
+                                 num_workers);
     } else if (flags & VP9D_DEBLOCK) {
-      vp9_deblock(cm, &cm->post_proc_buffer_int, ppbuf, q,
-                  cm->postproc_state.limits);
+      deblock_mt(cm, &cm->post_proc_buffer_int, ppbuf, q, 0,
+                 cm->postproc_state.limits, workers, num_workers);
     } else {
       vpx_yv12_copy_frame(&cm->post_proc_buffer_int, ppbuf);
     }
   } else if (flags & VP9D_DEMACROBLOCK) {
     deblock_and_de_macro_block(cm, cm->frame_to_show, ppbuf,
-                               q + (ppflags->deblocking_level - 5) * 10, 1, 0,
-                               cm->postproc_state.limits);
+                               q + (ppflags->deblocking_level - 5) * 10,
+                               cm->postproc_state.limits, workers, num_workers);
   } else if (flags & VP9D_DEBLOCK) {
-    vp9_deblock(cm, cm->frame_to_show, ppbuf, q, cm->postproc_state.limits);
+    deblock_mt(cm, cm->frame_to_show, ppbuf, q, 0, cm->postproc_state.limits,
+               workers, num_workers);
   } else {
     vpx_yv12_copy_frame(cm->frame_to_show, ppbuf);
   }
@@ -13,6 +13,7 @@
 
 #include "vpx_ports/mem.h"
 #include "vpx_scale/yv12config.h"
+#include "vpx_util/vpx_thread.h"
 #include "vp9/common/vp9_blockd.h"
 #include "vp9/common/vp9_mfqe.h"
 #include "vp9/common/vp9_ppflags.h"
@@ -34,6 +35,8 @@ struct postproc_state {
   int prev_mip_size;
   int8_t *generated_noise;
   int generated_noise_size;
+  struct PostProcWorkerData *worker_data;
+  int num_worker_data;
 };
 
 struct VP9Common;
@@ -43,6 +46,12 @@ struct VP9Common;
 int vp9_post_proc_frame(struct VP9Common *cm, YV12_BUFFER_CONFIG *dest,
                         vp9_ppflags_t *ppflags, int unscaled_width);
 
+// Same as vp9_post_proc_frame(), but spreads the MFQE and deblocking passes
+// over superblock and macroblock rows on the given workers.
+int vp9_post_proc_frame_mt(struct VP9Common *cm, YV12_BUFFER_CONFIG *dest,
+                           vp9_ppflags_t *ppflags, int unscaled_width,
+                           VPxWorker *workers, int num_workers);
+
 void vp9_denoise(struct VP9Common *cm, const YV12_BUFFER_CONFIG *src,
                  YV12_BUFFER_CONFIG *dst, int q, uint8_t *limits);
 
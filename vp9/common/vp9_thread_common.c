@@ -142,16 +142,38 @@ static INLINE void thread_loop_filter_rows(
 
       sync_write(lf_sync, r, c, sb_cols);
     }
+    if (cm->lf.row_done_cb) cm->lf.row_done_cb(cm->lf.row_done_priv, mi_row);
   }
 }
 
+// Returns the next superblock row to filter, or -1 once all rows up to |stop|
+// have been claimed. Rows are handed out in order so a worker only ever waits
+// on a row that another running worker has already started.
+static int claim_next_row(VP9LfSync *const lf_sync, int stop) {
+  int mi_row = -1;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(lf_sync->lf_mutex);
+#endif
+  if (lf_sync->next_mi_row < stop) {
+    mi_row = lf_sync->next_mi_row;
+    lf_sync->next_mi_row += MI_BLOCK_SIZE;
+  }
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(lf_sync->lf_mutex);
+#endif
+  return mi_row;
+}
+
 // Row-based multi-threaded loopfilter hook
 static int loop_filter_row_worker(void *arg1, void *arg2) {
   VP9LfSync *const lf_sync = (VP9LfSync *)arg1;
   LFWorkerData *const lf_data = (LFWorkerData *)arg2;
-  thread_loop_filter_rows(lf_data->frame_buffer, lf_data->cm, lf_data->planes,
-                          lf_data->start, lf_data->stop, lf_data->y_only,
-                          lf_sync);
+  int mi_row;
+  while ((mi_row = claim_next_row(lf_sync, lf_data->stop)) >= 0) {
+    thread_loop_filter_rows(lf_data->frame_buffer, lf_data->cm, lf_data->planes,
+                            mi_row, mi_row + MI_BLOCK_SIZE, lf_data->y_only,
+                            lf_sync);
+  }
   return 1;
 }
 
@@ -171,15 +193,7 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, VP9_COMMON *cm,
   const int num_workers = VPXMIN(nworkers, VPXMIN(num_tile_cols, sb_rows));
   int i;
 
-  if (!lf_sync->sync_range || sb_rows != lf_sync->rows ||
-      num_workers > lf_sync->num_workers) {
-    vp9_loop_filter_dealloc(lf_sync);
-    vp9_loop_filter_alloc(lf_sync, cm, sb_rows, cm->width, num_workers);
-  }
-  lf_sync->num_active_workers = num_workers;
-
-  // Initialize cur_sb_col to -1 for all SB rows.
-  memset(lf_sync->cur_sb_col, -1, sizeof(*lf_sync->cur_sb_col) * sb_rows);
+  vp9_lf_sync_rows_init(lf_sync, cm, start, num_workers);
 
   // Set up loopfilter thread data.
   // The decoder is capping num_workers because it has been observed that using
@@ -199,7 +213,7 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, VP9_COMMON *cm,
 
     // Loopfilter data
     vp9_loop_filter_data_reset(lf_data, frame, cm, planes);
-    lf_data->start = start + i * MI_BLOCK_SIZE;
+    lf_data->start = start;
     lf_data->stop = stop;
     lf_data->y_only = y_only;
 
@@ -217,6 +231,34 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, VP9_COMMON *cm,
   }
 }
 
+void vp9_lf_sync_rows_init(VP9LfSync *lf_sync, VP9_COMMON *cm, int start,
+                           int num_workers) {
+  const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
+
+  if (!lf_sync->sync_range || sb_rows != lf_sync->rows ||
+      num_workers > lf_sync->num_workers) {
+    vp9_loop_filter_dealloc(lf_sync);
+    vp9_loop_filter_alloc(lf_sync, cm, sb_rows, cm->width, num_workers);
+  }
+  lf_sync->num_active_workers = num_workers;
+  lf_sync->next_mi_row = start;
+
+  // Initialize cur_sb_col to -1 for all SB rows.
+  memset(lf_sync->cur_sb_col, -1, sizeof(*lf_sync->cur_sb_col) * sb_rows);
+}
+
+int vp9_lf_sync_claim_row(VP9LfSync *lf_sync, int stop) {
+  return claim_next_row(lf_sync, stop);
+}
+
+void vp9_lf_sync_read(VP9LfSync *lf_sync, int r, int c) {
+  sync_read(lf_sync, r, c);
+}
+
+void vp9_lf_sync_write(VP9LfSync *lf_sync, int r, int c, int sb_cols) {
+  sync_write(lf_sync, r, c, sb_cols);
+}
+
 void vp9_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, VP9_COMMON *cm,
                               struct macroblockd_plane planes[MAX_MB_PLANE],
                               int frame_filter_level, int y_only,
@@ -39,6 +39,7 @@ typedef struct VP9LfSyncData {
   LFWorkerData *lfdata;
   int num_workers;         // number of allocated workers.
   int num_active_workers;  // number of scheduled workers.
+  int next_mi_row;         // next row to be claimed by a loop filter worker.
 
 #if CONFIG_MULTITHREAD
   pthread_mutex_t *lf_mutex;
@@ -63,6 +64,21 @@ void vp9_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, struct VP9Common *cm,
                               int partial_frame, VPxWorker *workers,
                               int num_workers, VP9LfSync *lf_sync);
 
+// Prepares 'lf_sync' for a pass over the superblock rows of 'cm' from 'start'
+// by 'num_workers' workers. Each worker claims rows in order with
+// vp9_lf_sync_claim_row() and brackets each superblock 'c' of row 'r' with
+// vp9_lf_sync_read() and vp9_lf_sync_write(), which keep it behind the
+// superblocks of row 'r' - 1 its loop filter reads.
+void vp9_lf_sync_rows_init(VP9LfSync *lf_sync, struct VP9Common *cm, int start,
+                           int num_workers);
+
+// Returns the next superblock row below 'stop' to process, in mi units, or -1.
+int vp9_lf_sync_claim_row(VP9LfSync *lf_sync, int stop);
+
+void vp9_lf_sync_read(VP9LfSync *lf_sync, int r, int c);
+
+void vp9_lf_sync_write(VP9LfSync *lf_sync, int r, int c, int sb_cols);
+
 // Multi-threaded loopfilter initialisations
 void vp9_lpf_mt_init(VP9LfSync *lf_sync, struct VP9Common *cm,
                      int frame_filter_level, int num_workers);
@@ -9,6 +9,7 @@
  */
 
 #include <assert.h>
+#include <limits.h>
 #include <stdlib.h>  // qsort()
 
 #include "./vp9_rtcd.h"
@@ -580,7 +581,7 @@ static void dec_build_inter_predictors(
     int y, int w, int h, int mi_x, int mi_y, const InterpKernel *kernel,
     const struct scale_factors *sf, struct buf_2d *pre_buf,
     struct buf_2d *dst_buf, const MV *mv, RefCntBuffer *ref_frame_buf,
-    int is_scaled, int ref) {
+    int is_scaled, int ref, BufferPool *const pool) {
   struct macroblockd_plane *const pd = &xd->plane[plane];
   uint8_t *const dst = dst_buf->buf + dst_buf->stride * y + x;
   MV32 scaled_mv;
@@ -679,6 +680,11 @@ static void dec_build_inter_predictors(
       y_pad = 1;
     }
 
+    // Wait until the reference block is ready.
+    if (pool != NULL)
+      vp9_frameworker_wait(pool, ref_frame_buf, VPXMAX(0, y1 + 1)
+                                                    << pd->subsampling_y);
+
     // Skip border extension if block is inside the frame.
     if (x0 < 0 || x0 > frame_width - 1 || x1 < 0 || x1 > frame_width - 1 ||
         y0 < 0 || y0 > frame_height - 1 || y1 < 0 || y1 > frame_height - 1) {
@@ -697,6 +703,9 @@ static void dec_build_inter_predictors(
                          w, h, ref, xs, ys);
       return;
     }
+  } else if (pool != NULL) {
+    // Wait until the reference block is ready.
+    vp9_frameworker_wait(pool, ref_frame_buf, (y0 + h) << pd->subsampling_y);
   }
 #if CONFIG_VP9_HIGHBITDEPTH
   if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
@@ -721,9 +730,13 @@ static void dec_build_inter_predictors_sb(TileWorkerData *twd,
   const int mi_x = mi_col * MI_SIZE;
   const int mi_y = mi_row * MI_SIZE;
   const MODE_INFO *mi = xd->mi[0];
-  const InterpKernel *kernel = vp9_filter_kernels[mi->interp_filter];
+  const InterpKernel *kernel =
+      vp9_filter_kernels[pbi->bilinear_prediction ? BILINEAR
+                                                  : mi->interp_filter];
   const BLOCK_SIZE sb_type = mi->sb_type;
   const int is_compound = has_second_ref(mi);
+  BufferPool *const wait_pool =
+      pbi->frame_parallel_decode ? pbi->common.buffer_pool : NULL;
   int ref;
   int is_scaled;
 
@@ -760,7 +773,7 @@ static void dec_build_inter_predictors_sb(TileWorkerData *twd,
             dec_build_inter_predictors(twd, xd, plane, n4w_x4, n4h_x4, 4 * x,
                                        4 * y, 4, 4, mi_x, mi_y, kernel, sf,
                                        pre_buf, dst_buf, &mv, ref_frame_buf,
-                                       is_scaled, ref);
+                                       is_scaled, ref, wait_pool);
           }
         }
       }
@@ -776,7 +789,8 @@ static void dec_build_inter_predictors_sb(TileWorkerData *twd,
         struct buf_2d *const pre_buf = &pd->pre[ref];
         dec_build_inter_predictors(twd, xd, plane, n4w_x4, n4h_x4, 0, 0, n4w_x4,
                                    n4h_x4, mi_x, mi_y, kernel, sf, pre_buf,
-                                   dst_buf, &mv, ref_frame_buf, is_scaled, ref);
+                                   dst_buf, &mv, ref_frame_buf, is_scaled, ref,
+                                   wait_pool);
       }
     }
   }
@@ -1514,7 +1528,8 @@ static void resize_context_buffers(VP9_COMMON *cm, int width, int height) {
   }
 }
 
-static void setup_frame_size(VP9_COMMON *cm, struct vpx_read_bit_buffer *rb) {
+static void setup_frame_size(VP9Decoder *pbi, struct vpx_read_bit_buffer *rb) {
+  VP9_COMMON *const cm = &pbi->common;
   int width, height;
   BufferPool *const pool = cm->buffer_pool;
   vp9_read_frame_size(rb, &width, &height);
@@ -1527,7 +1542,7 @@ static void setup_frame_size(VP9_COMMON *cm, struct vpx_read_bit_buffer *rb) {
 #if CONFIG_VP9_HIGHBITDEPTH
           cm->use_highbitdepth,
 #endif
-          VP9_DEC_BORDER_IN_PIXELS, cm->byte_alignment,
+          pbi->frame_border, cm->byte_alignment,
           &pool->frame_bufs[cm->new_fb_idx].raw_frame_buffer, pool->get_fb_cb,
           pool->cb_priv)) {
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
@@ -1552,8 +1567,9 @@ static INLINE int valid_ref_frame_img_fmt(vpx_bit_depth_t ref_bit_depth,
          ref_yss == this_yss;
 }
 
-static void setup_frame_size_with_refs(VP9_COMMON *cm,
+static void setup_frame_size_with_refs(VP9Decoder *pbi,
                                        struct vpx_read_bit_buffer *rb) {
+  VP9_COMMON *const cm = &pbi->common;
   int width, height;
   int found = 0, i;
   int has_valid_ref_frame = 0;
@@ -1608,7 +1624,7 @@ static void setup_frame_size_with_refs(VP9_COMMON *cm,
 #if CONFIG_VP9_HIGHBITDEPTH
           cm->use_highbitdepth,
 #endif
-          VP9_DEC_BORDER_IN_PIXELS, cm->byte_alignment,
+          pbi->frame_border, cm->byte_alignment,
           &pool->frame_bufs[cm->new_fb_idx].raw_frame_buffer, pool->get_fb_cb,
           pool->cb_priv)) {
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
@@ -2012,6 +2028,12 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
   return !corrupted;
 }
 
+// Loop filter row callback. Filtering a row also changes the bottom pixels of
+// the row above it, so only the rows above the filtered one are final.
+static void lf_row_done(void *priv, int mi_row) {
+  vp9_dec_rows_ready((VP9Decoder *)priv, mi_row);
+}
+
 static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
                                    const uint8_t *data_end) {
   VP9_COMMON *const cm = &pbi->common;
@@ -2029,6 +2051,7 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
     CHECK_MEM_ERROR(&cm->error, pbi->lf_worker.data1,
                     vpx_memalign(32, sizeof(LFWorkerData)));
     pbi->lf_worker.hook = vp9_loop_filter_worker;
+    pbi->lf_worker.pool_client = pbi->pool_client;
     if (pbi->max_threads > 1 && !winterface->reset(&pbi->lf_worker)) {
       vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
                          "Loop filter thread creation failed");
@@ -2041,6 +2064,7 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
     winterface->sync(&pbi->lf_worker);
     vp9_loop_filter_data_reset(lf_data, get_frame_new_buffer(cm), cm,
                                pbi->mb.plane);
+    lf_data->y_only = pbi->lf_y_only;
   }
 
   assert(tile_rows <= 4);
@@ -2138,6 +2162,8 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
         } else {
           winterface->execute(&pbi->lf_worker);
         }
+      } else {
+        vp9_dec_rows_ready(pbi, mi_row + MI_BLOCK_SIZE);
       }
     }
   }
@@ -2157,6 +2183,197 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
   return vpx_reader_find_end(&tile_data->bit_reader);
 }
 
+// Frame parallel decode: parses all the tiles of the frame into the row mt
+// buffers. Reconstruction is left to vp9_decode_frame_recon().
+static const uint8_t *parse_tiles(VP9Decoder *pbi, const uint8_t *data,
+                                  const uint8_t *data_end) {
+  VP9_COMMON *const cm = &pbi->common;
+  RowMTWorkerData *const row_mt_worker_data = pbi->row_mt_worker_data;
+  const int aligned_cols = mi_cols_aligned_to_sb(cm->mi_cols);
+  const int sb_cols = aligned_cols >> MI_BLOCK_SIZE_LOG2;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int tile_rows = 1 << cm->log2_tile_rows;
+  TileBuffer tile_buffers[4][1 << 6];
+  int tile_row, tile_col;
+  int mi_row, mi_col;
+  TileWorkerData *tile_data = NULL;
+
+  assert(tile_rows <= 4);
+  assert(tile_cols <= (1 << 6));
+
+  // Note: this memset assumes above_context[0], [1] and [2]
+  // are allocated as part of the same buffer.
+  memset(cm->above_context, 0,
+         sizeof(*cm->above_context) * MAX_MB_PLANE * 2 * aligned_cols);
+
+  memset(cm->above_seg_context, 0,
+         sizeof(*cm->above_seg_context) * aligned_cols);
+
+  get_tile_buffers(pbi, data, data_end, tile_cols, tile_rows, tile_buffers);
+
+  // Load all tile information into tile_data.
+  for (tile_row = 0; tile_row < tile_rows; ++tile_row) {
+    for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
+      const TileBuffer *const buf = &tile_buffers[tile_row][tile_col];
+      tile_data = pbi->tile_worker_data + tile_cols * tile_row + tile_col;
+      tile_data->xd = pbi->mb;
+      tile_data->xd.corrupted = 0;
+      tile_data->xd.counts =
+          cm->frame_parallel_decoding_mode ? NULL : &cm->counts;
+      vp9_zero(tile_data->dqcoeff);
+      vp9_tile_init(&tile_data->xd.tile, cm, tile_row, tile_col);
+      setup_token_decoder(buf->data, data_end, buf->size, &cm->error,
+                          &tile_data->bit_reader, pbi->decrypt_cb,
+                          pbi->decrypt_state);
+      vp9_init_macroblockd(cm, &tile_data->xd, tile_data->dqcoeff);
+    }
+  }
+
+  for (tile_row = 0; tile_row < tile_rows; ++tile_row) {
+    TileInfo tile;
+    vp9_tile_set_row(&tile, cm, tile_row);
+    for (mi_row = tile.mi_row_start; mi_row < tile.mi_row_end;
+         mi_row += MI_BLOCK_SIZE) {
+      const int sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
+      for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
+        tile_data = pbi->tile_worker_data + tile_cols * tile_row + tile_col;
+        vp9_tile_set_col(&tile, cm, tile_col);
+        vp9_zero(tile_data->xd.left_context);
+        vp9_zero(tile_data->xd.left_seg_context);
+        for (mi_col = tile.mi_col_start; mi_col < tile.mi_col_end;
+             mi_col += MI_BLOCK_SIZE) {
+          const size_t sb_num =
+              sb_row * sb_cols + (mi_col >> MI_BLOCK_SIZE_LOG2);
+          int plane;
+          for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+            tile_data->xd.plane[plane].eob =
+                row_mt_worker_data->eob[plane] + (sb_num << EOBS_PER_SB_LOG2);
+            tile_data->xd.plane[plane].dqcoeff =
+                row_mt_worker_data->dqcoeff[plane] +
+                (sb_num << DQCOEFFS_PER_SB_LOG2);
+          }
+          tile_data->xd.partition =
+              row_mt_worker_data->partition + sb_num * PARTITIONS_PER_SB;
+          process_partition(tile_data, pbi, mi_row, mi_col, BLOCK_64X64, 4,
+                            PARSE, parse_block);
+        }
+        pbi->mb.corrupted |= tile_data->xd.corrupted;
+        if (pbi->mb.corrupted)
+          vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
+                             "Failed to decode tile data");
+      }
+    }
+  }
+
+  // Get last tile data.
+  tile_data = pbi->tile_worker_data + tile_cols * tile_rows - 1;
+
+  return vpx_reader_find_end(&tile_data->bit_reader);
+}
+
+// Frame parallel decode: reconstructs the frame parsed by parse_tiles() with
+// 'tile_data', loop filtering it one superblock row behind.
+static void recon_tiles(VP9Decoder *pbi, TileWorkerData *const tile_data) {
+  VP9_COMMON *const cm = &pbi->common;
+  RowMTWorkerData *const row_mt_worker_data = pbi->row_mt_worker_data;
+  BufferPool *const pool = cm->buffer_pool;
+  RefCntBuffer *const cur_buf = pbi->cur_buf;
+  const int aligned_cols = mi_cols_aligned_to_sb(cm->mi_cols);
+  const int sb_cols = aligned_cols >> MI_BLOCK_SIZE_LOG2;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int tile_rows = 1 << cm->log2_tile_rows;
+  const int do_lf = cm->lf.filter_level && !cm->skip_loop_filter;
+  LFWorkerData lf_data;
+  int tile_row, tile_col;
+  int mi_row, mi_col;
+
+  tile_data->xd = pbi->mb;
+  tile_data->xd.error_info = &tile_data->error_info;
+  vp9_init_macroblockd(cm, &tile_data->xd, tile_data->dqcoeff);
+  vp9_reset_lfm(cm);
+  if (do_lf) {
+    vp9_loop_filter_data_reset(&lf_data, get_frame_new_buffer(cm), cm,
+                               pbi->mb.plane);
+    lf_data.y_only = pbi->lf_y_only;
+  }
+
+  for (tile_row = 0; tile_row < tile_rows; ++tile_row) {
+    TileInfo tile;
+    vp9_tile_set_row(&tile, cm, tile_row);
+    for (mi_row = tile.mi_row_start; mi_row < tile.mi_row_end;
+         mi_row += MI_BLOCK_SIZE) {
+      const int sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
+      for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
+        vp9_tile_init(&tile_data->xd.tile, cm, tile_row, tile_col);
+        for (mi_col = tile_data->xd.tile.mi_col_start;
+             mi_col < tile_data->xd.tile.mi_col_end; mi_col += MI_BLOCK_SIZE) {
+          const size_t sb_num =
+              sb_row * sb_cols + (mi_col >> MI_BLOCK_SIZE_LOG2);
+          int plane;
+          for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+            tile_data->xd.plane[plane].eob =
+                row_mt_worker_data->eob[plane] + (sb_num << EOBS_PER_SB_LOG2);
+            tile_data->xd.plane[plane].dqcoeff =
+                row_mt_worker_data->dqcoeff[plane] +
+                (sb_num << DQCOEFFS_PER_SB_LOG2);
+          }
+          tile_data->xd.partition =
+              row_mt_worker_data->partition + sb_num * PARTITIONS_PER_SB;
+          process_partition(tile_data, pbi, mi_row, mi_col, BLOCK_64X64, 4,
+                            RECON, recon_block);
+        }
+      }
+
+      if (do_lf) {
+        // The loop filter runs one superblock row behind as the intra
+        // prediction of this row needs the unfiltered pixels of the row
+        // above. Filtering a row also changes the bottom pixels of the row
+        // above it, so only the rows above the filtered one are final.
+        if (mi_row > 0) {
+          lf_data.start = mi_row - MI_BLOCK_SIZE;
+          lf_data.stop = mi_row;
+          vp9_loop_filter_worker(&lf_data, NULL);
+          vp9_frameworker_broadcast(pool, cur_buf, lf_data.start * MI_SIZE);
+        }
+      } else {
+        vp9_frameworker_broadcast(pool, cur_buf,
+                                  (mi_row + MI_BLOCK_SIZE) * MI_SIZE);
+        vp9_dec_rows_ready(pbi, mi_row + MI_BLOCK_SIZE);
+      }
+    }
+  }
+
+  // Loopfilter the last superblock row.
+  if (do_lf) {
+    lf_data.start = lf_data.stop;
+    lf_data.stop = cm->mi_rows;
+    vp9_loop_filter_worker(&lf_data, NULL);
+  }
+}
+
+int vp9_decode_frame_recon(VP9Decoder *pbi) {
+  BufferPool *const pool = pbi->common.buffer_pool;
+  RefCntBuffer *const cur_buf = pbi->cur_buf;
+  // Parsing is done at this point, so the first tile's data is free for use.
+  TileWorkerData *const tile_data = pbi->tile_worker_data;
+
+  if (setjmp(tile_data->error_info.jmp)) {
+    tile_data->error_info.setjmp = 0;
+    cur_buf->buf.corrupted = 1;
+    vp9_dec_clear_row_mt_coeffs(pbi->row_mt_worker_data);
+    vp9_frameworker_broadcast(pool, cur_buf, INT_MAX);
+    return 0;
+  }
+  tile_data->error_info.setjmp = 1;
+
+  recon_tiles(pbi, tile_data);
+  vp9_dec_rows_ready(pbi, pbi->common.mi_rows);
+
+  tile_data->error_info.setjmp = 0;
+  vp9_frameworker_broadcast(pool, cur_buf, INT_MAX);
+  return 1;
+}
+
 static void set_rows_after_error(VP9LfSync *lf_sync, int start_row, int mi_rows,
                                  int num_tiles_left, int total_num_tiles) {
   do {
@@ -2277,33 +2494,11 @@ static int compare_tile_buffers(const void *a, const void *b) {
 }
 
 static INLINE void init_mt(VP9Decoder *pbi) {
-  int n;
   VP9_COMMON *const cm = &pbi->common;
   VP9LfSync *lf_row_sync = &pbi->lf_row_sync;
   const int aligned_mi_cols = mi_cols_aligned_to_sb(cm->mi_cols);
-  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
 
-  if (pbi->num_tile_workers == 0) {
-    const int num_threads = pbi->max_threads;
-    CHECK_MEM_ERROR(&cm->error, pbi->tile_workers,
-                    vpx_malloc(num_threads * sizeof(*pbi->tile_workers)));
-    for (n = 0; n < num_threads; ++n) {
-      VPxWorker *const worker = &pbi->tile_workers[n];
-      ++pbi->num_tile_workers;
-
-      winterface->init(worker);
-      worker->thread_name = "vpx tile worker";
-      if (n < num_threads - 1 && !winterface->reset(worker)) {
-        do {
-          winterface->end(&pbi->tile_workers[pbi->num_tile_workers - 1]);
-        } while (--pbi->num_tile_workers != 0);
-        vpx_free(pbi->tile_workers);
-        pbi->tile_workers = NULL;
-        vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
-                           "Tile decoder thread creation failed");
-      }
-    }
-  }
+  vp9_dec_alloc_tile_workers(pbi);
 
   // Initialize LPF
   if ((pbi->lpf_mt_opt || pbi->row_mt) && cm->lf.filter_level &&
@@ -2360,6 +2555,7 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
       thread_data->lf_data = &thread_data->lf_sync->lfdata[n];
       vp9_loop_filter_data_reset(thread_data->lf_data, new_fb, cm,
                                  pbi->mb.plane);
+      thread_data->lf_data->y_only = pbi->lf_y_only;
     }
 
     thread_data->pbi = pbi;
@@ -2469,7 +2665,7 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
       tile_data->lf_sync = lf_row_sync;
       tile_data->lf_data = &tile_data->lf_sync->lfdata[n];
       vp9_loop_filter_data_reset(tile_data->lf_data, new_fb, cm, pbi->mb.plane);
-      tile_data->lf_data->y_only = 0;
+      tile_data->lf_data->y_only = pbi->lf_y_only;
     }
 
     tile_data->xd = pbi->mb;
@@ -2635,6 +2831,32 @@ static INLINE void flush_all_fb_on_key(VP9_COMMON *cm) {
   }
 }
 
+// Frame parallel decode: buffers of the frames still in flight must stay
+// held, so only the references of the reference map are dropped on resync.
+static INLINE void release_ref_frame_map(VP9_COMMON *cm) {
+  BufferPool *const pool = cm->buffer_pool;
+  int i;
+  for (i = 0; i < REF_FRAMES; ++i) {
+    decrease_ref_count(cm->ref_frame_map[i], pool->frame_bufs, pool);
+    cm->ref_frame_map[i] = INVALID_IDX;
+  }
+}
+
+// Sets up the shortcuts taken in the frame. Nothing predicts from the pixels
+// of a frame that refreshes no reference, so the shortcuts taken there do not
+// affect later frames.
+static void setup_complexity(VP9Decoder *pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+  const int non_reference = !pbi->refresh_frame_flags;
+  const int level = pbi->complexity_level;
+
+  cm->skip_loop_filter =
+      pbi->skip_loop_filter || level >= 4 ||
+      (non_reference && (pbi->references_only || level >= 1));
+  pbi->bilinear_prediction = non_reference && level >= 2;
+  pbi->lf_y_only = level >= 3;
+}
+
 static size_t read_uncompressed_header(VP9Decoder *pbi,
                                        struct vpx_read_bit_buffer *rb) {
   VP9_COMMON *const cm = &pbi->common;
@@ -2696,10 +2918,14 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
       cm->frame_refs[i].buf = NULL;
     }
 
-    setup_frame_size(cm, rb);
+    setup_frame_size(pbi, rb);
     if (pbi->need_resync) {
-      memset(&cm->ref_frame_map, -1, sizeof(cm->ref_frame_map));
-      flush_all_fb_on_key(cm);
+      if (pbi->frame_parallel_decode) {
+        release_ref_frame_map(cm);
+      } else {
+        memset(&cm->ref_frame_map, -1, sizeof(cm->ref_frame_map));
+        flush_all_fb_on_key(cm);
+      }
       pbi->need_resync = 0;
     }
   } else {
@@ -2729,9 +2955,13 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
       }
 
       pbi->refresh_frame_flags = vpx_rb_read_literal(rb, REF_FRAMES);
-      setup_frame_size(cm, rb);
+      setup_frame_size(pbi, rb);
       if (pbi->need_resync) {
-        memset(&cm->ref_frame_map, -1, sizeof(cm->ref_frame_map));
+        if (pbi->frame_parallel_decode) {
+          release_ref_frame_map(cm);
+        } else {
+          memset(&cm->ref_frame_map, -1, sizeof(cm->ref_frame_map));
+        }
         pbi->need_resync = 0;
       }
     } else if (pbi->need_resync != 1) { /* Skip if need resync */
@@ -2750,7 +2980,7 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
         cm->ref_frame_sign_bias[LAST_FRAME + i] = vpx_rb_read_bit(rb);
       }
 
-      setup_frame_size_with_refs(cm, rb);
+      setup_frame_size_with_refs(pbi, rb);
 
       cm->allow_high_precision_mv = vpx_rb_read_bit(rb);
       cm->interp_filter = read_interp_filter(rb);
@@ -2823,6 +3053,7 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
     vp9_setup_past_independence(cm);
 
   setup_loopfilter(&cm->lf, rb);
+  setup_complexity(pbi);
   setup_quantization(cm, &pbi->mb, rb);
   setup_segmentation(&cm->seg, rb);
   setup_segmentation_dequant(cm);
@@ -2842,7 +3073,7 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
 #endif
     }
 
-    if (pbi->max_threads > 1) {
+    if (pbi->max_threads > 1 || pbi->frame_parallel_decode) {
       const int aligned_cols = mi_cols_aligned_to_sb(cm->mi_cols);
       const int sb_cols = aligned_cols >> MI_BLOCK_SIZE_LOG2;
 
@@ -3008,8 +3239,20 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
     vp9_loop_filter_frame_init(cm, cm->lf.filter_level);
   }
 
-  if (pbi->tile_worker_data == NULL ||
-      (tile_cols * tile_rows) != pbi->total_tiles) {
+  // Report the rows of the frame as the loop filter finishes them. Without
+  // the loop filter the rows are reported after reconstruction.
+  pbi->rows_ready = 0;
+  cm->lf.row_done_cb =
+      pbi->rows_ready_cb != NULL && cm->show_frame ? lf_row_done : NULL;
+  cm->lf.row_done_priv = pbi;
+
+  if (pbi->low_memory && pbi->max_threads <= 1 &&
+      !pbi->frame_parallel_decode) {
+    // The tile worker data is only used on this thread while the frame is
+    // decoded.
+    vp9_dec_borrow_tile_worker_data(pbi, tile_cols * tile_rows);
+  } else if (pbi->tile_worker_data == NULL ||
+             (tile_cols * tile_rows) != pbi->total_tiles) {
     const int num_tile_workers =
         tile_cols * tile_rows + ((pbi->max_threads > 1) ? pbi->max_threads : 0);
     const size_t twd_size = num_tile_workers * sizeof(*pbi->tile_worker_data);
@@ -3022,8 +3265,10 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
     pbi->total_tiles = tile_rows * tile_cols;
   }
 
-  if (pbi->max_threads > 1 && tile_rows == 1 &&
-      (tile_cols > 1 || pbi->row_mt == 1)) {
+  if (pbi->frame_parallel_decode) {
+    *p_data_end = parse_tiles(pbi, data + first_partition_size, data_end);
+  } else if (pbi->max_threads > 1 && tile_rows == 1 &&
+             (tile_cols > 1 || pbi->row_mt == 1)) {
     if (pbi->row_mt == 1) {
       *p_data_end =
           decode_tiles_row_wise_mt(pbi, data + first_partition_size, data_end);
@@ -3035,9 +3280,10 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
           if (!cm->skip_loop_filter) {
             // If multiple threads are used to decode tiles, then we use those
             // threads to do parallel loopfiltering.
-            vp9_loop_filter_frame_mt(
-                new_fb, cm, pbi->mb.plane, cm->lf.filter_level, 0, 0,
-                pbi->tile_workers, pbi->num_tile_workers, &pbi->lf_row_sync);
+            vp9_loop_filter_frame_mt(new_fb, cm, pbi->mb.plane,
+                                     cm->lf.filter_level, pbi->lf_y_only, 0,
+                                     pbi->tile_workers, pbi->num_tile_workers,
+                                     &pbi->lf_row_sync);
           }
         } else {
           vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
@@ -3063,6 +3309,8 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
                        "Decode failed. Frame data is corrupted.");
   }
 
+  if (!pbi->frame_parallel_decode) vp9_dec_rows_ready(pbi, cm->mi_rows);
+
   // Non frame parallel update frame context here.
   if (cm->refresh_frame_context && !context_updated)
     cm->frame_contexts[cm->frame_context_idx] = *cm->fc;
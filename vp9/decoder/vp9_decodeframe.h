@@ -28,6 +28,11 @@ BITSTREAM_PROFILE vp9_read_profile(struct vpx_read_bit_buffer *rb);
 void vp9_decode_frame(struct VP9Decoder *pbi, const uint8_t *data,
                       const uint8_t *data_end, const uint8_t **p_data_end);
 
+// In frame parallel decode vp9_decode_frame() only parses the frame. This
+// reconstructs and loop filters it, publishing the progress of every
+// superblock row on the frame buffer. Returns 0 on failure.
+int vp9_decode_frame_recon(struct VP9Decoder *pbi);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
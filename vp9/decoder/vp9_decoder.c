@@ -39,6 +39,21 @@
 #include "vp9/decoder/vp9_decoder.h"
 #include "vp9/decoder/vp9_detokenize.h"
 
+// Tile worker data borrowed by low memory decoders. Blocks are handed out
+// for one frame at a time and kept until the last decoder that used them is
+// removed.
+typedef struct SharedTileData {
+  TileWorkerData *data;
+  int num_tiles;
+  struct SharedTileData *next;
+} SharedTileData;
+
+static SharedTileData *free_shared_tile_data;
+static int num_shared_tile_data_users;
+#if CONFIG_MULTITHREAD
+static pthread_mutex_t shared_tile_data_mutex;
+#endif
+
 static void initialize_dec(void) {
   static volatile int init_done = 0;
 
@@ -47,10 +62,94 @@ static void initialize_dec(void) {
     vpx_dsp_rtcd();
     vpx_scale_rtcd();
     vp9_init_intra_predictors();
+#if CONFIG_MULTITHREAD
+    pthread_mutex_init(&shared_tile_data_mutex, NULL);
+#endif
     init_done = 1;
   }
 }
 
+static void lock_shared_tile_data(void) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&shared_tile_data_mutex);
+#endif
+}
+
+static void unlock_shared_tile_data(void) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(&shared_tile_data_mutex);
+#endif
+}
+
+void vp9_dec_borrow_tile_worker_data(VP9Decoder *pbi, int num_tiles) {
+  VP9_COMMON *const cm = &pbi->common;
+  SharedTileData **link;
+  SharedTileData *block;
+
+  assert(pbi->shared_tile_data == NULL);
+  lock_shared_tile_data();
+  if (!pbi->uses_shared_tile_data) {
+    pbi->uses_shared_tile_data = 1;
+    ++num_shared_tile_data_users;
+  }
+  // Prefer a block that is large enough.
+  link = &free_shared_tile_data;
+  while (*link != NULL && (*link)->num_tiles < num_tiles) link = &(*link)->next;
+  if (*link == NULL) link = &free_shared_tile_data;
+  block = *link;
+  if (block != NULL) *link = block->next;
+  unlock_shared_tile_data();
+
+  if (block == NULL) {
+    CHECK_MEM_ERROR(&cm->error, block,
+                    (SharedTileData *)vpx_calloc(1, sizeof(*block)));
+  }
+  pbi->shared_tile_data = block;
+  if (block->num_tiles < num_tiles) {
+    vpx_free(block->data);
+    block->num_tiles = 0;
+    CHECK_MEM_ERROR(&cm->error, block->data,
+                    vpx_memalign(32, num_tiles * sizeof(*block->data)));
+    block->num_tiles = num_tiles;
+  }
+  pbi->tile_worker_data = block->data;
+  pbi->total_tiles = num_tiles;
+  pbi->shared_tile_data_size =
+      sizeof(*block) + block->num_tiles * sizeof(*block->data);
+}
+
+void vp9_dec_return_tile_worker_data(VP9Decoder *pbi) {
+  SharedTileData *const block = pbi->shared_tile_data;
+  if (block == NULL) return;
+
+  pbi->shared_tile_data = NULL;
+  pbi->tile_worker_data = NULL;
+  pbi->total_tiles = 0;
+  lock_shared_tile_data();
+  block->next = free_shared_tile_data;
+  free_shared_tile_data = block;
+  unlock_shared_tile_data();
+}
+
+static void release_shared_tile_data(VP9Decoder *pbi) {
+  SharedTileData *block = NULL;
+
+  vp9_dec_return_tile_worker_data(pbi);
+  if (!pbi->uses_shared_tile_data) return;
+  lock_shared_tile_data();
+  if (--num_shared_tile_data_users == 0) {
+    block = free_shared_tile_data;
+    free_shared_tile_data = NULL;
+  }
+  unlock_shared_tile_data();
+  while (block != NULL) {
+    SharedTileData *const next = block->next;
+    vpx_free(block->data);
+    vpx_free(block);
+    block = next;
+  }
+}
+
 static void vp9_dec_setup_mi(VP9_COMMON *cm) {
   cm->mi = cm->mip + cm->mi_stride + 1;
   cm->mi_grid_visible = cm->mi_grid_base + cm->mi_stride + 1;
@@ -114,6 +213,35 @@ void vp9_dec_alloc_row_mt_mem(RowMTWorkerData *row_mt_worker_data,
   }
 }
 
+void vp9_dec_alloc_tile_workers(VP9Decoder *pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  const int num_threads = pbi->max_threads;
+  int n;
+
+  if (pbi->num_tile_workers != 0) return;
+
+  CHECK_MEM_ERROR(&cm->error, pbi->tile_workers,
+                  vpx_malloc(num_threads * sizeof(*pbi->tile_workers)));
+  for (n = 0; n < num_threads; ++n) {
+    VPxWorker *const worker = &pbi->tile_workers[n];
+    ++pbi->num_tile_workers;
+
+    winterface->init(worker);
+    worker->thread_name = "vpx tile worker";
+    worker->pool_client = pbi->pool_client;
+    if (n < num_threads - 1 && !winterface->reset(worker)) {
+      do {
+        winterface->end(&pbi->tile_workers[pbi->num_tile_workers - 1]);
+      } while (--pbi->num_tile_workers != 0);
+      vpx_free(pbi->tile_workers);
+      pbi->tile_workers = NULL;
+      vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
+                         "Tile decoder thread creation failed");
+    }
+  }
+}
+
 void vp9_dec_free_row_mt_mem(RowMTWorkerData *row_mt_worker_data) {
   if (row_mt_worker_data != NULL) {
     int plane;
@@ -149,6 +277,17 @@ void vp9_dec_free_row_mt_mem(RowMTWorkerData *row_mt_worker_data) {
   }
 }
 
+void vp9_dec_clear_row_mt_coeffs(RowMTWorkerData *row_mt_worker_data) {
+  const size_t dqcoeff_size =
+      ((size_t)row_mt_worker_data->num_sbs << DQCOEFFS_PER_SB_LOG2) *
+      sizeof(*row_mt_worker_data->dqcoeff[0]);
+  int plane;
+  for (plane = 0; plane < 3; ++plane) {
+    if (row_mt_worker_data->dqcoeff[plane] != NULL)
+      memset(row_mt_worker_data->dqcoeff[plane], 0, dqcoeff_size);
+  }
+}
+
 static int vp9_dec_alloc_mi(VP9_COMMON *cm, int mi_size) {
   cm->mip = vpx_calloc(mi_size, sizeof(*cm->mip));
   if (!cm->mip) return 1;
@@ -178,6 +317,9 @@ VP9Decoder *vp9_decoder_create(BufferPool *const pool) {
   if (!cm) return NULL;
 
   vp9_zero(*pbi);
+#if CONFIG_MULTITHREAD
+  pthread_mutex_init(&pbi->rows_ready_mutex, NULL);
+#endif
 
   if (setjmp(cm->error.jmp)) {
     cm->error.setjmp = 0;
@@ -203,6 +345,7 @@ VP9Decoder *vp9_decoder_create(BufferPool *const pool) {
   init_frame_indexes(cm);
   pbi->ready_for_new_data = 1;
   pbi->common.buffer_pool = pool;
+  pbi->frame_border = VP9_DEC_BORDER_IN_PIXELS;
 
   cm->bit_depth = VPX_BITS_8;
   cm->dequant_bit_depth = VPX_BITS_8;
@@ -218,6 +361,9 @@ VP9Decoder *vp9_decoder_create(BufferPool *const pool) {
   vpx_get_worker_interface()->init(&pbi->lf_worker);
   pbi->lf_worker.thread_name = "vpx lf worker";
 
+  vpx_get_worker_interface()->init(&pbi->frame_worker);
+  pbi->frame_worker.thread_name = "vpx frame worker";
+
   return pbi;
 }
 
@@ -226,6 +372,7 @@ void vp9_decoder_remove(VP9Decoder *pbi) {
 
   if (!pbi) return;
 
+  vpx_get_worker_interface()->end(&pbi->frame_worker);
   vpx_get_worker_interface()->end(&pbi->lf_worker);
   vpx_free(pbi->lf_worker.data1);
 
@@ -234,6 +381,7 @@ void vp9_decoder_remove(VP9Decoder *pbi) {
     vpx_get_worker_interface()->end(worker);
   }
 
+  release_shared_tile_data(pbi);
   vpx_free(pbi->tile_worker_data);
   vpx_free(pbi->tile_workers);
 
@@ -254,9 +402,80 @@ void vp9_decoder_remove(VP9Decoder *pbi) {
   }
 
   vp9_remove_common(&pbi->common);
+#if CONFIG_MULTITHREAD
+  pthread_mutex_destroy(&pbi->rows_ready_mutex);
+#endif
   vpx_free(pbi);
 }
 
+size_t vp9_dec_get_memory_usage(const VP9Decoder *pbi) {
+  const VP9_COMMON *const cm = &pbi->common;
+  const int aligned_mi_cols =
+      mi_cols_aligned_to_sb(cm->above_context_alloc_cols);
+  size_t size = sizeof(*pbi);
+
+  if (cm->fc != NULL) size += sizeof(*cm->fc);
+  if (cm->frame_contexts != NULL)
+    size += FRAME_CONTEXTS * sizeof(*cm->frame_contexts);
+  size += cm->mi_alloc_size * (sizeof(*cm->mip) + sizeof(*cm->mi_grid_base));
+  size += NUM_PING_PONG_BUFFERS * (size_t)cm->seg_map_alloc_size;
+  size += aligned_mi_cols * (2 * MAX_MB_PLANE * sizeof(*cm->above_context) +
+                             sizeof(*cm->above_seg_context));
+  if (cm->lf.lfm != NULL) {
+    size += ((cm->mi_rows + (MI_BLOCK_SIZE - 1)) >> 3) * cm->lf.lfm_stride *
+            sizeof(*cm->lf.lfm);
+  }
+
+  if (pbi->lf_worker.data1 != NULL) size += sizeof(LFWorkerData);
+  size += pbi->num_tile_workers * sizeof(*pbi->tile_workers);
+  if (pbi->shared_tile_data != NULL || pbi->uses_shared_tile_data) {
+    size += pbi->shared_tile_data_size;
+  } else if (pbi->tile_worker_data != NULL) {
+    const int num_tile_workers =
+        pbi->total_tiles + (pbi->max_threads > 1 ? pbi->max_threads : 0);
+    size += num_tile_workers * sizeof(*pbi->tile_worker_data);
+  }
+  if (pbi->lf_row_sync.lfdata != NULL) {
+    const VP9LfSync *const lf_sync = &pbi->lf_row_sync;
+    size += lf_sync->num_workers * sizeof(*lf_sync->lfdata);
+    size += lf_sync->rows * (sizeof(*lf_sync->cur_sb_col) +
+                             sizeof(*lf_sync->num_tiles_done));
+#if CONFIG_MULTITHREAD
+    size += lf_sync->rows *
+            (2 * sizeof(*lf_sync->mutex) + 2 * sizeof(*lf_sync->cond));
+#endif
+  }
+
+  if (pbi->row_mt_worker_data != NULL) {
+    const RowMTWorkerData *const row_mt = pbi->row_mt_worker_data;
+    const size_t num_sbs = row_mt->num_sbs;
+    size += sizeof(*row_mt) + row_mt->jobq_size;
+    if (row_mt->dqcoeff[0] != NULL) {
+      size += MAX_MB_PLANE * ((num_sbs << DQCOEFFS_PER_SB_LOG2) *
+                                  sizeof(*row_mt->dqcoeff[0]) +
+                              (num_sbs << EOBS_PER_SB_LOG2) *
+                                  sizeof(*row_mt->eob[0]));
+      size += num_sbs * (PARTITIONS_PER_SB * sizeof(*row_mt->partition) +
+                         sizeof(*row_mt->recon_map));
+    }
+    if (row_mt->thread_data != NULL)
+      size += pbi->max_threads * sizeof(*row_mt->thread_data);
+#if CONFIG_MULTITHREAD
+    size += row_mt->num_jobs * (sizeof(*row_mt->recon_sync_mutex) +
+                                sizeof(*row_mt->recon_sync_cond));
+#endif
+  }
+
+#if CONFIG_VP9_POSTPROC
+  size += cm->post_proc_buffer.buffer_alloc_sz;
+  size += cm->post_proc_buffer_int.buffer_alloc_sz;
+  size += cm->postproc_state.prev_mip_size * sizeof(*cm->mip);
+  size += cm->postproc_state.limits_size;
+  size += cm->postproc_state.generated_noise_size;
+#endif
+  return size;
+}
+
 static int equal_dimensions(const YV12_BUFFER_CONFIG *a,
                             const YV12_BUFFER_CONFIG *b) {
   return a->y_height == b->y_height && a->y_width == b->y_width &&
@@ -369,9 +588,174 @@ static void swap_frame_buffers(VP9Decoder *pbi) {
 
   --frame_bufs[cm->new_fb_idx].ref_count;
 
-  // Invalidate these references until the next frame starts.
-  for (ref_index = 0; ref_index < 3; ref_index++)
-    cm->frame_refs[ref_index].idx = -1;
+  // Invalidate these references until the next frame starts. In frame
+  // parallel decode the frame worker still uses them; they are invalidated by
+  // vp9_frame_worker_sync().
+  if (!pbi->frame_worker_busy) {
+    for (ref_index = 0; ref_index < 3; ref_index++)
+      cm->frame_refs[ref_index].idx = -1;
+  }
+}
+
+static int frame_worker_hook(void *arg1, void *arg2) {
+  VP9Decoder *const pbi = (VP9Decoder *)arg1;
+  (void)arg2;
+  return vp9_decode_frame_recon(pbi);
+}
+
+// Frame parallel decode: holds the new frame buffer and the references of the
+// frame for the frame worker, as swap_frame_buffers() may drop them from the
+// reference map before the worker is done with them.
+static void hold_frame_worker_bufs(VP9Decoder *pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+  RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
+  int i;
+
+  ++frame_bufs[cm->new_fb_idx].ref_count;
+  for (i = 0; i < REFS_PER_FRAME; ++i) {
+    RefBuffer *const ref_buf = &cm->frame_refs[i];
+    if (frame_is_intra_only(cm))
+      ref_buf->idx = INVALID_IDX;
+    else
+      ++frame_bufs[ref_buf->idx].ref_count;
+  }
+#if CONFIG_MULTITHREAD
+  // No frame can reference the new buffer yet, so its progress is reset
+  // without waking anyone up.
+  vpx_atomic_store_release(&pbi->cur_buf->row, 0);
+#endif
+  pbi->frame_worker_busy = 1;
+}
+
+int vp9_frame_worker_sync(VP9Decoder *pbi) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  VP9_COMMON *const cm = &pbi->common;
+  BufferPool *const pool = cm->buffer_pool;
+  int i, ok;
+
+  if (!pbi->frame_worker_busy) return 1;
+
+  ok = winterface->sync(&pbi->frame_worker);
+  pbi->frame_worker.had_error = 0;
+
+  decrease_ref_count(cm->new_fb_idx, pool->frame_bufs, pool);
+  for (i = 0; i < REFS_PER_FRAME; ++i) {
+    decrease_ref_count(cm->frame_refs[i].idx, pool->frame_bufs, pool);
+    cm->frame_refs[i].idx = INVALID_IDX;
+  }
+  pbi->frame_worker_busy = 0;
+  return ok;
+}
+
+vpx_codec_err_t vp9_frame_worker_copy_context(VP9Decoder *dst,
+                                              const VP9Decoder *src) {
+  VP9_COMMON *const dst_cm = &dst->common;
+  const VP9_COMMON *const src_cm = &src->common;
+  LOOP_FILTER_MASK *lfm;
+  int lfm_stride;
+
+  assert(!dst->frame_worker_busy);
+
+  // Match the frame size of 'src' so the segmentation map of the previous
+  // frame is carried over, and reset, as it would be by a single decoder.
+  if (src_cm->width != 0 &&
+      (dst_cm->width != src_cm->width || dst_cm->height != src_cm->height)) {
+    if (vp9_alloc_context_buffers(dst_cm, src_cm->width, src_cm->height)) {
+      dst_cm->width = 0;
+      dst_cm->height = 0;
+      return VPX_CODEC_MEM_ERROR;
+    }
+    vp9_init_context_buffers(dst_cm);
+    dst_cm->width = src_cm->width;
+    dst_cm->height = src_cm->height;
+  }
+  if (src_cm->last_frame_seg_map != NULL && src_cm->width != 0) {
+    memcpy(dst_cm->last_frame_seg_map, src_cm->last_frame_seg_map,
+           src_cm->mi_rows * src_cm->mi_cols);
+  }
+
+  lfm = dst_cm->lf.lfm;
+  lfm_stride = dst_cm->lf.lfm_stride;
+  dst->need_resync = src->need_resync;
+  dst_cm->profile = src_cm->profile;
+  dst_cm->bit_depth = src_cm->bit_depth;
+#if CONFIG_VP9_HIGHBITDEPTH
+  dst_cm->use_highbitdepth = src_cm->use_highbitdepth;
+#endif
+  dst_cm->subsampling_x = src_cm->subsampling_x;
+  dst_cm->subsampling_y = src_cm->subsampling_y;
+  dst_cm->color_space = src_cm->color_space;
+  dst_cm->color_range = src_cm->color_range;
+  dst_cm->last_width = src_cm->last_width;
+  dst_cm->last_height = src_cm->last_height;
+  dst_cm->last_show_frame = src_cm->last_show_frame;
+  dst_cm->prev_frame = src_cm->prev_frame;
+  dst_cm->frame_type = src_cm->frame_type;
+  dst_cm->intra_only = src_cm->intra_only;
+  dst_cm->current_video_frame = src_cm->current_video_frame;
+  dst_cm->cur_show_frame_fb_idx = src_cm->cur_show_frame_fb_idx;
+  memcpy(dst_cm->ref_frame_map, src_cm->ref_frame_map,
+         sizeof(dst_cm->ref_frame_map));
+  memcpy(dst_cm->ref_frame_sign_bias, src_cm->ref_frame_sign_bias,
+         sizeof(dst_cm->ref_frame_sign_bias));
+  memcpy(dst_cm->frame_contexts, src_cm->frame_contexts,
+         FRAME_CONTEXTS * sizeof(*dst_cm->frame_contexts));
+  dst_cm->seg = src_cm->seg;
+  dst_cm->lf = src_cm->lf;
+  dst_cm->lf.lfm = lfm;
+  dst_cm->lf.lfm_stride = lfm_stride;
+  dst_cm->lf_info = src_cm->lf_info;
+  return VPX_CODEC_OK;
+}
+
+void vp9_frameworker_wait(BufferPool *const pool, RefCntBuffer *const ref_buf,
+                          int row) {
+#if CONFIG_MULTITHREAD
+  if (vpx_atomic_load_acquire(&ref_buf->row) >= row) return;
+
+  pthread_mutex_lock(&pool->row_mutex);
+  while (vpx_atomic_load_acquire(&ref_buf->row) < row) {
+    pthread_cond_wait(&pool->row_cond, &pool->row_mutex);
+  }
+  pthread_mutex_unlock(&pool->row_mutex);
+#else
+  (void)pool;
+  (void)ref_buf;
+  (void)row;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void vp9_frameworker_broadcast(BufferPool *const pool, RefCntBuffer *const buf,
+                               int row) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&pool->row_mutex);
+  vpx_atomic_store_release(&buf->row, row);
+  pthread_cond_broadcast(&pool->row_cond);
+  pthread_mutex_unlock(&pool->row_mutex);
+#else
+  (void)pool;
+  (void)buf;
+  (void)row;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void vp9_dec_rows_ready(VP9Decoder *pbi, int mi_row) {
+  const VP9_COMMON *const cm = &pbi->common;
+  const int row_end = VPXMIN(mi_row * MI_SIZE, cm->height);
+
+  if (pbi->rows_ready_cb == NULL || !cm->show_frame) return;
+
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&pbi->rows_ready_mutex);
+#endif
+  if (row_end > pbi->rows_ready) {
+    pbi->rows_ready_cb(pbi->rows_ready_priv, pbi->cur_buf, pbi->rows_ready,
+                       row_end);
+    pbi->rows_ready = row_end;
+  }
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(&pbi->rows_ready_mutex);
+#endif
 }
 
 static void release_fb_on_decoder_exit(VP9Decoder *pbi) {
@@ -396,8 +780,10 @@ static void release_fb_on_decoder_exit(VP9Decoder *pbi) {
       // Current thread releases the holding of reference frame.
       decrease_ref_count(old_idx, frame_bufs, pool);
 
-      // Release the reference frame in reference map.
-      if (mask & 1) {
+      // Release the reference frame in reference map. In frame parallel
+      // decode the reference map keeps its references until the next resync,
+      // as frames in flight may still use them.
+      if ((mask & 1) && !pbi->frame_parallel_decode) {
         decrease_ref_count(old_idx, frame_bufs, pool);
       }
       ++ref_index;
@@ -469,12 +855,22 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
     release_fb_on_decoder_exit(pbi);
     // Release current frame.
     decrease_ref_count(cm->new_fb_idx, frame_bufs, pool);
+    // The coefficients parsed so far are left behind, as the frame is not
+    // reconstructed.
+    if (pbi->frame_parallel_decode && pbi->row_mt_worker_data != NULL)
+      vp9_dec_clear_row_mt_coeffs(pbi->row_mt_worker_data);
+    vp9_dec_return_tile_worker_data(pbi);
+    pbi->memory_usage = vp9_dec_get_memory_usage(pbi);
     vpx_clear_system_state();
     return -1;
   }
 
   cm->error.setjmp = 1;
   vp9_decode_frame(pbi, source, source + size, psource);
+  vp9_dec_return_tile_worker_data(pbi);
+
+  if (pbi->frame_parallel_decode && !cm->show_existing_frame)
+    hold_frame_worker_bufs(pbi);
 
   swap_frame_buffers(pbi);
 
@@ -496,6 +892,15 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
   }
 
   cm->error.setjmp = 0;
+  pbi->memory_usage = vp9_dec_get_memory_usage(pbi);
+
+  if (pbi->frame_worker_busy) {
+    VPxWorker *const worker = &pbi->frame_worker;
+    worker->hook = frame_worker_hook;
+    worker->data1 = pbi;
+    worker->data2 = NULL;
+    vpx_get_worker_interface()->launch(worker);
+  }
   return retcode;
 }
 
@@ -526,7 +931,14 @@ int vp9_get_raw_frame(VP9Decoder *pbi, YV12_BUFFER_CONFIG *sd,
   cm->error.setjmp = 1;
 
   if (!cm->show_existing_frame) {
-    ret = vp9_post_proc_frame(cm, sd, flags, cm->width);
+    // Post-processing runs on the tile workers, which are idle once the
+    // frame has been decoded.
+    if (pbi->max_threads > 1 && flags->post_proc_flag) {
+      vp9_dec_alloc_tile_workers(pbi);
+    }
+    ret = vp9_post_proc_frame_mt(cm, sd, flags, cm->width, pbi->tile_workers,
+                                 pbi->num_tile_workers);
+    pbi->memory_usage = vp9_dec_get_memory_usage(pbi);
   } else {
     *sd = *cm->frame_to_show;
     ret = 0;
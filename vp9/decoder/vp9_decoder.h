@@ -92,6 +92,16 @@ typedef struct Job {
   JobType job_type;
 } Job;
 
+// Called with the luma rows [row_start, row_end) of 'buf' once they are
+// final.
+typedef void (*vp9_rows_ready_cb_fn_t)(void *priv, const RefCntBuffer *buf,
+                                       int row_start, int row_end);
+
+// Highest level of VP9D_SET_COMPLEXITY_LEVEL.
+#define VP9_MAX_COMPLEXITY_LEVEL 4
+
+struct SharedTileData;
+
 typedef struct VP9Decoder {
   DECLARE_ALIGNED(16, MACROBLOCKD, mb);
 
@@ -125,6 +135,54 @@ typedef struct VP9Decoder {
   int row_mt;
   int lpf_mt_opt;
   RowMTWorkerData *row_mt_worker_data;
+
+  // Frame parallel decode. The frame is parsed by vp9_receive_compressed_data()
+  // and reconstructed on frame_worker, which keeps the new frame buffer and
+  // its references held until vp9_frame_worker_sync().
+  int frame_parallel_decode;
+  VPxWorker frame_worker;
+  int frame_worker_busy;
+
+  // If not NULL, all workers run on this shared thread pool.
+  VPxThreadPoolClient *pool_client;
+
+  // If set, the rows of shown frames are reported as they are decoded.
+  // rows_ready is the number of luma rows of the frame reported so far.
+  vp9_rows_ready_cb_fn_t rows_ready_cb;
+  void *rows_ready_priv;
+  int rows_ready;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t rows_ready_mutex;
+#endif
+
+  // If set, frames are only decoded for the state they leave for later
+  // frames. Frames that refresh no reference are not loop filtered.
+  int references_only;
+
+  // VP9_SET_SKIP_LOOP_FILTER and VP9D_SET_COMPLEXITY_LEVEL, which set
+  // common.skip_loop_filter, lf_y_only and bilinear_prediction for each frame.
+  int skip_loop_filter;
+  int complexity_level;
+  int lf_y_only;
+  int bilinear_prediction;
+
+  // Border of the frame buffers, in pixels. The decoder builds the border of
+  // any block it predicts from outside of a reference frame, so it only needs
+  // one for post-processing. VP9_DEC_BORDER_IN_PIXELS by default.
+  int frame_border;
+
+  // Low memory mode: when decoding on the calling thread, the tile worker
+  // data is borrowed from a cache shared by all decoders for the duration of
+  // each frame. shared_tile_data_size is the size of the data borrowed for
+  // the last frame.
+  int low_memory;
+  int uses_shared_tile_data;
+  struct SharedTileData *shared_tile_data;
+  size_t shared_tile_data_size;
+
+  // vp9_dec_get_memory_usage() as of the last decoded or output frame. Unlike
+  // the function, it can be read while the frame worker is busy.
+  size_t memory_usage;
 } VP9Decoder;
 
 int vp9_receive_compressed_data(struct VP9Decoder *pbi, size_t size,
@@ -133,6 +191,42 @@ int vp9_receive_compressed_data(struct VP9Decoder *pbi, size_t size,
 int vp9_get_raw_frame(struct VP9Decoder *pbi, YV12_BUFFER_CONFIG *sd,
                       vp9_ppflags_t *flags);
 
+// Frame parallel decode: waits for the frame worker of 'pbi' and releases the
+// frame buffers it held. Returns 0 if the frame failed to reconstruct.
+int vp9_frame_worker_sync(struct VP9Decoder *pbi);
+
+// Frame parallel decode: copies the decoder state carried from one frame to
+// the next from 'src', the decoder instance that parsed the previous frame.
+vpx_codec_err_t vp9_frame_worker_copy_context(struct VP9Decoder *dst,
+                                              const struct VP9Decoder *src);
+
+// Frame parallel decode: blocks until the first 'row' luma rows of 'ref_buf'
+// are final.
+void vp9_frameworker_wait(BufferPool *const pool, RefCntBuffer *const ref_buf,
+                          int row);
+
+// Frame parallel decode: marks the first 'row' luma rows of 'buf' as final
+// and wakes up the frames waiting on them.
+void vp9_frameworker_broadcast(BufferPool *const pool, RefCntBuffer *const buf,
+                               int row);
+
+// Reports the rows above 'mi_row' of the frame being decoded to
+// rows_ready_cb, if set. Rows are reported once, in order, and may come from
+// any decoding thread.
+void vp9_dec_rows_ready(struct VP9Decoder *pbi, int mi_row);
+
+// Low memory mode: points pbi->tile_worker_data at data for 'num_tiles' tiles
+// borrowed from the shared cache, until vp9_dec_return_tile_worker_data().
+void vp9_dec_borrow_tile_worker_data(struct VP9Decoder *pbi, int num_tiles);
+
+// Returns the tile worker data borrowed by 'pbi', if any, to the shared cache.
+void vp9_dec_return_tile_worker_data(struct VP9Decoder *pbi);
+
+// Returns the number of bytes allocated by 'pbi', including the tile worker
+// data it borrowed for the last frame. Frame buffers, which belong to the
+// BufferPool, are not included.
+size_t vp9_dec_get_memory_usage(const struct VP9Decoder *pbi);
+
 vpx_codec_err_t vp9_copy_reference_dec(struct VP9Decoder *pbi,
                                        VP9_REFFRAME ref_frame_flag,
                                        YV12_BUFFER_CONFIG *sd);
@@ -162,11 +256,19 @@ struct VP9Decoder *vp9_decoder_create(BufferPool *const pool);
 
 void vp9_decoder_remove(struct VP9Decoder *pbi);
 
+// Creates pbi->max_threads tile workers if they do not exist yet. The last
+// worker has no thread of its own and is run with execute().
+void vp9_dec_alloc_tile_workers(VP9Decoder *pbi);
+
 void vp9_dec_alloc_row_mt_mem(RowMTWorkerData *row_mt_worker_data,
                               VP9_COMMON *cm, int num_sbs, int max_threads,
                               int num_jobs);
 void vp9_dec_free_row_mt_mem(RowMTWorkerData *row_mt_worker_data);
 
+// Zeroes the coefficients of a frame that was parsed but not (fully)
+// reconstructed, as reconstruction is what clears them for the next frame.
+void vp9_dec_clear_row_mt_coeffs(RowMTWorkerData *row_mt_worker_data);
+
 static INLINE void decrease_ref_count(int idx, RefCntBuffer *const frame_bufs,
                                       BufferPool *const pool) {
   if (idx >= 0 && frame_bufs[idx].ref_count > 0) {
@@ -12,114 +12,171 @@
 #include <string.h>
 
 #include "vpx/vpx_integer.h"
+#include "vpx_util/vpx_atomics.h"
 #include "vpx_util/vpx_pthread.h"
 
 #include "vp9/decoder/vp9_job_queue.h"
 
-void vp9_jobq_init(JobQueueRowMt *jobq, uint8_t *buf, size_t buf_size) {
 #if CONFIG_MULTITHREAD
+// Number of times an empty queue is polled before a blocking dequeue goes to
+// sleep on the condition variable.
+#define JOBQ_SPIN_COUNT 256
+
+void vp9_jobq_init(JobQueueRowMt *jobq, uint8_t *buf, size_t buf_size) {
+  assert(buf_size <= INT32_MAX);
   pthread_mutex_init(&jobq->mutex, NULL);
   pthread_cond_init(&jobq->cond, NULL);
-#endif
   jobq->buf_base = buf;
-  jobq->buf_wr = buf;
-  jobq->buf_rd = buf;
   jobq->buf_end = buf + buf_size;
-  jobq->terminate = 0;
+  vpx_atomic_init(&jobq->wr_claim, 0);
+  vpx_atomic_init(&jobq->wr_commit, 0);
+  vpx_atomic_init(&jobq->rd, 0);
+  vpx_atomic_init(&jobq->num_waiters, 0);
+  vpx_atomic_init(&jobq->terminate, 0);
 }
 
+// Must only be called while no thread is accessing the queue.
 void vp9_jobq_reset(JobQueueRowMt *jobq) {
-#if CONFIG_MULTITHREAD
   pthread_mutex_lock(&jobq->mutex);
-#endif
-  jobq->buf_wr = jobq->buf_base;
-  jobq->buf_rd = jobq->buf_base;
-  jobq->terminate = 0;
-#if CONFIG_MULTITHREAD
+  vpx_atomic_store_release(&jobq->wr_claim, 0);
+  vpx_atomic_store_release(&jobq->wr_commit, 0);
+  vpx_atomic_store_release(&jobq->rd, 0);
+  vpx_atomic_store_release(&jobq->terminate, 0);
   pthread_mutex_unlock(&jobq->mutex);
-#endif
 }
 
 void vp9_jobq_deinit(JobQueueRowMt *jobq) {
   vp9_jobq_reset(jobq);
-#if CONFIG_MULTITHREAD
   pthread_mutex_destroy(&jobq->mutex);
   pthread_cond_destroy(&jobq->cond);
-#endif
 }
 
 void vp9_jobq_terminate(JobQueueRowMt *jobq) {
-#if CONFIG_MULTITHREAD
   pthread_mutex_lock(&jobq->mutex);
-#endif
-  jobq->terminate = 1;
-#if CONFIG_MULTITHREAD
+  vpx_atomic_store_release(&jobq->terminate, 1);
   pthread_cond_broadcast(&jobq->cond);
   pthread_mutex_unlock(&jobq->mutex);
-#endif
 }
 
 int vp9_jobq_queue(JobQueueRowMt *jobq, void *job, size_t job_size) {
-  int ret = 0;
-#if CONFIG_MULTITHREAD
-  pthread_mutex_lock(&jobq->mutex);
-#endif
-  if (jobq->buf_end >= jobq->buf_wr + job_size) {
-    memcpy(jobq->buf_wr, job, job_size);
-    jobq->buf_wr = jobq->buf_wr + job_size;
-#if CONFIG_MULTITHREAD
+  const int buf_size = (int)(jobq->buf_end - jobq->buf_base);
+  int wr;
+
+  // Claim space for the job.
+  do {
+    wr = vpx_atomic_load_acquire(&jobq->wr_claim);
+    if (wr + (int)job_size > buf_size) {
+      /* Wrap around case is not supported */
+      assert(0);
+      return 1;
+    }
+  } while (!vpx_atomic_compare_exchange(&jobq->wr_claim, wr,
+                                        wr + (int)job_size));
+
+  memcpy(jobq->buf_base + wr, job, job_size);
+
+  // Publish the job once all earlier claims have been published. The window
+  // between claim and publish is a single memcpy so this rarely spins.
+  while (!vpx_atomic_compare_exchange(&jobq->wr_commit, wr,
+                                      wr + (int)job_size)) {
+  }
+
+  // The publish above and this read are both full barriers, so either a
+  // consumer about to sleep sees the new job or it is counted here.
+  if (vpx_atomic_fetch_add(&jobq->num_waiters, 0) > 0) {
+    pthread_mutex_lock(&jobq->mutex);
     pthread_cond_signal(&jobq->cond);
-#endif
-    ret = 0;
-  } else {
-    /* Wrap around case is not supported */
-    assert(0);
-    ret = 1;
+    pthread_mutex_unlock(&jobq->mutex);
   }
-#if CONFIG_MULTITHREAD
-  pthread_mutex_unlock(&jobq->mutex);
-#endif
-  return ret;
+  return 0;
 }
 
 int vp9_jobq_dequeue(JobQueueRowMt *jobq, void *job, size_t job_size,
                      int blocking) {
-  int ret = 0;
-#if CONFIG_MULTITHREAD
-  pthread_mutex_lock(&jobq->mutex);
-#endif
-  if (jobq->buf_end >= jobq->buf_rd + job_size) {
-    while (1) {
-      if (jobq->buf_wr >= jobq->buf_rd + job_size) {
-        memcpy(job, jobq->buf_rd, job_size);
-        jobq->buf_rd = jobq->buf_rd + job_size;
-        ret = 0;
-        break;
-      } else {
-        /* If all the entries have been dequeued, then break and return */
-        if (jobq->terminate == 1) {
-          ret = 1;
-          break;
-        }
-        if (blocking == 1) {
-#if CONFIG_MULTITHREAD
-          pthread_cond_wait(&jobq->cond, &jobq->mutex);
-#endif
-        } else {
-          /* If there is no job available,
-           * and this is non blocking call then return fail */
-          ret = 1;
-          break;
-        }
+  const int buf_size = (int)(jobq->buf_end - jobq->buf_base);
+  int spin = 0;
+
+  while (1) {
+    const int rd = vpx_atomic_load_acquire(&jobq->rd);
+    /* Wrap around case is not supported */
+    if (rd + (int)job_size > buf_size) return 1;
+
+    if (vpx_atomic_load_acquire(&jobq->wr_commit) >= rd + (int)job_size) {
+      if (vpx_atomic_compare_exchange(&jobq->rd, rd, rd + (int)job_size)) {
+        // Jobs are never overwritten before the next reset.
+        memcpy(job, jobq->buf_base + rd, job_size);
+        return 0;
       }
+      // Another consumer took this job, try the next one.
+      continue;
     }
-  } else {
+
+    /* If all the entries have been dequeued, then break and return */
+    if (vpx_atomic_load_acquire(&jobq->terminate)) return 1;
+
+    /* If there is no job available,
+     * and this is non blocking call then return fail */
+    if (!blocking) return 1;
+
+    if (spin < JOBQ_SPIN_COUNT) {
+      ++spin;
+      continue;
+    }
+
+    pthread_mutex_lock(&jobq->mutex);
+    vpx_atomic_fetch_add(&jobq->num_waiters, 1);
+    // Re-check with a full barrier now that producers will see the waiter.
+    if (vpx_atomic_fetch_add(&jobq->wr_commit, 0) <
+            vpx_atomic_load_acquire(&jobq->rd) + (int)job_size &&
+        !vpx_atomic_load_acquire(&jobq->terminate)) {
+      pthread_cond_wait(&jobq->cond, &jobq->mutex);
+    }
+    vpx_atomic_fetch_add(&jobq->num_waiters, -1);
+    pthread_mutex_unlock(&jobq->mutex);
+    spin = 0;
+  }
+}
+#else
+void vp9_jobq_init(JobQueueRowMt *jobq, uint8_t *buf, size_t buf_size) {
+  jobq->buf_base = buf;
+  jobq->buf_wr = buf;
+  jobq->buf_rd = buf;
+  jobq->buf_end = buf + buf_size;
+  jobq->terminate = 0;
+}
+
+void vp9_jobq_reset(JobQueueRowMt *jobq) {
+  jobq->buf_wr = jobq->buf_base;
+  jobq->buf_rd = jobq->buf_base;
+  jobq->terminate = 0;
+}
+
+void vp9_jobq_deinit(JobQueueRowMt *jobq) { vp9_jobq_reset(jobq); }
+
+void vp9_jobq_terminate(JobQueueRowMt *jobq) { jobq->terminate = 1; }
+
+int vp9_jobq_queue(JobQueueRowMt *jobq, void *job, size_t job_size) {
+  if (jobq->buf_end < jobq->buf_wr + job_size) {
     /* Wrap around case is not supported */
-    ret = 1;
+    assert(0);
+    return 1;
   }
-#if CONFIG_MULTITHREAD
-  pthread_mutex_unlock(&jobq->mutex);
-#endif
+  memcpy(jobq->buf_wr, job, job_size);
+  jobq->buf_wr += job_size;
+  return 0;
+}
 
-  return ret;
+int vp9_jobq_dequeue(JobQueueRowMt *jobq, void *job, size_t job_size,
+                     int blocking) {
+  (void)blocking;
+  /* Without threads nothing can add a job while waiting, so fail instead of
+   * blocking on an empty queue. */
+  if (jobq->buf_end < jobq->buf_rd + job_size ||
+      jobq->buf_wr < jobq->buf_rd + job_size) {
+    return 1;
+  }
+  memcpy(job, jobq->buf_rd, job_size);
+  jobq->buf_rd += job_size;
+  return 0;
 }
+#endif  // CONFIG_MULTITHREAD
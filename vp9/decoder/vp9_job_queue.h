@@ -11,26 +11,46 @@
 #ifndef VPX_VP9_DECODER_VP9_JOB_QUEUE_H_
 #define VPX_VP9_DECODER_VP9_JOB_QUEUE_H_
 
+#include "vpx_util/vpx_atomics.h"
 #include "vpx_util/vpx_pthread.h"
 
+// Multi-producer, multi-consumer FIFO of fixed size jobs. Jobs are added and
+// removed without taking a lock; the mutex and condition variable are only
+// used to park threads that find the queue empty. The buffer does not wrap, it
+// must be large enough for every job queued between two resets.
 typedef struct {
   // Pointer to buffer base which contains the jobs
   uint8_t *buf_base;
 
-  // Pointer to current address where new job can be added
-  uint8_t *volatile buf_wr;
-
-  // Pointer to current address from where next job can be obtained
-  uint8_t *volatile buf_rd;
-
   // Pointer to end of job buffer
   uint8_t *buf_end;
 
-  int terminate;
-
 #if CONFIG_MULTITHREAD
+  // Byte offset up to which space has been claimed by producers.
+  vpx_atomic_int wr_claim;
+
+  // Byte offset up to which jobs are fully written and may be consumed.
+  // Producers publish their jobs in the order the space was claimed.
+  vpx_atomic_int wr_commit;
+
+  // Byte offset of the next job to be consumed.
+  vpx_atomic_int rd;
+
+  // Number of consumers sleeping on (or about to sleep on) cond.
+  vpx_atomic_int num_waiters;
+
+  vpx_atomic_int terminate;
+
   pthread_mutex_t mutex;
   pthread_cond_t cond;
+#else
+  // Pointer to current address where new job can be added
+  uint8_t *buf_wr;
+
+  // Pointer to current address from where next job can be obtained
+  uint8_t *buf_rd;
+
+  int terminate;
 #endif
 } JobQueueRowMt;
 
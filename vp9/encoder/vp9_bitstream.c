@@ -986,6 +986,8 @@ static size_t encode_tiles_buffer_alloc_size(const VP9_COMP *cpi) {
   return (size_t)size;
 }
 
+// Allocates the worker data, and the output buffers of the workers unless
+// 'buffer_alloc_size' is 0.
 static void encode_tiles_buffer_alloc(VP9_COMP *const cpi,
                                       size_t buffer_alloc_size) {
   VP9_COMMON *const cm = &cpi->common;
@@ -995,6 +997,7 @@ static void encode_tiles_buffer_alloc(VP9_COMP *const cpi,
   CHECK_MEM_ERROR(&cm->error, cpi->vp9_bitstream_worker_data,
                   vpx_memalign(16, worker_data_size));
   memset(cpi->vp9_bitstream_worker_data, 0, worker_data_size);
+  if (buffer_alloc_size == 0) return;
   for (i = 1; i < cpi->num_workers; ++i) {
     CHECK_MEM_ERROR(&cm->error, cpi->vp9_bitstream_worker_data[i].dest,
                     vpx_malloc(buffer_alloc_size));
@@ -1103,6 +1106,240 @@ static size_t encode_tiles_mt(VP9_COMP *cpi, uint8_t *data_ptr,
   return total_size;
 }
 
+void vp9_bitstream_row_mt_dealloc(VP9_COMP *const cpi) {
+  VP9BitstreamRowMT *const row_mt = cpi->vp9_bitstream_row_mt;
+  if (row_mt) {
+    int i;
+    if (row_mt->rows) {
+      for (i = 0; i < row_mt->tile_cols * row_mt->sb_rows; ++i) {
+        vpx_free(row_mt->rows[i].symbols);
+      }
+      vpx_free(row_mt->rows);
+    }
+    for (i = 0; i < row_mt->tile_cols; ++i) {
+      vp9_row_mt_sync_mem_dealloc(&row_mt->row_mt_sync[i]);
+    }
+#if CONFIG_MULTITHREAD
+    pthread_mutex_destroy(&row_mt->mutex);
+#endif
+    vpx_free(row_mt);
+    cpi->vp9_bitstream_row_mt = NULL;
+  }
+}
+
+static void bitstream_row_mt_alloc(VP9_COMP *const cpi, int sb_rows,
+                                   int tile_cols) {
+  VP9_COMMON *const cm = &cpi->common;
+  // The symbol arrays grow as needed and are kept from frame to frame. Start
+  // with room for 256 symbols per superblock.
+  const int row_symbols =
+      256 * (mi_cols_aligned_to_sb(cm->mi_cols) >> MI_BLOCK_SIZE_LOG2);
+  VP9BitstreamRowMT *row_mt = cpi->vp9_bitstream_row_mt;
+  int i;
+
+  if (row_mt) {
+    if (row_mt->sb_rows == sb_rows && row_mt->tile_cols == tile_cols) return;
+    vp9_bitstream_row_mt_dealloc(cpi);
+  }
+
+  CHECK_MEM_ERROR(&cm->error, row_mt, vpx_calloc(1, sizeof(*row_mt)));
+  cpi->vp9_bitstream_row_mt = row_mt;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_init(&row_mt->mutex, NULL);
+#endif
+  row_mt->sb_rows = sb_rows;
+  row_mt->tile_cols = tile_cols;
+  CHECK_MEM_ERROR(&cm->error, row_mt->rows,
+                  vpx_calloc(tile_cols * sb_rows, sizeof(*row_mt->rows)));
+  for (i = 0; i < tile_cols * sb_rows; ++i) {
+    vpx_writer *const w = &row_mt->rows[i];
+    CHECK_MEM_ERROR(&cm->error, w->symbols,
+                    vpx_malloc(row_symbols * sizeof(*w->symbols)));
+    w->size = row_symbols;
+  }
+  for (i = 0; i < tile_cols; ++i) {
+    vp9_row_mt_sync_mem_alloc(&row_mt->row_mt_sync[i], cm, sb_rows);
+  }
+}
+
+// Returns the next superblock row to record, in coding order, or 0 if there
+// is none left.
+static int get_next_sb_row(VP9_COMP *cpi, int *tile_idx, int *mi_row) {
+  const VP9_COMMON *const cm = &cpi->common;
+  const int num_tiles = 1 << (cm->log2_tile_cols + cm->log2_tile_rows);
+  VP9BitstreamRowMT *const row_mt = cpi->vp9_bitstream_row_mt;
+  int found = 0;
+
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&row_mt->mutex);
+#endif
+  if (row_mt->next_tile_idx < num_tiles) {
+    *tile_idx = row_mt->next_tile_idx;
+    *mi_row = row_mt->next_mi_row;
+    row_mt->next_mi_row += MI_BLOCK_SIZE;
+    if (row_mt->next_mi_row >=
+        cpi->tile_data[row_mt->next_tile_idx].tile_info.mi_row_end) {
+      if (++row_mt->next_tile_idx < num_tiles) {
+        row_mt->next_mi_row =
+            cpi->tile_data[row_mt->next_tile_idx].tile_info.mi_row_start;
+      }
+    }
+    found = 1;
+  }
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(&row_mt->mutex);
+#endif
+  return found;
+}
+
+// Records the symbols of superblock row 'mi_row' of tile 'tile_idx'. Each
+// superblock waits for the one above it, which writes the partition contexts
+// it reads.
+static void record_modes_sb_row(VP9_COMP *cpi, VP9BitstreamWorkerData *data,
+                                int tile_idx, int mi_row) {
+  const VP9_COMMON *const cm = &cpi->common;
+  VP9BitstreamRowMT *const row_mt = cpi->vp9_bitstream_row_mt;
+  const int tile_row = tile_idx >> cm->log2_tile_cols;
+  const int tile_col = tile_idx & ((1 << cm->log2_tile_cols) - 1);
+  const TileInfo *const tile = &cpi->tile_data[tile_idx].tile_info;
+  const int sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
+  const int tile_sb_row = (mi_row - tile->mi_row_start) >> MI_BLOCK_SIZE_LOG2;
+  const int sb_cols = get_num_cols(*tile, MI_BLOCK_SIZE_LOG2);
+  VP9RowMTSync *const row_mt_sync = &row_mt->row_mt_sync[tile_col];
+  vpx_writer *const w = &row_mt->rows[tile_col * row_mt->sb_rows + sb_row];
+  MACROBLOCKD *const xd = &data->xd;
+  TOKENEXTRA *tok = cpi->tplist[tile_row][tile_col][tile_sb_row].start;
+  const TOKENEXTRA *const tok_end =
+      tok + cpi->tplist[tile_row][tile_col][tile_sb_row].count;
+  int mi_col, sb_col;
+
+  vpx_start_record(w, w->symbols, w->size);
+  vp9_zero(xd->left_seg_context);
+  for (mi_col = tile->mi_col_start, sb_col = 0; mi_col < tile->mi_col_end;
+       mi_col += MI_BLOCK_SIZE, ++sb_col) {
+    vp9_row_mt_sync_read(row_mt_sync, sb_row, sb_col);
+    write_modes_sb(cpi, xd, tile, w, &tok, tok_end, mi_row, mi_col,
+                   BLOCK_64X64, &data->max_mv_magnitude,
+                   data->interp_filter_selected);
+    vp9_row_mt_sync_write(row_mt_sync, sb_row, sb_col, sb_cols);
+  }
+  assert(tok == cpi->tplist[tile_row][tile_col][tile_sb_row].stop);
+}
+
+static int record_sb_rows_worker(void *arg1, void *arg2) {
+  VP9_COMP *const cpi = (VP9_COMP *)arg1;
+  VP9BitstreamWorkerData *const data = (VP9BitstreamWorkerData *)arg2;
+  int tile_idx, mi_row;
+  while (get_next_sb_row(cpi, &tile_idx, &mi_row)) {
+    record_modes_sb_row(cpi, data, tile_idx, mi_row);
+  }
+  return 1;
+}
+
+// Packs the tiles with the workers recording the symbols of the superblock
+// rows in parallel, while this thread codes them one tile after the other.
+// The bitstream is the same as the one encode_tiles() packs serially.
+static size_t encode_tiles_row_mt(VP9_COMP *cpi, uint8_t *data_ptr,
+                                  size_t data_size) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  VP9_COMMON *const cm = &cpi->common;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int num_tiles = tile_cols << cm->log2_tile_rows;
+  const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
+  const int num_workers = cpi->num_workers - 1;
+  VP9BitstreamRowMT *row_mt;
+  size_t total_size = 0;
+  int tile_idx, i;
+  int error = 0, mem_error = 0;
+
+  if (!cpi->vp9_bitstream_worker_data) encode_tiles_buffer_alloc(cpi, 0);
+  bitstream_row_mt_alloc(cpi, sb_rows, tile_cols);
+  row_mt = cpi->vp9_bitstream_row_mt;
+  for (i = 0; i < tile_cols; ++i) {
+    memset(row_mt->row_mt_sync[i].cur_col, -1,
+           sizeof(*row_mt->row_mt_sync[i].cur_col) * sb_rows);
+  }
+  row_mt->next_tile_idx = 0;
+  row_mt->next_mi_row = 0;
+
+  for (i = 0; i < num_workers; ++i) {
+    VPxWorker *const worker = &cpi->workers[i];
+    VP9BitstreamWorkerData *const data = &cpi->vp9_bitstream_worker_data[i];
+
+    data->xd = cpi->td.mb.e_mbd;
+    set_partition_probs(cm, &data->xd);
+    data->max_mv_magnitude = cpi->max_mv_magnitude;
+    memset(data->interp_filter_selected, 0,
+           sizeof(data->interp_filter_selected[0][0]) * SWITCHABLE);
+
+    worker->data1 = cpi;
+    worker->data2 = data;
+    worker->hook = record_sb_rows_worker;
+    worker->had_error = 0;
+    winterface->launch(worker);
+  }
+
+  for (tile_idx = 0; tile_idx < num_tiles; ++tile_idx) {
+    const TileInfo *const tile = &cpi->tile_data[tile_idx].tile_info;
+    const int tile_col = tile_idx & (tile_cols - 1);
+    const int sb_cols = get_num_cols(*tile, MI_BLOCK_SIZE_LOG2);
+    const int is_last_tile = tile_idx == num_tiles - 1;
+    const size_t offset = total_size + (is_last_tile ? 0 : 4);
+    vpx_writer residual_bc;
+    int mi_row;
+
+    if (data_size < offset) {
+      error = 1;
+      break;
+    }
+    vpx_start_encode(&residual_bc, data_ptr + offset, data_size - offset);
+    for (mi_row = tile->mi_row_start; mi_row < tile->mi_row_end;
+         mi_row += MI_BLOCK_SIZE) {
+      const int sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
+      const vpx_writer *const row = &row_mt->rows[tile_col * sb_rows + sb_row];
+      // Wait for the whole row to be recorded.
+      vp9_row_mt_sync_read(&row_mt->row_mt_sync[tile_col], sb_row + 1,
+                           sb_cols - 1);
+      mem_error |= row->error;
+      vpx_write_symbols(&residual_bc, row->symbols, row->pos);
+    }
+    if (vpx_stop_encode(&residual_bc)) {
+      error = 1;
+      break;
+    }
+    if (!is_last_tile) {
+      // size of this tile
+      mem_put_be32(data_ptr + total_size, residual_bc.pos);
+      total_size += 4;
+    }
+    total_size += residual_bc.pos;
+  }
+
+  for (i = 0; i < num_workers; ++i) {
+    const VP9BitstreamWorkerData *const data =
+        &cpi->vp9_bitstream_worker_data[i];
+    int k;
+    winterface->sync(&cpi->workers[i]);
+
+    // Aggregate per-thread bitstream stats.
+    cpi->max_mv_magnitude =
+        VPXMAX(cpi->max_mv_magnitude, data->max_mv_magnitude);
+    for (k = 0; k < SWITCHABLE; ++k) {
+      cpi->interp_filter_selected[0][k] += data->interp_filter_selected[0][k];
+    }
+  }
+
+  if (mem_error) {
+    vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                       "Failed to allocate bitstream symbols");
+  }
+  if (error) {
+    vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
+                       "encode_tiles_row_mt: output buffer full");
+  }
+  return total_size;
+}
+
 static size_t encode_tiles(VP9_COMP *cpi, uint8_t *data_ptr, size_t data_size) {
   VP9_COMMON *const cm = &cpi->common;
   MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
@@ -1123,6 +1360,12 @@ static size_t encode_tiles(VP9_COMP *cpi, uint8_t *data_ptr, size_t data_size) {
     return encode_tiles_mt(cpi, data_ptr, data_size);
   }
 
+  // With row based multi-threading, only the coding of the symbols of each
+  // tile is serial.
+  if (cpi->row_mt && cpi->num_workers > 1) {
+    return encode_tiles_row_mt(cpi, data_ptr, data_size);
+  }
+
   for (tile_row = 0; tile_row < tile_rows; tile_row++) {
     for (tile_col = 0; tile_col < tile_cols; tile_col++) {
       int tile_idx = tile_row * tile_cols + tile_col;
@@ -31,10 +31,32 @@ typedef struct VP9BitstreamWorkerData {
   DECLARE_ALIGNED(16, MACROBLOCKD, xd);
 } VP9BitstreamWorkerData;
 
+// Packing of the tiles with row based multi-threading. The workers record the
+// symbols of the superblock rows in coding order, following the wavefront of
+// the partition contexts, and the main thread codes them.
+typedef struct VP9BitstreamRowMT {
+  // The symbols of superblock row r of tile column c are recorded in
+  // rows[c * sb_rows + r].
+  vpx_writer *rows;
+  int sb_rows;
+  int tile_cols;
+  // Progress of the superblock rows of each tile column, over all the tile
+  // rows.
+  VP9RowMTSync row_mt_sync[MAX_NUM_TILE_COLS];
+  // The next superblock row to record.
+  int next_tile_idx;
+  int next_mi_row;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t mutex;
+#endif
+} VP9BitstreamRowMT;
+
 int vp9_get_refresh_mask(VP9_COMP *cpi);
 
 void vp9_bitstream_encode_tiles_buffer_dealloc(VP9_COMP *const cpi);
 
+void vp9_bitstream_row_mt_dealloc(VP9_COMP *const cpi);
+
 void vp9_pack_bitstream(VP9_COMP *cpi, uint8_t *dest, size_t dest_size,
                         size_t *size);
 
@@ -1035,9 +1035,19 @@ static void dealloc_compressor_data(VP9_COMP *cpi) {
   vp9_free_context_buffers(cm);
 
   vpx_free_frame_buffer(&cpi->last_frame_uf);
+  vpx_free(cpi->lpf_search_lfm);
+  cpi->lpf_search_lfm = NULL;
+  cpi->lpf_search_lfm_size = 0;
+  vpx_free(cpi->lpf_search_rows);
+  cpi->lpf_search_rows = NULL;
+  cpi->lpf_search_rows_size = 0;
   vpx_free_frame_buffer(&cpi->scaled_source);
   vpx_free_frame_buffer(&cpi->scaled_last_source);
   vpx_free_frame_buffer(&cpi->tf_buffer);
+#if !CONFIG_REALTIME_ONLY
+  vp9_temporal_filter_pipeline_dealloc(cpi);
+  vp9_free_first_pass_parallel_frames(&cpi->twopass);
+#endif
 #ifdef ENABLE_KF_DENOISE
   vpx_free_frame_buffer(&cpi->raw_unscaled_source);
   vpx_free_frame_buffer(&cpi->raw_scaled_source);
@@ -2100,6 +2110,12 @@ void vp9_change_config(struct VP9_COMP *cpi, const VP9EncoderConfig *oxcf) {
   int last_w = cpi->oxcf.width;
   int last_h = cpi->oxcf.height;
 
+#if !CONFIG_REALTIME_ONLY
+  // Drop the ARF filtered ahead of time with the old configuration.
+  vp9_temporal_filter_pipeline_sync(cpi);
+  cpi->arnr_pipeline.pending = 0;
+#endif
+
   vp9_init_quantizer(cpi);
   if (cm->profile != oxcf->profile) cm->profile = oxcf->profile;
   cm->bit_depth = oxcf->bit_depth;
@@ -2879,6 +2895,7 @@ void vp9_remove_compressor(VP9_COMP *cpi) {
 
   vp9_loop_filter_dealloc(&cpi->lf_row_sync);
   vp9_bitstream_encode_tiles_buffer_dealloc(cpi);
+  vp9_bitstream_row_mt_dealloc(cpi);
   vp9_row_mt_mem_dealloc(cpi);
   vp9_encode_free_mt_data(cpi);
 
@@ -4368,6 +4385,24 @@ static int get_qstep_adj(int rate_excess, int rate_limit) {
   return VPXMIN(qstep, MAX_QSTEP_ADJ);
 }
 
+// Returns the q index at which the frame is expected to give 'target' bits,
+// from the sizes 'size0' and 'size1' it gave at the q indices 'q0' and 'q1',
+// taking log(size) as a linear function of log(q). Returns -1 if the size does
+// not decrease as q increases.
+static int get_q_from_sizes(int q0, int size0, int q1, int size1, int target,
+                            vpx_bit_depth_t bit_depth) {
+  double log_q0, log_q1, log_q;
+  if (q0 == q1 || size0 == size1 || (q1 > q0) == (size1 > size0) ||
+      size0 <= 0 || size1 <= 0 || target <= 0)
+    return -1;
+  log_q0 = log(vp9_convert_qindex_to_q(q0, bit_depth));
+  log_q1 = log(vp9_convert_qindex_to_q(q1, bit_depth));
+  log_q = log_q0 + (log((double)target) - log((double)size0)) *
+                       (log_q1 - log_q0) /
+                       (log((double)size1) - log((double)size0));
+  return vp9_convert_q_to_qindex(exp(log_q), bit_depth);
+}
+
 static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size, uint8_t *dest,
                                     size_t dest_size) {
   const VP9EncoderConfig *const oxcf = &cpi->oxcf;
@@ -4382,6 +4417,12 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size, uint8_t *dest,
   int frame_over_shoot_limit;
   int frame_under_shoot_limit;
   int q = 0, q_low = 0, q_high = 0;
+  // For recode_interpolation, the q index of the previous attempt at this
+  // frame size, of the last one that overshot and of the last one that
+  // undershot, with the projected frame sizes they gave.
+  int q_prev = 0, size_prev = 0;
+  int q_over = 0, size_over = 0;
+  int q_under = 0, size_under = 0;
   int enable_acl;
 #ifdef AGGRESSIVE_VBR
   int qrange_adj = 1;
@@ -4428,6 +4469,7 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size, uint8_t *dest,
       // Reset the loop state for new frame size.
       overshoot_seen = 0;
       undershoot_seen = 0;
+      size_prev = 0;
 
       // Reconfiguration for change in frame size has concluded.
       cpi->resize_pending = 0;
@@ -4620,6 +4662,7 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size, uint8_t *dest,
         int last_q = q;
         int retries = 0;
         int qstep;
+        int q_est = -1;
 
         if (cpi->resize_pending == 1) {
           // Change in frame size so go back around the recode loop.
@@ -4640,6 +4683,21 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size, uint8_t *dest,
 
         // Frame is too large
         if (rc->projected_frame_size > rc->this_frame_target) {
+          // With recode_interpolation, the next q comes from the sizes of this
+          // attempt and of the last one that undershot, or else of the
+          // previous one.
+          if (oxcf->recode_interpolation) {
+            if (undershoot_seen) {
+              q_est = get_q_from_sizes(q_under, size_under, q,
+                                       rc->projected_frame_size,
+                                       rc->this_frame_target, cm->bit_depth);
+            } else if (size_prev > 0) {
+              q_est = get_q_from_sizes(q_prev, size_prev, q,
+                                       rc->projected_frame_size,
+                                       rc->this_frame_target, cm->bit_depth);
+            }
+          }
+
           // Special case if the projected size is > the max allowed.
           if ((q == q_high) &&
               ((rc->projected_frame_size >= rc->max_frame_bandwidth) ||
@@ -4653,6 +4711,14 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size, uint8_t *dest,
             q_val_high =
                 q_val_high * ((double)rc->projected_frame_size / max_rate);
             q_high = vp9_convert_q_to_qindex(q_val_high, cm->bit_depth);
+            // The size often falls more slowly than q rises, so also allow
+            // the q that the previous attempt predicts for max_rate.
+            if (oxcf->recode_interpolation && size_prev > 0) {
+              q_high = VPXMAX(
+                  q_high, get_q_from_sizes(q_prev, size_prev, q,
+                                           rc->projected_frame_size, max_rate,
+                                           cm->bit_depth));
+            }
             q_high = clamp(q_high, rc->best_quality, rc->worst_quality);
           }
 
@@ -4661,7 +4727,10 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size, uint8_t *dest,
               get_qstep_adj(rc->projected_frame_size, rc->this_frame_target);
           q_low = VPXMIN(q + qstep, q_high);
 
-          if (undershoot_seen || loop_at_this_size > 1) {
+          if (q_est >= 0) {
+            vp9_rc_update_rate_correction_factors(cpi);
+            q = q_est;
+          } else if (undershoot_seen || loop_at_this_size > 1) {
             // Update rate_correction_factor unless
             vp9_rc_update_rate_correction_factors(cpi);
 
@@ -4681,14 +4750,31 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size, uint8_t *dest,
             }
           }
 
+          q_over = last_q;
+          size_over = rc->projected_frame_size;
           overshoot_seen = 1;
         } else {
           // Frame is too small
+          if (oxcf->recode_interpolation) {
+            if (overshoot_seen) {
+              q_est = get_q_from_sizes(q_over, size_over, q,
+                                       rc->projected_frame_size,
+                                       rc->this_frame_target, cm->bit_depth);
+            } else if (size_prev > 0) {
+              q_est = get_q_from_sizes(q_prev, size_prev, q,
+                                       rc->projected_frame_size,
+                                       rc->this_frame_target, cm->bit_depth);
+            }
+          }
+
           qstep =
               get_qstep_adj(rc->this_frame_target, rc->projected_frame_size);
           q_high = VPXMAX(q - qstep, q_low);
 
-          if (overshoot_seen || loop_at_this_size > 1) {
+          if (q_est >= 0) {
+            vp9_rc_update_rate_correction_factors(cpi);
+            q = q_est;
+          } else if (overshoot_seen || loop_at_this_size > 1) {
             vp9_rc_update_rate_correction_factors(cpi);
             q = (q_high + q_low) / 2;
           } else {
@@ -4710,8 +4796,13 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size, uint8_t *dest,
               retries++;
             }
           }
+
+          q_under = last_q;
+          size_under = rc->projected_frame_size;
           undershoot_seen = 1;
         }
+        q_prev = last_q;
+        size_prev = rc->projected_frame_size;
 
         // Clamp Q to upper and lower limits:
         q = clamp(q, q_low, q_high);
@@ -5308,6 +5399,37 @@ static void update_encode_frame_result_basic(
   encode_frame_result->update_type = update_type;
   encode_frame_result->quantize_index = quantize_index;
 }
+
+// In frame pipelining mode, starts filtering the ARF coded by the next frame of
+// the GF group, to run while this frame is loop filtered and packed.
+static void start_next_arf_filter(VP9_COMP *cpi) {
+  const VP9EncoderConfig *const oxcf = &cpi->oxcf;
+  const GF_GROUP *const gf_group = &cpi->twopass.gf_group;
+  const int next_index = gf_group->index + 1;
+  const int refresh_golden_frame = cpi->refresh_golden_frame;
+  const int refresh_alt_ref_frame = cpi->refresh_alt_ref_frame;
+  int rdmult;
+
+  if (!oxcf->frame_pipelining || oxcf->max_threads <= 1 || oxcf->pass != 2 ||
+      oxcf->mode == REALTIME || oxcf->arnr_max_frames <= 0 ||
+      oxcf->arnr_strength <= 0 || cpi->use_svc || cpi->ext_ratectrl.ready ||
+      !is_altref_enabled(cpi))
+    return;
+  if (next_index >= gf_group->gf_group_size ||
+      gf_group->update_type[next_index] != ARF_UPDATE)
+    return;
+
+  // vp9_get_compressed_data() resets the reference updates before filtering
+  // the ARF of the next frame.
+  cpi->refresh_golden_frame = 0;
+  cpi->refresh_alt_ref_frame = 0;
+  rdmult = vp9_compute_rd_mult_based_on_qindex(cpi, ARNR_FILT_QINDEX);
+  cpi->refresh_golden_frame = refresh_golden_frame;
+  cpi->refresh_alt_ref_frame = refresh_alt_ref_frame;
+
+  vp9_temporal_filter_pipeline_start(cpi, gf_group->arf_src_offset[next_index],
+                                     ALTREF_HIGH_PRECISION_MV, rdmult);
+}
 #endif  // !CONFIG_REALTIME_ONLY
 
 static void encode_frame_to_data_rate(
@@ -5491,6 +5613,10 @@ static void encode_frame_to_data_rate(
   cm->frame_to_show->render_width = cm->render_width;
   cm->frame_to_show->render_height = cm->render_height;
 
+#if !CONFIG_REALTIME_ONLY
+  start_next_arf_filter(cpi);
+#endif
+
 #if CONFIG_COLLECT_COMPONENT_TIMING
   start_timing(cpi, loopfilter_frame_time);
 #endif
@@ -6513,6 +6639,9 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
     // One pass encode
     Pass0Encode(cpi, size, dest, dest_size, frame_flags);
   }
+  // The ARF filtered ahead of time reads from the lookahead, which the
+  // application fills between calls.
+  vp9_temporal_filter_pipeline_sync(cpi);
 #endif  // CONFIG_REALTIME_ONLY
 
   if (cm->show_frame) cm->cur_show_frame_fb_idx = cm->new_fb_idx;
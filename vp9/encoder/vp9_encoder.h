@@ -265,6 +265,19 @@ typedef struct VP9EncoderConfig {
 
   int enable_keyframe_filtering;
 
+  // Overlap the filtering of the next ARF with the end of the current frame.
+  int frame_pipelining;
+
+  // Pick the q of a recode from the sizes of the previous attempts, once they
+  // bracket the target size, rather than by bisection.
+  int recode_interpolation;
+
+  // Make the output independent of the number of threads.
+  int thread_invariant;
+
+  // Analyse several frames at once in the first pass, one per thread.
+  int frame_parallel_first_pass;
+
   int max_threads;
 
   unsigned int target_level;
@@ -505,8 +518,33 @@ typedef struct ARNRFilterData {
   int alt_ref_index;
   struct scale_factors sf;
   YV12_BUFFER_CONFIG *dst;
+  int allow_high_precision_mv;
+  int rdmult;
 } ARNRFilterData;
 
+// An ARF filtered ahead of time by a worker in frame pipelining mode.
+typedef struct ARNRPipeline {
+  VPxWorker worker;
+  // Motion search data of 'worker'. NULL until 'worker' is created.
+  ThreadData *td;
+  ARNRFilterData filter_data;
+  YV12_BUFFER_CONFIG buffer;
+  int mb_rows;
+  int mb_cols;
+  // 1 if 'worker' was launched to filter 'filter_data' into 'buffer' and the
+  // result was not used yet.
+  int pending;
+} ARNRPipeline;
+
+// Frame level data shared by the workers that build the TPL model of a frame.
+typedef struct TplFlowData {
+  struct GF_PICTURE *gf_picture;
+  YV12_BUFFER_CONFIG *ref_frame[MAX_INTER_REF_FRAMES];
+  int frame_idx;
+  BLOCK_SIZE bsize;
+  struct scale_factors sf;
+} TplFlowData;
+
 typedef struct EncFrameBuf {
   int mem_valid;
   int released;
@@ -616,6 +654,7 @@ typedef struct VP9_COMP {
 
   BLOCK_SIZE tpl_bsize;
   TplDepFrame tpl_stats[MAX_ARF_GOP_SIZE];
+  TplFlowData tpl_flow_data;
   // Used to store TPL stats before propagation
   VpxTplGopStats tpl_gop_stats;
   YV12_BUFFER_CONFIG *tpl_recon_frames[REF_FRAMES];
@@ -852,9 +891,18 @@ typedef struct VP9_COMP {
   // Multi-threading
   int num_workers;
   VPxWorker *workers;
+  // If not NULL, the workers run on this shared thread pool.
+  VPxThreadPoolClient *pool_client;
   struct EncWorkerData *tile_thr_data;
   VP9LfSync lf_row_sync;
+  // Per level loop filter masks and scratch superblock rows of the fused
+  // filter level search.
+  LOOP_FILTER_MASK *lpf_search_lfm;
+  size_t lpf_search_lfm_size;
+  uint8_t *lpf_search_rows;
+  size_t lpf_search_rows_size;
   struct VP9BitstreamWorkerData *vp9_bitstream_worker_data;
+  struct VP9BitstreamRowMT *vp9_bitstream_row_mt;
 
   int keep_level_stats;
   Vp9LevelInfo level_info;
@@ -862,6 +910,7 @@ typedef struct VP9_COMP {
   void (*row_mt_sync_read_ptr)(VP9RowMTSync *const, int, int);
   void (*row_mt_sync_write_ptr)(VP9RowMTSync *const, int, int, const int);
   ARNRFilterData arnr_filter_data;
+  ARNRPipeline arnr_pipeline;
 
   int row_mt;
   unsigned int row_mt_bit_exact;
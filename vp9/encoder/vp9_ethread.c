@@ -16,6 +16,7 @@
 #include "vp9/encoder/vp9_firstpass.h"
 #include "vp9/encoder/vp9_multi_thread.h"
 #include "vp9/encoder/vp9_temporal_filter.h"
+#include "vp9/encoder/vp9_tpl_model.h"
 #include "vpx_dsp/vpx_dsp_common.h"
 #include "vpx_util/vpx_pthread.h"
 
@@ -108,6 +109,7 @@ static void create_enc_workers(VP9_COMP *cpi, int num_workers) {
     ++cpi->num_workers;
     winterface->init(worker);
     worker->thread_name = "vpx enc worker";
+    worker->pool_client = cpi->pool_client;
 
     if (i < num_workers - 1) {
       thread_data->cpi = cpi;
@@ -395,7 +397,9 @@ void vp9_row_mt_sync_write(VP9RowMTSync *const row_mt_sync, int r, int c,
 
     row_mt_sync->cur_col[r] = cur;
 
-    pthread_cond_signal(&row_mt_sync->cond[r]);
+    // Besides the next row, the main thread may wait for the row, when
+    // packing the bitstream.
+    pthread_cond_broadcast(&row_mt_sync->cond[r]);
     pthread_mutex_unlock(&row_mt_sync->mutex[r]);
   }
 #else
@@ -453,7 +457,8 @@ static int first_pass_worker_hook(void *arg1, void *arg2) {
       best_ref_mv = zero_mv;
       vp9_zero(fp_acc_data);
       fp_acc_data.image_data_start_row = INVALID_ROW;
-      vp9_first_pass_encode_tile_mb_row(cpi, thread_data->td, &fp_acc_data,
+      vp9_first_pass_encode_tile_mb_row(cpi, thread_data->td,
+                                        &cpi->twopass.fp_frame, &fp_acc_data,
                                         this_tile, &best_ref_mv, mb_row);
     }
   }
@@ -507,6 +512,34 @@ void vp9_encode_fp_row_mt(VP9_COMP *cpi) {
   }
 }
 
+static int first_pass_frame_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  FIRSTPASS_PARALLEL_FRAME *const fp_frames = (FIRSTPASS_PARALLEL_FRAME *)arg2;
+  vp9_first_pass_analyse_frame(thread_data->cpi, thread_data->td,
+                               &fp_frames[thread_data->start]);
+  return 1;
+}
+
+void vp9_first_pass_frames_mt(VP9_COMP *cpi, int num_frames) {
+  int i;
+
+  create_enc_workers(cpi, VPXMAX(cpi->oxcf.max_threads, 1));
+  assert(num_frames <= cpi->num_workers);
+
+  for (i = 0; i < num_frames; i++) {
+    EncWorkerData *thread_data;
+    thread_data = &cpi->tile_thr_data[i];
+
+    // Before encoding a frame, copy the thread data from cpi.
+    if (thread_data->td != &cpi->td) {
+      thread_data->td->mb = cpi->td.mb;
+    }
+  }
+
+  launch_enc_workers(cpi, first_pass_frame_worker_hook,
+                     cpi->twopass.fp_parallel_frames, num_frames);
+}
+
 static int temporal_filter_worker_hook(void *arg1, void *arg2) {
   EncWorkerData *const thread_data = (EncWorkerData *)arg1;
   MultiThreadHandle *multi_thread_ctxt = (MultiThreadHandle *)arg2;
@@ -586,6 +619,85 @@ void vp9_temporal_filter_row_mt(VP9_COMP *cpi) {
 }
 #endif  // !CONFIG_REALTIME_ONLY
 
+static int tpl_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  MultiThreadHandle *multi_thread_ctxt = (MultiThreadHandle *)arg2;
+  VP9_COMP *const cpi = thread_data->cpi;
+  const VP9_COMMON *const cm = &cpi->common;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int mi_height = num_8x8_blocks_high_lookup[cpi->tpl_flow_data.bsize];
+  int tile_row, tile_col;
+  TileDataEnc *this_tile;
+  int end_of_frame;
+  int thread_id = thread_data->thread_id;
+  int cur_tile_id = multi_thread_ctxt->thread_id_to_tile_id[thread_id];
+  JobNode *proc_job = NULL;
+  int mi_row;
+
+  end_of_frame = 0;
+  while (0 == end_of_frame) {
+    // Get the next job in the queue
+    proc_job =
+        (JobNode *)vp9_enc_grp_get_next_job(multi_thread_ctxt, cur_tile_id);
+    if (NULL == proc_job) {
+      // Query for the status of other tiles
+      end_of_frame = vp9_get_tiles_proc_status(
+          multi_thread_ctxt, thread_data->tile_completion_status, &cur_tile_id,
+          tile_cols);
+    } else {
+      tile_col = proc_job->tile_col_id;
+      tile_row = proc_job->tile_row_id;
+      this_tile = &cpi->tile_data[tile_row * tile_cols + tile_col];
+      mi_row = proc_job->vert_unit_row_num * mi_height;
+
+      vp9_mc_flow_dispenser_row(cpi, thread_data->td, mi_row,
+                                this_tile->tile_info.mi_col_start,
+                                this_tile->tile_info.mi_col_end);
+    }
+  }
+  return 1;
+}
+
+void vp9_mc_flow_dispenser_row_mt(VP9_COMP *cpi) {
+  VP9_COMMON *const cm = &cpi->common;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int tile_rows = 1 << cm->log2_tile_rows;
+  MultiThreadHandle *multi_thread_ctxt = &cpi->multi_thread_ctxt;
+  int num_workers = VPXMAX(cpi->oxcf.max_threads, 1);
+  int i;
+
+  // The job queue holds at least one job per 16x16 row.
+  assert(cpi->tpl_flow_data.bsize >= BLOCK_16X16);
+
+  if (multi_thread_ctxt->allocated_tile_cols < tile_cols ||
+      multi_thread_ctxt->allocated_tile_rows < tile_rows ||
+      multi_thread_ctxt->allocated_vert_unit_rows < cm->mb_rows) {
+    vp9_row_mt_mem_dealloc(cpi);
+    vp9_init_tile_data(cpi);
+    vp9_row_mt_mem_alloc(cpi);
+  } else {
+    vp9_init_tile_data(cpi);
+  }
+
+  create_enc_workers(cpi, num_workers);
+
+  vp9_assign_tile_to_thread(multi_thread_ctxt, tile_cols, cpi->num_workers);
+
+  vp9_prepare_job_queue(cpi, TPL_JOB);
+
+  for (i = 0; i < num_workers; i++) {
+    EncWorkerData *thread_data;
+    thread_data = &cpi->tile_thr_data[i];
+
+    // Before building the model of a frame, copy the thread data from cpi.
+    if (thread_data->td != &cpi->td) {
+      thread_data->td->mb = cpi->td.mb;
+    }
+  }
+
+  launch_enc_workers(cpi, tpl_worker_hook, multi_thread_ctxt, num_workers);
+}
+
 static int enc_row_mt_worker_hook(void *arg1, void *arg2) {
   EncWorkerData *const thread_data = (EncWorkerData *)arg1;
   MultiThreadHandle *multi_thread_ctxt = (MultiThreadHandle *)arg2;
@@ -55,6 +55,10 @@ void vp9_encode_tiles_row_mt(struct VP9_COMP *cpi);
 
 void vp9_encode_fp_row_mt(struct VP9_COMP *cpi);
 
+// Runs the first pass of the first num_frames frames of
+// cpi->twopass.fp_parallel_frames, one frame per thread.
+void vp9_first_pass_frames_mt(struct VP9_COMP *cpi, int num_frames);
+
 void vp9_row_mt_sync_read(VP9RowMTSync *const row_mt_sync, int r, int c);
 void vp9_row_mt_sync_write(VP9RowMTSync *const row_mt_sync, int r, int c,
                            const int cols);
@@ -72,6 +76,8 @@ void vp9_row_mt_sync_mem_dealloc(VP9RowMTSync *row_mt_sync);
 
 void vp9_temporal_filter_row_mt(struct VP9_COMP *cpi);
 
+void vp9_mc_flow_dispenser_row_mt(struct VP9_COMP *cpi);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -876,6 +876,7 @@ static void accumulate_fp_mb_row_stat(TileDataEnc *this_tile,
 #define NZ_MOTION_PENALTY 128
 #define INTRA_MODE_PENALTY 1024
 void vp9_first_pass_encode_tile_mb_row(VP9_COMP *cpi, ThreadData *td,
+                                       const FIRSTPASS_FRAME *fp_frame,
                                        FIRSTPASS_DATA *fp_acc_data,
                                        TileDataEnc *tile_data, MV *best_ref_mv,
                                        int mb_row) {
@@ -897,9 +898,9 @@ void vp9_first_pass_encode_tile_mb_row(VP9_COMP *cpi, ThreadData *td,
   const MV zero_mv = { 0, 0 };
   int recon_y_stride, recon_uv_stride, uv_mb_height;
 
-  YV12_BUFFER_CONFIG *const lst_yv12 = get_ref_frame_buffer(cpi, LAST_FRAME);
-  YV12_BUFFER_CONFIG *gld_yv12 = get_ref_frame_buffer(cpi, GOLDEN_FRAME);
-  YV12_BUFFER_CONFIG *const new_yv12 = get_frame_new_buffer(cm);
+  YV12_BUFFER_CONFIG *const lst_yv12 = fp_frame->last_ref;
+  YV12_BUFFER_CONFIG *gld_yv12 = fp_frame->golden_ref;
+  YV12_BUFFER_CONFIG *const new_yv12 = fp_frame->recon;
   const YV12_BUFFER_CONFIG *first_ref_buf = lst_yv12;
 
   MODE_INFO mi_above, mi_left;
@@ -914,10 +915,10 @@ void vp9_first_pass_encode_tile_mb_row(VP9_COMP *cpi, ThreadData *td,
 
   // First pass code requires valid last and new frame buffers.
   assert(new_yv12 != NULL);
-  assert(frame_is_intra_only(cm) || (lst_yv12 != NULL));
+  assert(fp_frame->intra_only || (lst_yv12 != NULL));
 
-  xd->mi = cm->mi_grid_visible + xd->mi_stride * (mb_row << 1) + mb_col_start;
-  xd->mi[0] = cm->mi + xd->mi_stride * (mb_row << 1) + mb_col_start;
+  xd->mi = fp_frame->mi_grid + xd->mi_stride * (mb_row << 1) + mb_col_start;
+  xd->mi[0] = fp_frame->mi + xd->mi_stride * (mb_row << 1) + mb_col_start;
 
   for (i = 0; i < MAX_MB_PLANE; ++i) {
     p[i].coeff = ctx->coeff_pbuf[i][1];
@@ -957,12 +958,12 @@ void vp9_first_pass_encode_tile_mb_row(VP9_COMP *cpi, ThreadData *td,
     }
 
     // Adjust to the next column of MBs.
-    x->plane[0].src.buf = cpi->Source->y_buffer +
+    x->plane[0].src.buf = fp_frame->source->y_buffer +
                           mb_row * 16 * x->plane[0].src.stride + mb_col * 16;
-    x->plane[1].src.buf = cpi->Source->u_buffer +
+    x->plane[1].src.buf = fp_frame->source->u_buffer +
                           mb_row * uv_mb_height * x->plane[1].src.stride +
                           mb_col * uv_mb_height;
-    x->plane[2].src.buf = cpi->Source->v_buffer +
+    x->plane[2].src.buf = fp_frame->source->v_buffer +
                           mb_row * uv_mb_height * x->plane[1].src.stride +
                           mb_col * uv_mb_height;
 
@@ -1021,7 +1022,7 @@ void vp9_first_pass_encode_tile_mb_row(VP9_COMP *cpi, ThreadData *td,
     }
 
     // Special case noise measurement for first frame.
-    if (cm->current_video_frame == 0) {
+    if (fp_frame->frame_index == 0) {
       if (this_intra_error < scale_sse_threshold(cm, LOW_I_THRESH)) {
         fp_acc_data->frame_noise_energy += fp_estimate_block_noise(x, bsize);
       } else {
@@ -1047,13 +1048,13 @@ void vp9_first_pass_encode_tile_mb_row(VP9_COMP *cpi, ThreadData *td,
     if (log_intra < 10.0) {
       mb_intra_factor = 1.0 + ((10.0 - log_intra) * 0.05);
       fp_acc_data->intra_factor += mb_intra_factor;
-      if (cpi->row_mt_bit_exact)
-        cpi->twopass.fp_mb_float_stats[mb_index].frame_mb_intra_factor =
+      if (fp_frame->mb_float_stats != NULL)
+        fp_frame->mb_float_stats[mb_index].frame_mb_intra_factor =
             mb_intra_factor;
     } else {
       fp_acc_data->intra_factor += 1.0;
-      if (cpi->row_mt_bit_exact)
-        cpi->twopass.fp_mb_float_stats[mb_index].frame_mb_intra_factor = 1.0;
+      if (fp_frame->mb_float_stats != NULL)
+        fp_frame->mb_float_stats[mb_index].frame_mb_intra_factor = 1.0;
     }
 
 #if CONFIG_VP9_HIGHBITDEPTH
@@ -1067,14 +1068,13 @@ void vp9_first_pass_encode_tile_mb_row(VP9_COMP *cpi, ThreadData *td,
     if ((level_sample < DARK_THRESH) && (log_intra < 9.0)) {
       mb_brightness_factor = 1.0 + (0.01 * (DARK_THRESH - level_sample));
       fp_acc_data->brightness_factor += mb_brightness_factor;
-      if (cpi->row_mt_bit_exact)
-        cpi->twopass.fp_mb_float_stats[mb_index].frame_mb_brightness_factor =
+      if (fp_frame->mb_float_stats != NULL)
+        fp_frame->mb_float_stats[mb_index].frame_mb_brightness_factor =
             mb_brightness_factor;
     } else {
       fp_acc_data->brightness_factor += 1.0;
-      if (cpi->row_mt_bit_exact)
-        cpi->twopass.fp_mb_float_stats[mb_index].frame_mb_brightness_factor =
-            1.0;
+      if (fp_frame->mb_float_stats != NULL)
+        fp_frame->mb_float_stats[mb_index].frame_mb_brightness_factor = 1.0;
     }
 
     // Intrapenalty below deals with situations where the intra and inter
@@ -1096,7 +1096,7 @@ void vp9_first_pass_encode_tile_mb_row(VP9_COMP *cpi, ThreadData *td,
         ((cm->mb_cols - 1 - mb_col) * 16) + BORDER_MV_PIXELS_B16;
 
     // Other than for intra-only frame do a motion search.
-    if (!frame_is_intra_only(cm)) {
+    if (!fp_frame->intra_only) {
       int tmp_err, motion_error, this_motion_error, raw_motion_error;
       // Assume 0,0 motion with no mv overhead.
       MV mv = { 0, 0 }, tmp_mv = { 0, 0 };
@@ -1125,8 +1125,8 @@ void vp9_first_pass_encode_tile_mb_row(VP9_COMP *cpi, ThreadData *td,
       // frame as the reference. Skip the further motion search on
       // reconstructed frame if this error is very small.
       unscaled_last_source_buf_2d.buf =
-          cpi->unscaled_last_source->y_buffer + recon_yoffset;
-      unscaled_last_source_buf_2d.stride = cpi->unscaled_last_source->y_stride;
+          fp_frame->last_source->y_buffer + recon_yoffset;
+      unscaled_last_source_buf_2d.stride = fp_frame->last_source->y_stride;
 #if CONFIG_VP9_HIGHBITDEPTH
       if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
         raw_motion_error = highbd_get_prediction_error(
@@ -1169,7 +1169,7 @@ void vp9_first_pass_encode_tile_mb_row(VP9_COMP *cpi, ThreadData *td,
         }
 
         // Search in an older reference frame.
-        if ((cm->current_video_frame > 1) && gld_yv12 != NULL) {
+        if ((fp_frame->frame_index > 1) && gld_yv12 != NULL) {
           // Assume 0,0 motion with no mv overhead.
           int gf_motion_error;
 
@@ -1225,9 +1225,8 @@ void vp9_first_pass_encode_tile_mb_row(VP9_COMP *cpi, ThreadData *td,
         if (((this_error - intrapenalty) * 9 <= motion_error * 10) &&
             (this_error < (2 * intrapenalty))) {
           fp_acc_data->neutral_count += 1.0;
-          if (cpi->row_mt_bit_exact)
-            cpi->twopass.fp_mb_float_stats[mb_index].frame_mb_neutral_count =
-                1.0;
+          if (fp_frame->mb_float_stats != NULL)
+            fp_frame->mb_float_stats[mb_index].frame_mb_neutral_count = 1.0;
           // Also track cases where the intra is not much worse than the inter
           // and use this in limiting the GF/arf group length.
         } else if ((this_error > NCOUNT_INTRA_THRESH) &&
@@ -1235,8 +1234,8 @@ void vp9_first_pass_encode_tile_mb_row(VP9_COMP *cpi, ThreadData *td,
           mb_neutral_count =
               (double)motion_error / DOUBLE_DIVIDE_CHECK((double)this_error);
           fp_acc_data->neutral_count += mb_neutral_count;
-          if (cpi->row_mt_bit_exact)
-            cpi->twopass.fp_mb_float_stats[mb_index].frame_mb_neutral_count =
+          if (fp_frame->mb_float_stats != NULL)
+            fp_frame->mb_float_stats[mb_index].frame_mb_neutral_count =
                 mb_neutral_count;
         }
 
@@ -1332,7 +1331,9 @@ void vp9_first_pass_encode_tile_mb_row(VP9_COMP *cpi, ThreadData *td,
   vpx_clear_system_state();
 }
 
-static void first_pass_encode(VP9_COMP *cpi, FIRSTPASS_DATA *fp_acc_data) {
+static void first_pass_encode(VP9_COMP *cpi, ThreadData *td,
+                              const FIRSTPASS_FRAME *fp_frame,
+                              FIRSTPASS_DATA *fp_acc_data) {
   VP9_COMMON *const cm = &cpi->common;
   int mb_row;
   TileDataEnc tile_data;
@@ -1345,9 +1346,197 @@ static void first_pass_encode(VP9_COMP *cpi, FIRSTPASS_DATA *fp_acc_data) {
 
   for (mb_row = 0; mb_row < cm->mb_rows; ++mb_row) {
     best_ref_mv = zero_mv;
-    vp9_first_pass_encode_tile_mb_row(cpi, &cpi->td, fp_acc_data, &tile_data,
-                                      &best_ref_mv, mb_row);
+    vp9_first_pass_encode_tile_mb_row(cpi, td, fp_frame, fp_acc_data,
+                                      &tile_data, &best_ref_mv, mb_row);
+  }
+}
+
+void vp9_first_pass_analyse_frame(VP9_COMP *cpi, ThreadData *td,
+                                  FIRSTPASS_PARALLEL_FRAME *fp_frame) {
+  MACROBLOCK *const x = &td->mb;
+  MACROBLOCKD *const xd = &x->e_mbd;
+  const FIRSTPASS_FRAME *const frame = &fp_frame->frame;
+
+  vp9_zero(fp_frame->fp_data);
+  fp_frame->fp_data.image_data_start_row = INVALID_ROW;
+
+  vp9_setup_src_planes(x, frame->source, 0, 0);
+  vp9_setup_dst_planes(xd->plane, frame->recon, 0, 0);
+  if (!frame->intra_only) {
+    vp9_setup_pre_planes(xd, 0, frame->last_ref, 0, 0, NULL);
+  }
+  first_pass_encode(cpi, td, frame, &fp_frame->fp_data);
+}
+
+static int frame_parallel_first_pass(const VP9_COMP *cpi) {
+  const VP9_COMMON *const cm = &cpi->common;
+  const YV12_BUFFER_CONFIG *const last_source = cpi->unscaled_last_source;
+  // Frames of a batch are analysed at the coded size with sources as
+  // references, so resized frames are analysed one at a time.
+  return cpi->oxcf.frame_parallel_first_pass && cpi->oxcf.max_threads > 1 &&
+         !cpi->use_svc && cpi->Source->y_crop_width == cm->width &&
+         cpi->Source->y_crop_height == cm->height &&
+         (last_source == NULL || (last_source->y_crop_width == cm->width &&
+                                  last_source->y_crop_height == cm->height));
+}
+
+static void alloc_frame_parallel_buffers(VP9_COMP *cpi,
+                                         FIRSTPASS_PARALLEL_FRAME *fp_frame) {
+  VP9_COMMON *const cm = &cpi->common;
+  if (vpx_realloc_frame_buffer(&fp_frame->recon, cm->width, cm->height,
+                               cm->subsampling_x, cm->subsampling_y,
+#if CONFIG_VP9_HIGHBITDEPTH
+                               cm->use_highbitdepth,
+#endif
+                               VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
+                               NULL, NULL, NULL))
+    vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                       "Failed to allocate first pass frame buffer");
+  if (fp_frame->mi_alloc_size != cm->mi_alloc_size) {
+    vpx_free(fp_frame->mip);
+    vpx_free(fp_frame->mi_grid_base);
+    fp_frame->mi_alloc_size = 0;
+    CHECK_MEM_ERROR(&cm->error, fp_frame->mip,
+                    vpx_calloc(cm->mi_alloc_size, sizeof(*fp_frame->mip)));
+    CHECK_MEM_ERROR(
+        &cm->error, fp_frame->mi_grid_base,
+        vpx_calloc(cm->mi_alloc_size, sizeof(*fp_frame->mi_grid_base)));
+    fp_frame->mi_alloc_size = cm->mi_alloc_size;
+  }
+  fp_frame->frame.recon = &fp_frame->recon;
+  fp_frame->frame.mi = fp_frame->mip + cm->mi_stride + 1;
+  fp_frame->frame.mi_grid = fp_frame->mi_grid_base + cm->mi_stride + 1;
+}
+
+void vp9_free_first_pass_parallel_frames(TWO_PASS *twopass) {
+  int i;
+  for (i = 0; i < MAX_FP_PARALLEL_FRAMES; ++i) {
+    FIRSTPASS_PARALLEL_FRAME *const fp_frame = &twopass->fp_parallel_frames[i];
+    vpx_free_frame_buffer(&fp_frame->recon);
+    vpx_free(fp_frame->mip);
+    fp_frame->mip = NULL;
+    vpx_free(fp_frame->mi_grid_base);
+    fp_frame->mi_grid_base = NULL;
+    fp_frame->mi_alloc_size = 0;
+  }
+  vpx_free_frame_buffer(&twopass->fp_golden_source);
+  twopass->fp_golden_source_valid = 0;
+  twopass->fp_parallel_num_frames = 0;
+  twopass->fp_parallel_next = 0;
+}
+
+// Returns whether the golden reference is replaced by the last frame after
+// the first pass of the frame with the given stats.
+static int update_first_pass_golden(int sr_update_lag,
+                                    const FIRSTPASS_STATS *stats,
+                                    int frame_index) {
+  return sr_update_lag > 3 ||
+         (frame_index > 0 && stats->pcnt_inter > 0.20 &&
+          (stats->intra_error / DOUBLE_DIVIDE_CHECK(stats->coded_error)) >
+              2.0);
+}
+
+// Analyses the current frame and the frames after it in the lookahead on the
+// encoder threads, one frame per thread. Each frame uses the source before it
+// as its last reference in place of the reconstruction, and the source the
+// golden reference would be a reconstruction of at the start of the batch.
+static void analyse_frame_parallel_batch(VP9_COMP *cpi,
+                                         const struct lookahead_entry *source) {
+  VP9_COMMON *const cm = &cpi->common;
+  TWO_PASS *const twopass = &cpi->twopass;
+  const int max_frames =
+      VPXMIN(VPXMIN(cpi->oxcf.max_threads, MAX_FP_PARALLEL_FRAMES),
+             1 + (int)vp9_lookahead_depth(cpi->lookahead));
+  YV12_BUFFER_CONFIG *golden_ref = NULL;
+  const YV12_BUFFER_CONFIG *next_golden_source = NULL;
+  int sr_update_lag = twopass->sr_update_lag;
+  int num_frames;
+  int i;
+
+  if (cm->current_video_frame == 0)
+    golden_ref = cpi->Source;
+  else if (twopass->fp_golden_source_valid)
+    golden_ref = &twopass->fp_golden_source;
+
+  for (num_frames = 0; num_frames < max_frames; ++num_frames) {
+    FIRSTPASS_PARALLEL_FRAME *const fp_frame =
+        &twopass->fp_parallel_frames[num_frames];
+    FIRSTPASS_FRAME *const frame = &fp_frame->frame;
+    if (num_frames == 0) {
+      frame->source = cpi->Source;
+      frame->last_source = cpi->unscaled_last_source;
+      frame->recon = get_frame_new_buffer(cm);
+      frame->mi_grid = cm->mi_grid_visible;
+      frame->mi = cm->mi;
+      frame->intra_only = frame_is_intra_only(cm);
+      fp_frame->ts_start = source->ts_start;
+    } else {
+      struct lookahead_entry *const entry =
+          vp9_lookahead_peek(cpi->lookahead, num_frames - 1);
+      if (entry == NULL || entry->img.y_crop_width != cm->width ||
+          entry->img.y_crop_height != cm->height)
+        break;
+      alloc_frame_parallel_buffers(cpi, fp_frame);
+      frame->source = &entry->img;
+      frame->last_source = fp_frame[-1].frame.source;
+      frame->intra_only = (entry->flags & VPX_EFLAG_FORCE_KF) != 0;
+      fp_frame->ts_start = entry->ts_start;
+    }
+    frame->last_ref = frame->last_source;
+    frame->golden_ref = golden_ref;
+    frame->mb_float_stats = NULL;
+    frame->frame_index = (int)cm->current_video_frame + num_frames;
+  }
+
+  vp9_first_pass_frames_mt(cpi, num_frames);
+
+  // Follow the golden updates of the frames of the batch to find the source
+  // the golden reference of the next batch stands for.
+  for (i = 0; i < num_frames; ++i) {
+    FIRSTPASS_PARALLEL_FRAME *const fp_frame = &twopass->fp_parallel_frames[i];
+    first_pass_stat_calc(cpi, &fp_frame->stats, &fp_frame->fp_data);
+    fp_frame->stats.frame = fp_frame->frame.frame_index;
+    if (update_first_pass_golden(sr_update_lag, &fp_frame->stats,
+                                 fp_frame->frame.frame_index)) {
+      next_golden_source = fp_frame->frame.last_source;
+      sr_update_lag = 1;
+    } else {
+      ++sr_update_lag;
+    }
+    if (fp_frame->frame.frame_index == 0)
+      next_golden_source = fp_frame->frame.source;
+  }
+  if (next_golden_source != NULL) {
+    if (vpx_realloc_frame_buffer(&twopass->fp_golden_source, cm->width,
+                                 cm->height, cm->subsampling_x,
+                                 cm->subsampling_y,
+#if CONFIG_VP9_HIGHBITDEPTH
+                                 cm->use_highbitdepth,
+#endif
+                                 VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
+                                 NULL, NULL, NULL))
+      vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                         "Failed to allocate first pass golden buffer");
+    vp9_copy_and_extend_frame(next_golden_source, &twopass->fp_golden_source);
+    twopass->fp_golden_source_valid = 1;
   }
+
+  twopass->fp_parallel_num_frames = num_frames;
+  twopass->fp_parallel_next = 0;
+}
+
+// Returns the stats of the current frame from the frame parallel first pass,
+// analysing the next batch of frames when the frame is not in the current
+// one.
+static FIRSTPASS_STATS frame_parallel_first_pass_stats(
+    VP9_COMP *cpi, const struct lookahead_entry *source) {
+  TWO_PASS *const twopass = &cpi->twopass;
+  if (twopass->fp_parallel_next == twopass->fp_parallel_num_frames ||
+      twopass->fp_parallel_frames[twopass->fp_parallel_next].ts_start !=
+          source->ts_start) {
+    analyse_frame_parallel_batch(cpi, source);
+  }
+  return twopass->fp_parallel_frames[twopass->fp_parallel_next++].stats;
 }
 
 void vp9_first_pass(VP9_COMP *cpi, const struct lookahead_entry *source) {
@@ -1355,6 +1544,8 @@ void vp9_first_pass(VP9_COMP *cpi, const struct lookahead_entry *source) {
   VP9_COMMON *const cm = &cpi->common;
   MACROBLOCKD *const xd = &x->e_mbd;
   TWO_PASS *twopass = &cpi->twopass;
+  FIRSTPASS_FRAME *const fp_frame = &twopass->fp_frame;
+  const int frame_parallel = frame_parallel_first_pass(cpi);
 
   YV12_BUFFER_CONFIG *const lst_yv12 = get_ref_frame_buffer(cpi, LAST_FRAME);
   YV12_BUFFER_CONFIG *gld_yv12 = get_ref_frame_buffer(cpi, GOLDEN_FRAME);
@@ -1403,14 +1594,39 @@ void vp9_first_pass(VP9_COMP *cpi, const struct lookahead_entry *source) {
         &cm->error, cpi->twopass.fp_mb_float_stats,
         vpx_calloc(cm->MBs * sizeof(*cpi->twopass.fp_mb_float_stats), 1));
 
+  fp_frame->source = cpi->Source;
+  fp_frame->last_source = cpi->unscaled_last_source;
+  fp_frame->last_ref = lst_yv12;
+  fp_frame->golden_ref = gld_yv12;
+  fp_frame->recon = new_yv12;
+  fp_frame->mi_grid = cm->mi_grid_visible;
+  fp_frame->mi = cm->mi;
+  fp_frame->mb_float_stats =
+      cpi->row_mt_bit_exact ? cpi->twopass.fp_mb_float_stats : NULL;
+  fp_frame->frame_index = (int)cm->current_video_frame;
+  fp_frame->intra_only = frame_is_intra_only(cm);
+
+  if (!frame_parallel) {
+    // The golden reference of the frame parallel first pass is only followed
+    // through the frames it analyses.
+    twopass->fp_parallel_num_frames = 0;
+    twopass->fp_parallel_next = 0;
+    twopass->fp_golden_source_valid = 0;
+  }
+
   {
     FIRSTPASS_STATS fps;
     TileDataEnc *first_tile_col;
-    if (!cpi->row_mt) {
+    if (frame_parallel) {
+      cm->log2_tile_cols = 0;
+      cpi->row_mt_sync_read_ptr = vp9_row_mt_sync_read_dummy;
+      cpi->row_mt_sync_write_ptr = vp9_row_mt_sync_write_dummy;
+      fps = frame_parallel_first_pass_stats(cpi, source);
+    } else if (!cpi->row_mt) {
       cm->log2_tile_cols = 0;
       cpi->row_mt_sync_read_ptr = vp9_row_mt_sync_read_dummy;
       cpi->row_mt_sync_write_ptr = vp9_row_mt_sync_write_dummy;
-      first_pass_encode(cpi, fp_acc_data);
+      first_pass_encode(cpi, &cpi->td, fp_frame, fp_acc_data);
       first_pass_stat_calc(cpi, &fps, fp_acc_data);
     } else {
       cpi->row_mt_sync_read_ptr = vp9_row_mt_sync_read;
@@ -1438,11 +1654,9 @@ void vp9_first_pass(VP9_COMP *cpi, const struct lookahead_entry *source) {
 
   // Copy the previous Last Frame back into gf and arf buffers if
   // the prediction is good enough... but also don't allow it to lag too far.
-  if ((twopass->sr_update_lag > 3) ||
-      ((cm->current_video_frame > 0) &&
-       (twopass->this_frame_stats.pcnt_inter > 0.20) &&
-       ((twopass->this_frame_stats.intra_error /
-         DOUBLE_DIVIDE_CHECK(twopass->this_frame_stats.coded_error)) > 2.0))) {
+  if (update_first_pass_golden(twopass->sr_update_lag,
+                               &twopass->this_frame_stats,
+                               (int)cm->current_video_frame)) {
     if (gld_yv12 != NULL) {
       ref_cnt_fb(pool->frame_bufs, &cm->ref_frame_map[cpi->gld_fb_idx],
                  cm->ref_frame_map[cpi->lst_fb_idx]);
@@ -1729,6 +1943,60 @@ void vp9_init_second_pass(VP9_COMP *cpi) {
   twopass->arnr_strength_adjustment = 0;
 }
 
+int vp9_set_second_pass_chunk(VP9_COMP *cpi, int first_frame,
+                              int num_frames) {
+  const VP9EncoderConfig *const oxcf = &cpi->oxcf;
+  TWO_PASS *const twopass = &cpi->twopass;
+  const FIRSTPASS_STATS *const stats = oxcf->two_pass_stats_in.buf;
+  const int clip_frames =
+      (int)(oxcf->two_pass_stats_in.sz / sizeof(*stats)) - 1;
+  const FIRSTPASS_STATS *const chunk_start = stats + first_frame;
+  const FIRSTPASS_STATS *const chunk_end = chunk_start + num_frames;
+  const FIRSTPASS_STATS *s;
+  double clip_score = 0.0;
+  double chunk_score = 0.0;
+  double av_err;
+
+  if (oxcf->pass != 2 || cpi->svc.number_spatial_layers > 1 ||
+      cpi->svc.number_temporal_layers > 1)
+    return -1;
+  if (cpi->common.current_video_frame > 0 ||
+      (cpi->lookahead != NULL && vp9_lookahead_depth(cpi->lookahead) > 0))
+    return -1;
+  if (first_frame < 0 || num_frames < 1 || first_frame > clip_frames ||
+      num_frames > clip_frames - first_frame)
+    return -1;
+
+  vpx_clear_system_state();
+
+  // The scores of the frames keep their distribution over the whole clip,
+  // given by its total stats, so that the chunks of a clip coded by separate
+  // encoders share its bits as a single encoder would.
+  av_err = get_distribution_av_err(cpi, twopass);
+  zero_stats(&twopass->total_left_stats);
+  for (s = stats; s < stats + clip_frames; ++s) {
+    const double score =
+        calculate_norm_frame_score(cpi, twopass, oxcf, s, av_err);
+    clip_score += score;
+    if (s >= chunk_start && s < chunk_end) {
+      chunk_score += score;
+      accumulate_stats(&twopass->total_left_stats, s);
+    }
+  }
+  twopass->normalized_score_left = chunk_score;
+  twopass->bits_left =
+      (int64_t)(twopass->total_stats.duration * oxcf->target_bandwidth /
+                10000000.0 * chunk_score / DOUBLE_DIVIDE_CHECK(clip_score));
+
+  // Key frame and golden frame groups end with the chunk.
+  twopass->stats_in_start = chunk_start;
+  twopass->stats_in = chunk_start;
+  twopass->stats_in_end = chunk_end;
+  fps_init_first_pass_info(&twopass->first_pass_info, chunk_start,
+                           num_frames);
+  return 0;
+}
+
 /* This function considers how the quality of prediction may be deteriorating
  * with distance. It compares the coded error for the last frame and the
  * second reference frame (usually two frames old) and also applies a factor
@@ -3644,8 +3912,8 @@ void vp9_rc_get_second_pass_params(VP9_COMP *cpi) {
   if (cpi->oxcf.rc_mode == VPX_Q) {
     twopass->active_worst_quality = cpi->oxcf.cq_level;
   } else if (cm->current_video_frame == 0) {
-    const int frames_left =
-        (int)(twopass->total_stats.count - cm->current_video_frame);
+    const int frames_left = fps_get_num_frames(&twopass->first_pass_info) -
+                            cm->current_video_frame;
     // Special case code for first frame.
     int64_t section_target_bandwidth = twopass->bits_left / frames_left;
     section_target_bandwidth = VPXMIN(section_target_bandwidth, INT_MAX);
@@ -3854,3 +4122,25 @@ FIRSTPASS_STATS vp9_get_frame_stats(const TWO_PASS *twopass) {
 FIRSTPASS_STATS vp9_get_total_stats(const TWO_PASS *twopass) {
   return twopass->total_stats;
 }
+
+void vp9_merge_first_pass_stats(const FIRSTPASS_STATS *const *chunk_stats,
+                                const int *chunk_frames, int num_chunks,
+                                FIRSTPASS_STATS *stats) {
+  FIRSTPASS_STATS total_stats;
+  int num_frames = 0;
+  int i, j;
+
+  // The total is accumulated over the frames in the order of the first pass
+  // of the whole clip, so that it is the same as that pass would give.
+  zero_stats(&total_stats);
+  for (i = 0; i < num_chunks; ++i) {
+    for (j = 0; j < chunk_frames[i]; ++j) {
+      FIRSTPASS_STATS *const this_frame = &stats[num_frames];
+      *this_frame = chunk_stats[i][j];
+      this_frame->frame = num_frames;
+      accumulate_stats(&total_stats, this_frame);
+      ++num_frames;
+    }
+  }
+  stats[num_frames] = total_stats;
+}
@@ -27,6 +27,9 @@ extern "C" {
 #define MAX_ARF_LAYERS 6
 #define SECTION_NOISE_DEF 250.0
 
+// Maximum number of frames the frame parallel first pass analyses at once.
+#define MAX_FP_PARALLEL_FRAMES 16
+
 typedef struct {
   double frame_mb_intra_factor;
   double frame_mb_brightness_factor;
@@ -59,6 +62,36 @@ typedef struct {
   int new_mv_count;
 } FIRSTPASS_DATA;
 
+// The buffers the first pass reads and writes to analyse a frame.
+typedef struct {
+  YV12_BUFFER_CONFIG *source;
+  YV12_BUFFER_CONFIG *last_source;
+  YV12_BUFFER_CONFIG *last_ref;
+  YV12_BUFFER_CONFIG *golden_ref;
+  YV12_BUFFER_CONFIG *recon;
+  MODE_INFO **mi_grid;
+  MODE_INFO *mi;
+  // Per-MB floating point stats, or NULL when they are not kept.
+  FP_MB_FLOAT_STATS *mb_float_stats;
+  int frame_index;
+  int intra_only;
+} FIRSTPASS_FRAME;
+
+// A frame analysed ahead of its turn by the frame parallel first pass. The
+// previous source stands in for the reconstructed last frame, so that frames
+// do not depend on each other.
+typedef struct {
+  FIRSTPASS_FRAME frame;
+  FIRSTPASS_DATA fp_data;
+  FIRSTPASS_STATS stats;
+  int64_t ts_start;
+  // Scratch buffers of the frames other than the first of a batch.
+  YV12_BUFFER_CONFIG recon;
+  MODE_INFO *mip;
+  MODE_INFO **mi_grid_base;
+  int mi_alloc_size;
+} FIRSTPASS_PARALLEL_FRAME;
+
 typedef enum {
   KF_UPDATE = 0,
   LF_UPDATE = 1,
@@ -154,6 +187,18 @@ typedef struct {
 
   FP_MB_FLOAT_STATS *fp_mb_float_stats;
 
+  // The frame being analysed by the first pass.
+  FIRSTPASS_FRAME fp_frame;
+
+  // Frames analysed by the frame parallel first pass, of which the first
+  // fp_parallel_next have been output.
+  FIRSTPASS_PARALLEL_FRAME fp_parallel_frames[MAX_FP_PARALLEL_FRAMES];
+  int fp_parallel_num_frames;
+  int fp_parallel_next;
+  // Copy of the source that is the golden reference of the next batch.
+  YV12_BUFFER_CONFIG fp_golden_source;
+  int fp_golden_source_valid;
+
   // An indication of the content type of the current frame
   FRAME_CONTENT_TYPE fr_content_type;
 
@@ -209,11 +254,23 @@ void vp9_end_first_pass(struct VP9_COMP *cpi);
 
 void vp9_first_pass_encode_tile_mb_row(struct VP9_COMP *cpi,
                                        struct ThreadData *td,
+                                       const FIRSTPASS_FRAME *fp_frame,
                                        FIRSTPASS_DATA *fp_acc_data,
                                        struct TileDataEnc *tile_data,
                                        MV *best_ref_mv, int mb_row);
+// Analyses a whole frame of the frame parallel first pass on the given
+// thread.
+void vp9_first_pass_analyse_frame(struct VP9_COMP *cpi, struct ThreadData *td,
+                                  FIRSTPASS_PARALLEL_FRAME *fp_frame);
+void vp9_free_first_pass_parallel_frames(TWO_PASS *twopass);
 
 void vp9_init_second_pass(struct VP9_COMP *cpi);
+// Restricts the second pass to the num_frames frames of the clip from
+// first_frame, with the share of the bits of the clip that the first pass
+// stats give them. Returns -1 if the chunk is not in the clip or the encoder
+// has already been given frames.
+int vp9_set_second_pass_chunk(struct VP9_COMP *cpi, int first_frame,
+                              int num_frames);
 void vp9_rc_get_second_pass_params(struct VP9_COMP *cpi);
 void vp9_init_vizier_params(TWO_PASS *const twopass, int screen_area);
 
@@ -229,6 +286,12 @@ int vp9_get_frames_to_next_key(const struct VP9EncoderConfig *oxcf,
                                int min_gf_interval);
 
 FIRSTPASS_STATS vp9_get_frame_stats(const TWO_PASS *twopass);
+// Writes the stats of the frames of consecutive chunks of a clip, given by
+// the first passes of the chunks, as the stats of the whole clip followed by
+// their total.
+void vp9_merge_first_pass_stats(const FIRSTPASS_STATS *const *chunk_stats,
+                                const int *chunk_frames, int num_chunks,
+                                FIRSTPASS_STATS *stats);
 FIRSTPASS_STATS vp9_get_total_stats(const TWO_PASS *twopass);
 
 #ifdef __cplusplus
@@ -11,6 +11,7 @@
 #include <assert.h>
 #include <limits.h>
 
+#include "./vpx_dsp_rtcd.h"
 #include "./vpx_scale_rtcd.h"
 #include "vpx_dsp/psnr.h"
 #include "vpx_mem/vpx_mem.h"
@@ -19,8 +20,10 @@
 #include "vp9/common/vp9_loopfilter.h"
 #include "vp9/common/vp9_onyxc_int.h"
 #include "vp9/common/vp9_quant_common.h"
+#include "vp9/common/vp9_thread_common.h"
 
 #include "vp9/encoder/vp9_encoder.h"
+#include "vp9/encoder/vp9_ethread.h"
 #include "vp9/encoder/vp9_picklpf.h"
 #include "vp9/encoder/vp9_quantize.h"
 
@@ -75,6 +78,362 @@ static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
   return filt_err;
 }
 
+// The fused search evaluates up to this many levels in one pass: the first
+// step of the search tries the middle, low and high levels.
+#define MAX_SEARCH_LEVELS 3
+
+// Scratch rows of a superblock row: the last lines of the superblock row above,
+// which the horizontal filter of its top edge changes, then its own lines.
+#define SCRATCH_TOP_LINES 8
+#define SCRATCH_LINES (SCRATCH_TOP_LINES + MI_BLOCK_SIZE * MI_SIZE)
+
+typedef struct LpfSearchRows {
+  VP9_COMP *cpi;
+  const YV12_BUFFER_CONFIG *sd;
+  const int *levels;
+  int num_levels;
+  // Superblock rows filtered, in mi units.
+  int start;
+  int stop;
+  // Scratch rows are reused every num_slots superblock rows.
+  int num_slots;
+  int stride;
+  // log2 of the bytes per pixel.
+  int shift;
+  // NULL when single threaded.
+  VP9LfSync *lf_sync;
+} LpfSearchRows;
+
+typedef struct LpfSearchWorkerData {
+  LpfSearchRows *rows;
+  int64_t sse[MAX_SEARCH_LEVELS];
+} LpfSearchWorkerData;
+
+static int64_t get_sse(const uint8_t *a, int a_stride, const uint8_t *b,
+                       int b_stride, int width, int height, int shift) {
+  int64_t sse = 0;
+  int x, y;
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (shift) {
+    const uint16_t *const a16 = CONVERT_TO_SHORTPTR(a);
+    const uint16_t *const b16 = CONVERT_TO_SHORTPTR(b);
+    for (y = 0; y + 16 <= height; y += 16) {
+      for (x = 0; x + 16 <= width; x += 16) {
+        sse += vpx_highbd_sse(a + y * a_stride + x, a_stride,
+                              b + y * b_stride + x, b_stride, 16, 16);
+      }
+    }
+    for (y = 0; y < height; ++y) {
+      for (x = (y < (height & ~15)) ? (width & ~15) : 0; x < width; ++x) {
+        const int diff = a16[y * a_stride + x] - b16[y * b_stride + x];
+        sse += diff * diff;
+      }
+    }
+    return sse;
+  }
+#else
+  (void)shift;
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  for (y = 0; y + 16 <= height; y += 16) {
+    for (x = 0; x + 16 <= width; x += 16) {
+      sse += vpx_sse(a + y * a_stride + x, a_stride, b + y * b_stride + x,
+                     b_stride, 16, 16);
+    }
+  }
+  for (y = 0; y < height; ++y) {
+    for (x = (y < (height & ~15)) ? (width & ~15) : 0; x < width; ++x) {
+      const int diff = a[y * a_stride + x] - b[y * b_stride + x];
+      sse += diff * diff;
+    }
+  }
+  return sse;
+}
+
+// Returns the luma pixel at (x, y) of 'buf', as the loop filter expects it.
+static uint8_t *get_y_pixel(const YV12_BUFFER_CONFIG *buf, int x, int y) {
+  return buf->y_buffer + y * buf->y_stride + x;
+}
+
+// Returns the pixels of the scratch rows of level 'i' of the superblock row
+// at 'mi_row', from 'line' of the rows and column 'x'.
+static uint8_t *get_scratch_pixel(const LpfSearchRows *rows, int mi_row, int i,
+                                  int line, int x) {
+  const int slot = ((mi_row - rows->start) >> MI_BLOCK_SIZE_LOG2) %
+                   rows->num_slots;
+  const size_t offset =
+      ((size_t)(slot * MAX_SEARCH_LEVELS + i) * SCRATCH_LINES + line) *
+          rows->stride +
+      x;
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (rows->shift) {
+    return CONVERT_TO_BYTEPTR((uint16_t *)rows->cpi->lpf_search_rows + offset);
+  }
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  return rows->cpi->lpf_search_rows + offset;
+}
+
+static void copy_lines(const uint8_t *src, int src_stride, uint8_t *dst,
+                       int dst_stride, int width, int height, int shift) {
+  int y;
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (shift) {
+    const uint16_t *src16 = CONVERT_TO_SHORTPTR(src);
+    uint16_t *dst16 = CONVERT_TO_SHORTPTR(dst);
+    for (y = 0; y < height; ++y) {
+      memcpy(dst16, src16, width * sizeof(*dst16));
+      src16 += src_stride;
+      dst16 += dst_stride;
+    }
+    return;
+  }
+#else
+  (void)shift;
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  for (y = 0; y < height; ++y) {
+    memcpy(dst, src, width);
+    src += src_stride;
+    dst += dst_stride;
+  }
+}
+
+static LOOP_FILTER_MASK *get_search_lfm(const VP9_COMP *cpi, int i,
+                                        int mi_row, int mi_col) {
+  const struct loopfilter *const lf = &cpi->common.lf;
+  const int sb_rows = (cpi->common.mi_rows + MI_BLOCK_SIZE - 1) >> 3;
+  return &cpi->lpf_search_lfm[(i * sb_rows + (mi_row >> 3)) * lf->lfm_stride +
+                              (mi_col >> 3)];
+}
+
+// Filters the superblock at (mi_row, mi_col) at each level, in its scratch
+// rows.
+static void filter_search_sb(const LpfSearchRows *rows, int mi_row, int mi_col,
+                             struct macroblockd_plane *plane) {
+  VP9_COMMON *const cm = &rows->cpi->common;
+  const YV12_BUFFER_CONFIG *const frame = cm->frame_to_show;
+  const int x = mi_col * MI_SIZE;
+  const int y = mi_row * MI_SIZE;
+  const int width = VPXMIN(cm->mi_cols - mi_col, MI_BLOCK_SIZE) * MI_SIZE;
+  const int height = VPXMIN(cm->mi_rows - mi_row, MI_BLOCK_SIZE) * MI_SIZE;
+  int i;
+
+  for (i = 0; i < rows->num_levels; ++i) {
+    uint8_t *const dst =
+        get_scratch_pixel(rows, mi_row, i, SCRATCH_TOP_LINES, x);
+    copy_lines(get_y_pixel(frame, x, y), frame->y_stride, dst, rows->stride,
+               width, height, rows->shift);
+    if (mi_row > rows->start) {
+      // The last lines of the superblock above, as filtered at this level.
+      copy_lines(get_scratch_pixel(rows, mi_row - MI_BLOCK_SIZE, i,
+                                   SCRATCH_LINES - SCRATCH_TOP_LINES, x),
+                 rows->stride, get_scratch_pixel(rows, mi_row, i, 0, x),
+                 rows->stride, width, SCRATCH_TOP_LINES, rows->shift);
+    } else if (mi_row > 0) {
+      copy_lines(get_y_pixel(frame, x, y - SCRATCH_TOP_LINES), frame->y_stride,
+                 get_scratch_pixel(rows, mi_row, i, 0, x), rows->stride, width,
+                 SCRATCH_TOP_LINES, rows->shift);
+    }
+
+    if (rows->levels[i]) {
+      plane->dst.buf = dst;
+      plane->dst.stride = rows->stride;
+      vp9_filter_block_plane_ss00(cm, plane, mi_row,
+                                  get_search_lfm(rows->cpi, i, mi_row, mi_col));
+    }
+  }
+}
+
+// Adds the error of the pixels of the superblock at (mi_row, mi_col) that no
+// other superblock filters any more at each level to 'sse'. These are the
+// lines above the superblock its top edge changed and its own lines, but for
+// the last ones that the superblock below changes.
+static void add_search_sb_sse(const LpfSearchRows *rows, int mi_row,
+                              int mi_col, int64_t *sse) {
+  const YV12_BUFFER_CONFIG *const sd = rows->sd;
+  const int x = mi_col * MI_SIZE;
+  const int y = mi_row * MI_SIZE;
+  const int width = VPXMIN(sd->y_crop_width - x, MI_BLOCK_SIZE * MI_SIZE);
+  const int top = mi_row ? y - SCRATCH_TOP_LINES : 0;
+  const int bottom =
+      VPXMIN(sd->y_crop_height,
+             y + MI_BLOCK_SIZE * MI_SIZE -
+                 (mi_row + MI_BLOCK_SIZE < rows->stop ? SCRATCH_TOP_LINES : 0));
+  int i;
+
+  for (i = 0; i < rows->num_levels; ++i) {
+    sse[i] += get_sse(
+        get_y_pixel(sd, x, top), sd->y_stride,
+        get_scratch_pixel(rows, mi_row, i, top - y + SCRATCH_TOP_LINES, x),
+        rows->stride, width, bottom - top, rows->shift);
+  }
+}
+
+static void search_filter_row(const LpfSearchRows *rows, int mi_row,
+                              int64_t *sse) {
+  const VP9_COMMON *const cm = &rows->cpi->common;
+  const int sb_cols = mi_cols_aligned_to_sb(cm->mi_cols) >> MI_BLOCK_SIZE_LOG2;
+  const int r = (mi_row - rows->start) >> MI_BLOCK_SIZE_LOG2;
+  struct macroblockd_plane plane;
+  int mi_col;
+
+  memset(&plane, 0, sizeof(plane));
+
+  for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE) {
+    const int c = mi_col >> MI_BLOCK_SIZE_LOG2;
+    if (rows->lf_sync) vp9_lf_sync_read(rows->lf_sync, r, c);
+
+    filter_search_sb(rows, mi_row, mi_col, &plane);
+
+    // The vertical edges of this superblock change the last columns of the
+    // superblock to its left.
+    if (mi_col) add_search_sb_sse(rows, mi_row, mi_col - MI_BLOCK_SIZE, sse);
+    if (mi_col + MI_BLOCK_SIZE >= cm->mi_cols)
+      add_search_sb_sse(rows, mi_row, mi_col, sse);
+
+    if (rows->lf_sync) vp9_lf_sync_write(rows->lf_sync, r, c, sb_cols);
+  }
+}
+
+static int search_filter_row_worker(void *arg1, void *arg2) {
+  LpfSearchRows *const rows = (LpfSearchRows *)arg1;
+  LpfSearchWorkerData *const data = (LpfSearchWorkerData *)arg2;
+  int mi_row;
+  while ((mi_row = vp9_lf_sync_claim_row(rows->lf_sync, rows->stop)) >= 0) {
+    search_filter_row(rows, mi_row, data->sse);
+  }
+  return 1;
+}
+
+// Sets ss_err[] of each of the 'num_levels' filter levels in 'levels' not
+// already known to the error of the frame filtered at that level, as
+// try_filter_frame() would. The levels are evaluated together one
+// superblock row at a time, in scratch rows that stay in cache, so the frame
+// is neither filtered nor restored.
+static void try_filter_levels(const YV12_BUFFER_CONFIG *sd,
+                              VP9_COMP *const cpi, const int *candidates,
+                              int num_candidates, int partial_frame,
+                              int64_t *ss_err) {
+  VP9_COMMON *const cm = &cpi->common;
+  const YV12_BUFFER_CONFIG *const frame = cm->frame_to_show;
+  const int sb_rows = (cm->mi_rows + MI_BLOCK_SIZE - 1) >> 3;
+  const int shift = cm->use_highbitdepth;
+  int levels[MAX_SEARCH_LEVELS];
+  LpfSearchWorkerData worker_data[MAX_NUM_THREADS];
+  LpfSearchRows rows;
+  int num_levels = 0;
+  int num_workers;
+  int top, bottom;
+  int64_t sse = 0;
+  int i, j, mi_row, mi_col;
+
+  for (i = 0; i < num_candidates; ++i) {
+    const int level = candidates[i];
+    int known = ss_err[level] >= 0;
+    for (j = 0; j < num_levels; ++j) known |= levels[j] == level;
+    if (!known) levels[num_levels++] = level;
+  }
+  if (!num_levels) return;
+
+  rows.cpi = cpi;
+  rows.sd = sd;
+  rows.levels = levels;
+  rows.num_levels = num_levels;
+  rows.start = 0;
+  rows.stop = cm->mi_rows;
+  if (partial_frame && cm->mi_rows > 8) {
+    rows.start = (cm->mi_rows >> 1) & 0xfffffff8;
+    rows.stop = rows.start + VPXMAX(cm->mi_rows / 8, 8);
+  }
+  num_workers = VPXMIN(
+      cpi->num_workers,
+      (rows.stop - rows.start + MI_BLOCK_SIZE - 1) >> MI_BLOCK_SIZE_LOG2);
+  num_workers = VPXMAX(num_workers, 1);
+  rows.num_slots = num_workers + 1;
+  rows.stride = ALIGN_POWER_OF_TWO(cm->mi_cols * MI_SIZE, 5);
+  rows.shift = shift;
+  rows.lf_sync = num_workers > 1 ? &cpi->lf_row_sync : NULL;
+
+  {
+    const size_t lfm_size = (size_t)MAX_SEARCH_LEVELS * sb_rows *
+                            cm->lf.lfm_stride * sizeof(*cpi->lpf_search_lfm);
+    const size_t rows_size = ((size_t)rows.num_slots * MAX_SEARCH_LEVELS *
+                              SCRATCH_LINES * rows.stride)
+                             << shift;
+    if (lfm_size > cpi->lpf_search_lfm_size) {
+      vpx_free(cpi->lpf_search_lfm);
+      cpi->lpf_search_lfm_size = 0;
+      CHECK_MEM_ERROR(&cm->error, cpi->lpf_search_lfm, vpx_malloc(lfm_size));
+      cpi->lpf_search_lfm_size = lfm_size;
+    }
+    if (rows_size > cpi->lpf_search_rows_size) {
+      vpx_free(cpi->lpf_search_rows);
+      cpi->lpf_search_rows_size = 0;
+      CHECK_MEM_ERROR(&cm->error, cpi->lpf_search_rows,
+                      vpx_calloc(rows_size, 1));
+      cpi->lpf_search_rows_size = rows_size;
+    }
+  }
+
+  // Build and adjust the masks of each level up front, as cm->lf_info holds
+  // the filter levels of one frame level at a time.
+  for (i = 0; i < num_levels; ++i) {
+    if (!levels[i]) continue;
+    vp9_loop_filter_frame_init(cm, levels[i]);
+    for (mi_row = rows.start; mi_row < rows.stop; mi_row += MI_BLOCK_SIZE) {
+      MODE_INFO **const mi = cm->mi_grid_visible + mi_row * cm->mi_stride;
+      for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE) {
+        LOOP_FILTER_MASK *const lfm = get_search_lfm(cpi, i, mi_row, mi_col);
+        vp9_setup_mask(cm, mi_row, mi_col, mi + mi_col, cm->mi_stride, lfm);
+        vp9_adjust_mask(cm, mi_row, mi_col, lfm);
+      }
+    }
+  }
+
+  for (i = 0; i < num_workers; ++i) {
+    worker_data[i].rows = &rows;
+    memset(worker_data[i].sse, 0, sizeof(worker_data[i].sse));
+  }
+
+  if (num_workers > 1) {
+    const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+    vp9_lf_sync_rows_init(&cpi->lf_row_sync, cm, rows.start, num_workers);
+    for (i = 0; i < num_workers; ++i) {
+      VPxWorker *const worker = &cpi->workers[i];
+      worker->hook = search_filter_row_worker;
+      worker->data1 = &rows;
+      worker->data2 = &worker_data[i];
+      if (i == num_workers - 1) {
+        winterface->execute(worker);
+      } else {
+        winterface->launch(worker);
+      }
+    }
+    for (i = 0; i < num_workers; ++i) winterface->sync(&cpi->workers[i]);
+  } else {
+    for (mi_row = rows.start; mi_row < rows.stop; mi_row += MI_BLOCK_SIZE)
+      search_filter_row(&rows, mi_row, worker_data[0].sse);
+  }
+
+  // The lines above and below the filtered rows are the same at every level.
+  top = rows.start ? rows.start * MI_SIZE - SCRATCH_TOP_LINES : 0;
+  bottom = VPXMIN(sd->y_crop_height,
+                  (rows.start + ((rows.stop - rows.start - 1) & ~7) +
+                   MI_BLOCK_SIZE) *
+                      MI_SIZE);
+  sse += get_sse(get_y_pixel(sd, 0, 0), sd->y_stride, get_y_pixel(frame, 0, 0),
+                 frame->y_stride, sd->y_crop_width, top, shift);
+  if (bottom < sd->y_crop_height) {
+    sse += get_sse(get_y_pixel(sd, 0, bottom), sd->y_stride,
+                   get_y_pixel(frame, 0, bottom), frame->y_stride,
+                   sd->y_crop_width, sd->y_crop_height - bottom, shift);
+  }
+
+  for (i = 0; i < num_levels; ++i) {
+    int64_t level_sse = sse;
+    for (j = 0; j < num_workers; ++j) level_sse += worker_data[j].sse[i];
+    ss_err[levels[i]] = level_sse;
+  }
+}
+
 static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
                                int partial_frame) {
   const VP9_COMMON *const cm = &cpi->common;
@@ -96,19 +455,36 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
   // Set each entry to -1
   memset(ss_err, 0xFF, sizeof(ss_err));
 
-  //  Make a copy of the unfiltered / processed recon buffer
-  vpx_yv12_copy_y(cm->frame_to_show, &cpi->last_frame_uf);
+  if (cpi->sf.fused_lpf_search) {
+    // The first step of the search also tries the low and high levels.
+    const int levels[MAX_SEARCH_LEVELS] = {
+      filt_mid, VPXMAX(filt_mid - filter_step, min_filter_level),
+      VPXMIN(filt_mid + filter_step, max_filter_level)
+    };
+    try_filter_levels(sd, cpi, levels, MAX_SEARCH_LEVELS, partial_frame,
+                      ss_err);
+  } else {
+    //  Make a copy of the unfiltered / processed recon buffer
+    vpx_yv12_copy_y(cm->frame_to_show, &cpi->last_frame_uf);
 
-  best_err = try_filter_frame(sd, cpi, filt_mid, partial_frame);
+    ss_err[filt_mid] = try_filter_frame(sd, cpi, filt_mid, partial_frame);
+  }
+  best_err = ss_err[filt_mid];
   filt_best = filt_mid;
-  ss_err[filt_mid] = best_err;
 
   while (filter_step > 0) {
     const int filt_high = VPXMIN(filt_mid + filter_step, max_filter_level);
     const int filt_low = VPXMAX(filt_mid - filter_step, min_filter_level);
+    int64_t bias;
+
+    if (cpi->sf.fused_lpf_search) {
+      const int levels[2] = { filt_direction <= 0 ? filt_low : filt_mid,
+                              filt_direction >= 0 ? filt_high : filt_mid };
+      try_filter_levels(sd, cpi, levels, 2, partial_frame, ss_err);
+    }
 
     // Bias against raising loop filter in favor of lowering it.
-    int64_t bias = (best_err >> (15 - (filt_mid / 8))) * filter_step;
+    bias = (best_err >> (15 - (filt_mid / 8))) * filter_step;
 
     if ((cpi->oxcf.pass == 2) && (section_intra_rating < 20))
       bias = (bias * section_intra_rating) / 20;
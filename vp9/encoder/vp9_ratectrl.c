@@ -2686,8 +2686,9 @@ static void vbr_rate_correction(VP9_COMP *cpi, int *this_frame_target) {
   RATE_CONTROL *const rc = &cpi->rc;
   int64_t vbr_bits_off_target = rc->vbr_bits_off_target;
   int64_t frame_target = *this_frame_target;
-  int frame_window = (int)VPXMIN(
-      16, cpi->twopass.total_stats.count - cpi->common.current_video_frame);
+  int frame_window =
+      VPXMIN(16, fps_get_num_frames(&cpi->twopass.first_pass_info) -
+                     (int)cpi->common.current_video_frame);
 
   // Calcluate the adjustment to rate for this frame.
   if (frame_window > 0) {
@@ -23,6 +23,13 @@ static MESH_PATTERN best_quality_mesh_pattern[2][MAX_MESH_STEP] = {
   { { 64, 8 }, { 28, 4 }, { 15, 1 }, { 7, 1 } },
 };
 
+// Whether the speed features that depend on the threading are set as for
+// several threads, which is also the case with one thread when the output must
+// not depend on the number of threads.
+static int use_multi_thread_features(const VP9EncoderConfig *oxcf) {
+  return oxcf->max_threads > 1 || oxcf->thread_invariant;
+}
+
 #if !CONFIG_REALTIME_ONLY
 // Define 3 mesh density levels to control the number of searches.
 #define MESH_DENSITY_LEVELS 3
@@ -714,7 +721,7 @@ static void set_rt_speed_feature_framesize_independent(
       if (svc->non_reference_frame)
         sf->mv.subpel_search_method = SUBPEL_TREE_PRUNED_EVENMORE;
     }
-    if (cpi->use_svc && cpi->row_mt && cpi->oxcf.max_threads > 1)
+    if (cpi->use_svc && cpi->row_mt && use_multi_thread_features(&cpi->oxcf))
       sf->adaptive_rd_thresh_row_mt = 1;
     // Enable partition copy. For SVC only enabled for top spatial resolution
     // layer.
@@ -756,7 +763,7 @@ static void set_rt_speed_feature_framesize_independent(
     else
       sf->nonrd_keyframe = 1;
     if (!cpi->use_svc) cpi->max_copied_frame = 4;
-    if (cpi->row_mt && cpi->oxcf.max_threads > 1)
+    if (cpi->row_mt && use_multi_thread_features(&cpi->oxcf))
       sf->adaptive_rd_thresh_row_mt = 1;
     // Enable ML based partition for low res.
     if (!frame_is_intra_only(cm) && cm->width * cm->height <= 352 * 288) {
@@ -912,7 +919,7 @@ void vp9_set_speed_features_framesize_dependent(VP9_COMP *cpi, int speed) {
   // It can be used in realtime when adaptive_rd_thresh_row_mt is enabled since
   // adaptive_rd_thresh is defined per-row for non-rd pickmode.
   if (!sf->adaptive_rd_thresh_row_mt && cpi->row_mt_bit_exact &&
-      oxcf->max_threads > 1)
+      use_multi_thread_features(oxcf))
     sf->adaptive_rd_thresh = 0;
 }
 
@@ -990,6 +997,7 @@ void vp9_set_speed_features_framesize_independent(VP9_COMP *cpi, int speed) {
   sf->use_uv_intra_rd_estimate = 0;
   sf->allow_skip_recode = 0;
   sf->lpf_pick = LPF_PICK_FROM_FULL_IMAGE;
+  sf->fused_lpf_search = 1;
   sf->use_fast_coef_updates = TWO_LOOP;
   sf->use_fast_coef_costing = 0;
   sf->mode_skip_start = MAX_MODES;  // Mode index at which mode skip mask set
@@ -1091,6 +1099,6 @@ void vp9_set_speed_features_framesize_independent(VP9_COMP *cpi, int speed) {
   // It can be used in realtime when adaptive_rd_thresh_row_mt is enabled since
   // adaptive_rd_thresh is defined per-row for non-rd pickmode.
   if (!sf->adaptive_rd_thresh_row_mt && cpi->row_mt_bit_exact &&
-      oxcf->max_threads > 1)
+      use_multi_thread_features(oxcf))
     sf->adaptive_rd_thresh = 0;
 }
@@ -489,6 +489,11 @@ typedef struct SPEED_FEATURES {
   // This feature controls how the loop filter level is determined.
   LPF_PICK_METHOD lpf_pick;
 
+  // When searching for the filter level, evaluate the levels tried in a step
+  // of the search together, a superblock row at a time in scratch rows,
+  // instead of filtering and restoring the whole frame for each level.
+  int fused_lpf_search;
+
   // This feature limits the number of coefficients updates we actually do
   // by only looking at counts from 1/2 the bands.
   FAST_COEFF_UPDATE use_fast_coef_updates;
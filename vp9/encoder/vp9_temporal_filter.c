@@ -265,7 +265,7 @@ static void vp9_highbd_build_inter_predictor_12(
 static void temporal_filter_predictors_mb_c(
     MACROBLOCKD *xd, uint8_t *y_mb_ptr, uint8_t *u_mb_ptr, uint8_t *v_mb_ptr,
     int stride, int uv_block_width, int uv_block_height, int mv_row, int mv_col,
-    uint8_t *pred, struct scale_factors *scale, int x, int y, MV *blk_mvs,
+    uint8_t *pred, const struct scale_factors *scale, int x, int y, MV *blk_mvs,
     int use_32x32) {
   const int which_mv = 0;
   const InterpKernel12 *const kernel = sub_pel_filters_12;
@@ -767,7 +767,7 @@ void vp9_highbd_apply_temporal_filter_c(
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
 static uint32_t temporal_filter_find_matching_mb_c(
-    VP9_COMP *cpi, ThreadData *td, uint8_t *arf_frame_buf,
+    VP9_COMP *cpi, ThreadData *td, int allow_hp, uint8_t *arf_frame_buf,
     uint8_t *frame_ptr_buf, int stride, MV *ref_mv, MV *blk_mvs,
     int *blk_bestsme, int *is_dc_diff_large) {
   MACROBLOCK *const x = &td->mb;
@@ -817,8 +817,8 @@ static uint32_t temporal_filter_find_matching_mb_c(
   // calculation. The start full mv and the search result are stored in
   // ref_mv.
   bestsme = cpi->find_fractional_mv_step(
-      x, ref_mv, &best_ref_mv1, cpi->common.allow_high_precision_mv,
-      x->errorperbit, &cpi->fn_ptr[TF_BLOCK], 0, mv_sf->subpel_search_level,
+      x, ref_mv, &best_ref_mv1, allow_hp, x->errorperbit,
+      &cpi->fn_ptr[TF_BLOCK], 0, mv_sf->subpel_search_level,
       cond_cost_list(cpi, cost_list), NULL, NULL, &distortion, &sse, NULL, BW,
       BH, USE_8_TAPS_SHARP);
   *is_dc_diff_large = 50 * bestsme < sse;
@@ -846,10 +846,10 @@ static uint32_t temporal_filter_find_matching_mb_c(
       x->mv_limits = tmp_mv_limits;
 
       blk_bestsme[k] = cpi->find_fractional_mv_step(
-          x, &blk_mvs[k], &best_ref_mv1, cpi->common.allow_high_precision_mv,
-          x->errorperbit, &cpi->fn_ptr[TF_SUB_BLOCK], 0,
-          mv_sf->subpel_search_level, cond_cost_list(cpi, cost_list), NULL,
-          NULL, &distortion, &sse, NULL, SUB_BW, SUB_BH, USE_8_TAPS_SHARP);
+          x, &blk_mvs[k], &best_ref_mv1, allow_hp, x->errorperbit,
+          &cpi->fn_ptr[TF_SUB_BLOCK], 0, mv_sf->subpel_search_level,
+          cond_cost_list(cpi, cost_list), NULL, NULL, &distortion, &sse, NULL,
+          SUB_BW, SUB_BH, USE_8_TAPS_SHARP);
       k++;
     }
   }
@@ -861,15 +861,14 @@ static uint32_t temporal_filter_find_matching_mb_c(
   return bestsme;
 }
 
-void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
-                                       int mb_row, int mb_col_start,
-                                       int mb_col_end) {
-  ARNRFilterData *arnr_filter_data = &cpi->arnr_filter_data;
-  YV12_BUFFER_CONFIG **frames = arnr_filter_data->frames;
+static void temporal_filter_iterate_row(
+    VP9_COMP *cpi, ThreadData *td, const ARNRFilterData *arnr_filter_data,
+    int mb_row, int mb_col_start, int mb_col_end) {
+  YV12_BUFFER_CONFIG *const *frames = arnr_filter_data->frames;
   int frame_count = arnr_filter_data->frame_count;
   int alt_ref_index = arnr_filter_data->alt_ref_index;
   int strength = arnr_filter_data->strength;
-  struct scale_factors *scale = &arnr_filter_data->sf;
+  const struct scale_factors *scale = &arnr_filter_data->sf;
   int byte;
   int frame;
   int mb_col;
@@ -979,7 +978,8 @@ void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
 
         // Find best match in this frame by MC
         int err = temporal_filter_find_matching_mb_c(
-            cpi, td, frames[alt_ref_index]->y_buffer + mb_y_offset,
+            cpi, td, arnr_filter_data->allow_high_precision_mv,
+            frames[alt_ref_index]->y_buffer + mb_y_offset,
             frames[frame]->y_buffer + mb_y_offset, frames[frame]->y_stride,
             &ref_mv, blk_mvs, blk_bestsme, &is_dc_diff_large);
 
@@ -1219,6 +1219,13 @@ void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
   }
 }
 
+void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
+                                       int mb_row, int mb_col_start,
+                                       int mb_col_end) {
+  temporal_filter_iterate_row(cpi, td, &cpi->arnr_filter_data, mb_row,
+                              mb_col_start, mb_col_end);
+}
+
 static void temporal_filter_iterate_tile_c(VP9_COMP *cpi, int tile_row,
                                            int tile_col) {
   VP9_COMMON *const cm = &cpi->common;
@@ -1329,23 +1336,20 @@ static void adjust_arnr_filter(VP9_COMP *cpi, int distance, int group_boost,
   *arnr_strength = strength;
 }
 
-void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
+// Sets up 'arnr_filter_data' to filter the ARF 'distance' frames ahead.
+static void setup_arnr_filter_data(VP9_COMP *cpi, int distance,
+                                   ARNRFilterData *arnr_filter_data) {
   VP9_COMMON *const cm = &cpi->common;
-  RATE_CONTROL *const rc = &cpi->rc;
-  MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
-  ARNRFilterData *arnr_filter_data = &cpi->arnr_filter_data;
   int frame;
   int frames_to_blur;
   int start_frame;
   int strength;
   int frames_to_blur_backward;
   int frames_to_blur_forward;
-  struct scale_factors *sf = &arnr_filter_data->sf;
   YV12_BUFFER_CONFIG **frames = arnr_filter_data->frames;
-  int rdmult;
 
   // Apply context specific adjustments to the arnr filter parameters.
-  adjust_arnr_filter(cpi, distance, rc->gfu_boost, &frames_to_blur,
+  adjust_arnr_filter(cpi, distance, cpi->rc.gfu_boost, &frames_to_blur,
                      &frames_to_blur_backward, &frames_to_blur_forward,
                      &strength);
   start_frame = distance + frames_to_blur_forward;
@@ -1353,7 +1357,6 @@ void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
   arnr_filter_data->strength = strength;
   arnr_filter_data->frame_count = frames_to_blur;
   arnr_filter_data->alt_ref_index = frames_to_blur_backward;
-  arnr_filter_data->dst = &cpi->tf_buffer;
 
   // Setup frame pointers, NULL indicates frame not included in filter.
   for (frame = 0; frame < frames_to_blur; ++frame) {
@@ -1363,6 +1366,80 @@ void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
     frames[frames_to_blur - 1 - frame] = &buf->img;
   }
 
+  // Setup scaling factors. Scaling on each of the arnr frames is not
+  // supported. In spatial svc the scaling factors are set up by
+  // vp9_temporal_filter().
+  if (frames_to_blur > 0 && !cpi->use_svc) {
+// ARF is produced at the native frame size and resized when coded.
+#if CONFIG_VP9_HIGHBITDEPTH
+    vp9_setup_scale_factors_for_frame(
+        &arnr_filter_data->sf, frames[0]->y_crop_width,
+        frames[0]->y_crop_height, frames[0]->y_crop_width,
+        frames[0]->y_crop_height, cm->use_highbitdepth);
+#else
+    vp9_setup_scale_factors_for_frame(
+        &arnr_filter_data->sf, frames[0]->y_crop_width,
+        frames[0]->y_crop_height, frames[0]->y_crop_width,
+        frames[0]->y_crop_height);
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  }
+}
+
+// Takes the ARF filtered by cpi->arnr_pipeline if it was filtered with the
+// parameters in 'arnr_filter_data'. Returns 1 if arnr_filter_data->dst now
+// holds the filtered frame.
+static int take_pipelined_arf(VP9_COMP *cpi,
+                              const ARNRFilterData *arnr_filter_data) {
+  const VP9_COMMON *const cm = &cpi->common;
+  ARNRPipeline *const pipeline = &cpi->arnr_pipeline;
+  const ARNRFilterData *const filtered = &pipeline->filter_data;
+  YV12_BUFFER_CONFIG *const dst = arnr_filter_data->dst;
+  YV12_BUFFER_CONFIG tmp;
+  int frame;
+
+  if (!pipeline->pending) return 0;
+  pipeline->pending = 0;
+  if (!vpx_get_worker_interface()->sync(&pipeline->worker)) return 0;
+
+  if (filtered->frame_count != arnr_filter_data->frame_count ||
+      filtered->alt_ref_index != arnr_filter_data->alt_ref_index ||
+      filtered->strength != arnr_filter_data->strength ||
+      filtered->allow_high_precision_mv !=
+          arnr_filter_data->allow_high_precision_mv ||
+      filtered->rdmult != arnr_filter_data->rdmult)
+    return 0;
+  for (frame = 0; frame < filtered->frame_count; ++frame) {
+    if (filtered->frames[frame] != arnr_filter_data->frames[frame]) return 0;
+  }
+  if (pipeline->mb_rows != (cm->mi_rows + TF_ROUND) >> TF_SHIFT ||
+      pipeline->mb_cols != (cm->mi_cols + TF_ROUND) >> TF_SHIFT)
+    return 0;
+  if (pipeline->buffer.y_crop_width != dst->y_crop_width ||
+      pipeline->buffer.y_crop_height != dst->y_crop_height ||
+      pipeline->buffer.border != dst->border ||
+      pipeline->buffer.flags != dst->flags)
+    return 0;
+
+  tmp = *dst;
+  *dst = pipeline->buffer;
+  pipeline->buffer = tmp;
+  return 1;
+}
+
+void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
+  VP9_COMMON *const cm = &cpi->common;
+  MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
+  ARNRFilterData *arnr_filter_data = &cpi->arnr_filter_data;
+  int frame;
+  int frames_to_blur;
+  struct scale_factors *sf = &arnr_filter_data->sf;
+  YV12_BUFFER_CONFIG **frames = arnr_filter_data->frames;
+  int rdmult;
+
+  setup_arnr_filter_data(cpi, distance, arnr_filter_data);
+  frames_to_blur = arnr_filter_data->frame_count;
+  arnr_filter_data->dst = &cpi->tf_buffer;
+
   YV12_BUFFER_CONFIG *f = frames[arnr_filter_data->alt_ref_index];
   xd->cur_buf = f;
   xd->plane[1].subsampling_y = f->subsampling_y;
@@ -1412,18 +1489,6 @@ void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
       cm->mi = cm->mip + cm->mi_stride + 1;
       xd->mi = cm->mi_grid_visible;
       xd->mi[0] = cm->mi;
-    } else {
-// ARF is produced at the native frame size and resized when coded.
-#if CONFIG_VP9_HIGHBITDEPTH
-      vp9_setup_scale_factors_for_frame(
-          sf, frames[0]->y_crop_width, frames[0]->y_crop_height,
-          frames[0]->y_crop_width, frames[0]->y_crop_height,
-          cm->use_highbitdepth);
-#else
-      vp9_setup_scale_factors_for_frame(
-          sf, frames[0]->y_crop_width, frames[0]->y_crop_height,
-          frames[0]->y_crop_width, frames[0]->y_crop_height);
-#endif  // CONFIG_VP9_HIGHBITDEPTH
     }
   }
 
@@ -1431,9 +1496,104 @@ void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
   rdmult = vp9_compute_rd_mult_based_on_qindex(cpi, ARNR_FILT_QINDEX);
   set_error_per_bit(&cpi->td.mb, rdmult);
   vp9_initialize_me_consts(cpi, &cpi->td.mb, ARNR_FILT_QINDEX);
+  arnr_filter_data->allow_high_precision_mv = cm->allow_high_precision_mv;
+  arnr_filter_data->rdmult = rdmult;
+
+  if (take_pipelined_arf(cpi, arnr_filter_data)) return;
 
   if (!cpi->row_mt)
     temporal_filter_iterate_c(cpi);
   else
     vp9_temporal_filter_row_mt(cpi);
 }
+
+static int arnr_pipeline_worker_hook(void *arg1, void *arg2) {
+  VP9_COMP *const cpi = (VP9_COMP *)arg1;
+  ARNRPipeline *const pipeline = (ARNRPipeline *)arg2;
+  int mb_row;
+
+  for (mb_row = 0; mb_row < pipeline->mb_rows; ++mb_row) {
+    temporal_filter_iterate_row(cpi, pipeline->td, &pipeline->filter_data,
+                                mb_row, 0, pipeline->mb_cols);
+  }
+  return 1;
+}
+
+void vp9_temporal_filter_pipeline_start(VP9_COMP *cpi, int distance,
+                                        int allow_high_precision_mv,
+                                        int rdmult) {
+  VP9_COMMON *const cm = &cpi->common;
+  const VP9EncoderConfig *const oxcf = &cpi->oxcf;
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  ARNRPipeline *const pipeline = &cpi->arnr_pipeline;
+  ARNRFilterData *const arnr_filter_data = &pipeline->filter_data;
+  MACROBLOCK *x;
+  YV12_BUFFER_CONFIG *f;
+
+  vp9_temporal_filter_pipeline_sync(cpi);
+  pipeline->pending = 0;
+  if (cpi->use_svc || vp9_lookahead_peek(cpi->lookahead, distance) == NULL)
+    return;
+
+  if (pipeline->td == NULL) {
+    CHECK_MEM_ERROR(&cm->error, pipeline->td,
+                    vpx_memalign(32, sizeof(*pipeline->td)));
+    vp9_zero(*pipeline->td);
+    winterface->init(&pipeline->worker);
+    pipeline->worker.thread_name = "vpx enc arnr";
+    pipeline->worker.pool_client = cpi->pool_client;
+    if (!winterface->reset(&pipeline->worker))
+      vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
+                         "Temporal filter thread creation failed");
+  }
+  if (vpx_realloc_frame_buffer(&pipeline->buffer, oxcf->width, oxcf->height,
+                               cm->subsampling_x, cm->subsampling_y,
+#if CONFIG_VP9_HIGHBITDEPTH
+                               cm->use_highbitdepth,
+#endif
+                               VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
+                               NULL, NULL, NULL))
+    vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                       "Failed to allocate temporal filter buffer");
+
+  setup_arnr_filter_data(cpi, distance, arnr_filter_data);
+  arnr_filter_data->dst = &pipeline->buffer;
+  arnr_filter_data->allow_high_precision_mv = allow_high_precision_mv;
+  arnr_filter_data->rdmult = rdmult;
+  pipeline->mb_rows = (cm->mi_rows + TF_ROUND) >> TF_SHIFT;
+  pipeline->mb_cols = (cm->mi_cols + TF_ROUND) >> TF_SHIFT;
+
+  // Set up the motion search as vp9_temporal_filter() does.
+  x = &pipeline->td->mb;
+  *x = cpi->td.mb;
+  f = arnr_filter_data->frames[arnr_filter_data->alt_ref_index];
+  x->e_mbd.cur_buf = f;
+  x->e_mbd.plane[1].subsampling_y = f->subsampling_y;
+  x->e_mbd.plane[1].subsampling_x = f->subsampling_x;
+  x->mvcost = allow_high_precision_mv ? x->nmvcost_hp : x->nmvcost;
+  x->mvsadcost = allow_high_precision_mv ? x->nmvsadcost_hp : x->nmvsadcost;
+  set_error_per_bit(x, rdmult);
+  vp9_initialize_me_consts(cpi, x, ARNR_FILT_QINDEX);
+
+  pipeline->worker.hook = arnr_pipeline_worker_hook;
+  pipeline->worker.data1 = cpi;
+  pipeline->worker.data2 = pipeline;
+  winterface->launch(&pipeline->worker);
+  pipeline->pending = 1;
+}
+
+void vp9_temporal_filter_pipeline_sync(VP9_COMP *cpi) {
+  ARNRPipeline *const pipeline = &cpi->arnr_pipeline;
+  if (pipeline->td != NULL) vpx_get_worker_interface()->sync(&pipeline->worker);
+}
+
+void vp9_temporal_filter_pipeline_dealloc(VP9_COMP *cpi) {
+  ARNRPipeline *const pipeline = &cpi->arnr_pipeline;
+  if (pipeline->td != NULL) {
+    vpx_get_worker_interface()->end(&pipeline->worker);
+    vpx_free(pipeline->td);
+    pipeline->td = NULL;
+  }
+  vpx_free_frame_buffer(&pipeline->buffer);
+  pipeline->pending = 0;
+}
@@ -60,6 +60,17 @@ DECLARE_ALIGNED(256, static const InterpKernel12,
 void vp9_temporal_filter_init(void);
 void vp9_temporal_filter(struct VP9_COMP *cpi, int distance);
 
+// Starts filtering the ARF 'distance' frames ahead of the next frame on a
+// separate thread, with the motion search set up with
+// 'allow_high_precision_mv' and 'rdmult'. vp9_temporal_filter() takes the
+// result if it filters the same ARF in the same way.
+void vp9_temporal_filter_pipeline_start(struct VP9_COMP *cpi, int distance,
+                                        int allow_high_precision_mv,
+                                        int rdmult);
+// Waits for the filtering started by vp9_temporal_filter_pipeline_start().
+void vp9_temporal_filter_pipeline_sync(struct VP9_COMP *cpi);
+void vp9_temporal_filter_pipeline_dealloc(struct VP9_COMP *cpi);
+
 void vp9_temporal_filter_iterate_row_c(struct VP9_COMP *cpi,
                                        struct ThreadData *td, int mb_row,
                                        int mb_col_start, int mb_col_end);
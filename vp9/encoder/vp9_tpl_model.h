@@ -33,6 +33,11 @@ void vp9_setup_tpl_stats(VP9_COMP *cpi);
 void vp9_free_tpl_buffer(VP9_COMP *cpi);
 void vp9_estimate_tpl_qp_gop(VP9_COMP *cpi);
 
+// Builds the TPL model of the blocks of one row of the frame set up in
+// cpi->tpl_flow_data, from mi_col_start up to mi_col_end.
+void vp9_mc_flow_dispenser_row(VP9_COMP *cpi, ThreadData *td, int mi_row,
+                               int mi_col_start, int mi_col_end);
+
 void vp9_wht_fwd_txfm(int16_t *src_diff, int bw, tran_low_t *coeff,
                       TX_SIZE tx_size);
 #if CONFIG_VP9_HIGHBITDEPTH
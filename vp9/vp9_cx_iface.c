@@ -76,6 +76,10 @@ typedef struct vp9_extracfg {
   unsigned int motion_vector_unit_test;
   int delta_q_uv;
   unsigned int validate_hbd_input;
+  unsigned int frame_pipelining;
+  unsigned int recode_interpolation;
+  unsigned int thread_invariant;
+  unsigned int frame_parallel_first_pass;
 } vp9_extracfg;
 
 static struct vp9_extracfg default_extra_cfg = {
@@ -117,6 +121,10 @@ static struct vp9_extracfg default_extra_cfg = {
   0,                     // motion_vector_unit_test
   0,                     // delta_q_uv
   1,                     // validate_hbd_input
+  0,                     // frame_pipelining
+  0,                     // recode_interpolation
+  0,                     // thread_invariant
+  0,                     // frame_parallel_first_pass
 };
 
 struct vpx_codec_alg_priv {
@@ -145,6 +153,8 @@ struct vpx_codec_alg_priv {
   BufferPool *buffer_pool;
   vpx_fixed_buf_t global_headers;
   int global_header_subsampling;
+  // Connection to the application owned thread pool, if any.
+  VPxThreadPoolClient *pool_client;
 };
 
 // Called by encoder_set_config() and encoder_encode() only. Must not be called
@@ -286,6 +296,10 @@ static vpx_codec_err_t validate_config(vpx_codec_alg_priv_t *ctx,
         "or kf_max_dist instead.");
 
   RANGE_CHECK(extra_cfg, row_mt, 0, 1);
+  RANGE_CHECK(extra_cfg, frame_pipelining, 0, 1);
+  RANGE_CHECK(extra_cfg, recode_interpolation, 0, 1);
+  RANGE_CHECK(extra_cfg, thread_invariant, 0, 1);
+  RANGE_CHECK(extra_cfg, frame_parallel_first_pass, 0, 1);
   RANGE_CHECK(extra_cfg, motion_vector_unit_test, 0, 2);
   RANGE_CHECK(extra_cfg, enable_auto_alt_ref, 0, MAX_ARF_LAYERS);
   RANGE_CHECK(extra_cfg, cpu_used, -9, 9);
@@ -591,8 +605,17 @@ static vpx_codec_err_t set_encoder_config(
     case VPX_RC_LAST_PASS: oxcf->pass = 2; break;
   }
 
-  oxcf->lag_in_frames =
-      cfg->g_pass == VPX_RC_FIRST_PASS ? 0 : cfg->g_lag_in_frames;
+  if (cfg->g_pass == VPX_RC_FIRST_PASS) {
+    // The frame parallel first pass analyses the frames held in the
+    // lookahead together with the current one.
+    oxcf->lag_in_frames =
+        extra_cfg->frame_parallel_first_pass
+            ? VPXMAX(VPXMIN((int)cfg->g_threads, MAX_FP_PARALLEL_FRAMES) - 1,
+                     0)
+            : 0;
+  } else {
+    oxcf->lag_in_frames = cfg->g_lag_in_frames;
+  }
   oxcf->rc_mode = cfg->rc_end_usage;
 
   raw_target_rate =
@@ -677,12 +700,22 @@ static vpx_codec_err_t set_encoder_config(
 
   oxcf->enable_keyframe_filtering = extra_cfg->enable_keyframe_filtering;
 
+  oxcf->frame_pipelining = extra_cfg->frame_pipelining;
+
+  oxcf->recode_interpolation = extra_cfg->recode_interpolation;
+
+  oxcf->thread_invariant = extra_cfg->thread_invariant;
+
+  oxcf->frame_parallel_first_pass = extra_cfg->frame_parallel_first_pass;
+
   // TODO(yunqing): The dependencies between row tiles cause error in multi-
   // threaded encoding. For now, tile_rows is forced to be 0 in this case.
   // The further fix can be done by adding synchronizations after a tile row
   // is encoded. But this will hurt multi-threaded encoder performance. So,
   // it is recommended to use tile-rows=0 while encoding with threads > 1.
-  if (oxcf->max_threads > 1 && oxcf->tile_columns > 0)
+  // With thread_invariant, this is done for any number of threads.
+  if ((oxcf->max_threads > 1 || oxcf->thread_invariant) &&
+      oxcf->tile_columns > 0)
     oxcf->tile_rows = 0;
   else
     oxcf->tile_rows = extra_cfg->tile_rows;
@@ -1049,6 +1082,35 @@ static vpx_codec_err_t ctrl_set_validate_hbd_input(vpx_codec_alg_priv_t *ctx,
   extra_cfg.validate_hbd_input = CAST(VP9E_SET_VALIDATE_HBD_INPUT, args);
   return update_extra_cfg(ctx, &extra_cfg);
 }
+
+static vpx_codec_err_t ctrl_set_frame_pipelining(vpx_codec_alg_priv_t *ctx,
+                                                 va_list args) {
+  struct vp9_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.frame_pipelining = CAST(VP9E_SET_FRAME_PIPELINING, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
+static vpx_codec_err_t ctrl_set_recode_interpolation(vpx_codec_alg_priv_t *ctx,
+                                                     va_list args) {
+  struct vp9_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.recode_interpolation = CAST(VP9E_SET_RECODE_INTERPOLATION, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
+static vpx_codec_err_t ctrl_set_thread_invariant(vpx_codec_alg_priv_t *ctx,
+                                                 va_list args) {
+  struct vp9_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.thread_invariant = CAST(VP9E_SET_THREAD_INVARIANT, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
+static vpx_codec_err_t ctrl_set_frame_parallel_first_pass(
+    vpx_codec_alg_priv_t *ctx, va_list args) {
+  struct vp9_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.frame_parallel_first_pass =
+      CAST(VP9E_SET_FRAME_PARALLEL_FIRST_PASS, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
 static vpx_codec_err_t ctrl_set_arnr_max_frames(vpx_codec_alg_priv_t *ctx,
                                                 va_list args) {
   struct vp9_extracfg extra_cfg = ctx->extra_cfg;
@@ -1185,6 +1247,21 @@ static vpx_codec_err_t ctrl_set_rtc_external_ratectrl(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_thread_pool(vpx_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  vpx_thread_pool_t *const pool = CAST(VP9E_SET_THREAD_POOL, args);
+  VP9_COMP *const cpi = ctx->cpi;
+  if (pool == NULL) return VPX_CODEC_INVALID_PARAM;
+  // The encoder's workers are created with the first multi-threaded frame.
+  if (cpi->num_workers > 0 || cpi->arnr_pipeline.td != NULL ||
+      ctx->pool_client != NULL)
+    return VPX_CODEC_ERROR;
+  ctx->pool_client = vpx_thread_pool_client_create(pool);
+  if (ctx->pool_client == NULL) return VPX_CODEC_MEM_ERROR;
+  cpi->pool_client = ctx->pool_client;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t ctrl_enable_motion_vector_unit_test(
     vpx_codec_alg_priv_t *ctx, va_list args) {
   struct vp9_extracfg extra_cfg = ctx->extra_cfg;
@@ -1247,6 +1324,7 @@ static vpx_codec_err_t encoder_destroy(vpx_codec_alg_priv_t *ctx) {
   free(ctx->cx_data);
   free(ctx->global_headers.buf);
   vp9_remove_compressor(ctx->cpi);
+  vpx_thread_pool_client_destroy(ctx->pool_client);
   vpx_free(ctx->buffer_pool);
   vpx_free(ctx);
   return VPX_CODEC_OK;
@@ -1585,25 +1663,30 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
   if (cpi->oxcf.pass == 1 && !cpi->use_svc) {
 #if !CONFIG_REALTIME_ONLY
     // compute first pass stats
-    if (img) {
-      int ret;
+    if (!cpi->twopass.first_pass_done) {
       int64_t dst_time_stamp;
       int64_t dst_end_time_stamp;
       vpx_codec_cx_pkt_t fps_pkt;
       ENCODE_FRAME_RESULT encode_frame_result;
       vp9_init_encode_frame_result(&encode_frame_result);
+      // The frame parallel first pass holds back frames, whose stats are
+      // output when flushing. Each packet gets its own copy of the stats.
       // TODO(angiebird): Call vp9_first_pass directly
-      ret = vp9_get_compressed_data(cpi, &lib_flags, &size, cx_data, cx_data_sz,
-                                    &dst_time_stamp, &dst_end_time_stamp, !img,
-                                    &encode_frame_result);
-      assert(size == 0);  // There is no compressed data in the first pass
-      (void)ret;
-      assert(ret == 0);
-      fps_pkt = get_first_pass_stats_pkt(&cpi->twopass.this_frame_stats);
-      vpx_codec_pkt_list_add(&ctx->pkt_list.head, &fps_pkt);
-    } else {
-      if (!cpi->twopass.first_pass_done) {
-        vpx_codec_cx_pkt_t fps_pkt;
+      while (cx_data_sz >= sizeof(cpi->twopass.this_frame_stats) &&
+             -1 != vp9_get_compressed_data(cpi, &lib_flags, &size, cx_data,
+                                           cx_data_sz, &dst_time_stamp,
+                                           &dst_end_time_stamp, !img,
+                                           &encode_frame_result)) {
+        assert(size == 0);  // There is no compressed data in the first pass
+        memcpy(cx_data, &cpi->twopass.this_frame_stats,
+               sizeof(cpi->twopass.this_frame_stats));
+        fps_pkt = get_first_pass_stats_pkt((FIRSTPASS_STATS *)cx_data);
+        vpx_codec_pkt_list_add(&ctx->pkt_list.head, &fps_pkt);
+        cx_data += sizeof(cpi->twopass.this_frame_stats);
+        cx_data_sz -= sizeof(cpi->twopass.this_frame_stats);
+        if (img) break;
+      }
+      if (!img) {
         vp9_end_first_pass(cpi);
         fps_pkt = get_first_pass_stats_pkt(&cpi->twopass.total_stats);
         vpx_codec_pkt_list_add(&ctx->pkt_list.head, &fps_pkt);
@@ -2178,6 +2261,24 @@ static vpx_codec_err_t ctrl_set_external_rate_control(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_two_pass_chunk(vpx_codec_alg_priv_t *ctx,
+                                               va_list args) {
+#if !CONFIG_REALTIME_ONLY
+  const vpx_two_pass_chunk_t *const chunk =
+      va_arg(args, vpx_two_pass_chunk_t *);
+
+  if (chunk == NULL) return VPX_CODEC_INVALID_PARAM;
+  if (vp9_set_second_pass_chunk(ctx->cpi, chunk->first_frame,
+                                chunk->num_frames))
+    return VPX_CODEC_INVALID_PARAM;
+  return VPX_CODEC_OK;
+#else
+  (void)ctx;
+  (void)args;
+  return VPX_CODEC_INCAPABLE;
+#endif  // !CONFIG_REALTIME_ONLY
+}
+
 static vpx_codec_err_t ctrl_set_quantizer_one_pass(vpx_codec_alg_priv_t *ctx,
                                                    va_list args) {
   VP9_COMP *const cpi = ctx->cpi;
@@ -2215,6 +2316,11 @@ static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { VP9E_SET_TPL, ctrl_set_tpl_model },
   { VP9E_SET_KEY_FRAME_FILTERING, ctrl_set_keyframe_filtering },
   { VP9E_SET_VALIDATE_HBD_INPUT, ctrl_set_validate_hbd_input },
+  { VP9E_SET_THREAD_POOL, ctrl_set_thread_pool },
+  { VP9E_SET_FRAME_PIPELINING, ctrl_set_frame_pipelining },
+  { VP9E_SET_RECODE_INTERPOLATION, ctrl_set_recode_interpolation },
+  { VP9E_SET_THREAD_INVARIANT, ctrl_set_thread_invariant },
+  { VP9E_SET_FRAME_PARALLEL_FIRST_PASS, ctrl_set_frame_parallel_first_pass },
   { VP8E_SET_ARNR_MAXFRAMES, ctrl_set_arnr_max_frames },
   { VP8E_SET_ARNR_STRENGTH, ctrl_set_arnr_strength },
   { VP8E_SET_ARNR_TYPE, ctrl_set_arnr_type },
@@ -2254,6 +2360,7 @@ static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { VP9E_SET_RTC_EXTERNAL_RATECTRL, ctrl_set_rtc_external_ratectrl },
   { VP9E_SET_EXTERNAL_RATE_CONTROL, ctrl_set_external_rate_control },
   { VP9E_SET_QUANTIZER_ONE_PASS, ctrl_set_quantizer_one_pass },
+  { VP9E_SET_TWO_PASS_CHUNK, ctrl_set_two_pass_chunk },
 
   // Getters
   { VP8E_GET_LAST_QUANTIZER, ctrl_get_quantizer },
@@ -2384,6 +2491,66 @@ CODEC_INTERFACE(vpx_codec_vp9_cx) = {
   }
 };
 
+vpx_codec_err_t vpx_codec_vp9_merge_first_pass_stats(
+    const vpx_fixed_buf_t *chunk_stats, int num_chunks,
+    vpx_fixed_buf_t *stats) {
+#if !CONFIG_REALTIME_ONLY
+  const size_t packet_sz = sizeof(FIRSTPASS_STATS);
+  const FIRSTPASS_STATS **chunk_buf;
+  int *chunk_frames;
+  size_t num_frames = 0;
+  int i;
+
+  if (chunk_stats == NULL || num_chunks < 1 || stats == NULL ||
+      stats->buf == NULL)
+    return VPX_CODEC_INVALID_PARAM;
+
+  for (i = 0; i < num_chunks; ++i) {
+    const size_t n_packets = chunk_stats[i].sz / packet_sz;
+    const FIRSTPASS_STATS *total_stats;
+    double count_rounded;
+
+    if (chunk_stats[i].buf == NULL || chunk_stats[i].sz % packet_sz ||
+        n_packets < 2 || n_packets - 1 > INT_MAX)
+      return VPX_CODEC_INVALID_PARAM;
+    // The stats of each chunk end with their total.
+    total_stats = (const FIRSTPASS_STATS *)chunk_stats[i].buf + n_packets - 1;
+    count_rounded = total_stats->count + 0.5;
+    if (!isfinite((float)total_stats->count) || total_stats->count < 0.0 ||
+        count_rounded > (double)INT_MAX ||
+        (size_t)count_rounded != n_packets - 1)
+      return VPX_CODEC_INVALID_PARAM;
+    num_frames += n_packets - 1;
+  }
+  if (num_frames > INT_MAX || stats->sz / packet_sz < num_frames + 1)
+    return VPX_CODEC_INVALID_PARAM;
+
+  chunk_buf = (const FIRSTPASS_STATS **)vpx_malloc(num_chunks *
+                                                   sizeof(*chunk_buf));
+  chunk_frames = (int *)vpx_malloc(num_chunks * sizeof(*chunk_frames));
+  if (chunk_buf == NULL || chunk_frames == NULL) {
+    vpx_free(chunk_buf);
+    vpx_free(chunk_frames);
+    return VPX_CODEC_MEM_ERROR;
+  }
+  for (i = 0; i < num_chunks; ++i) {
+    chunk_buf[i] = (const FIRSTPASS_STATS *)chunk_stats[i].buf;
+    chunk_frames[i] = (int)(chunk_stats[i].sz / packet_sz) - 1;
+  }
+  vp9_merge_first_pass_stats(chunk_buf, chunk_frames, num_chunks,
+                             (FIRSTPASS_STATS *)stats->buf);
+  stats->sz = (num_frames + 1) * packet_sz;
+  vpx_free(chunk_buf);
+  vpx_free(chunk_frames);
+  return VPX_CODEC_OK;
+#else
+  (void)chunk_stats;
+  (void)num_chunks;
+  (void)stats;
+  return VPX_CODEC_INCAPABLE;
+#endif  // !CONFIG_REALTIME_ONLY
+}
+
 static vpx_codec_enc_cfg_t get_enc_cfg(int frame_width, int frame_height,
                                        vpx_rational_t frame_rate,
                                        int target_bitrate,
@@ -2566,6 +2733,14 @@ void vp9_dump_encoder_config(const VP9EncoderConfig *oxcf, FILE *fp) {
 
   DUMP_STRUCT_VALUE(fp, oxcf, enable_keyframe_filtering);
 
+  DUMP_STRUCT_VALUE(fp, oxcf, frame_pipelining);
+
+  DUMP_STRUCT_VALUE(fp, oxcf, recode_interpolation);
+
+  DUMP_STRUCT_VALUE(fp, oxcf, thread_invariant);
+
+  DUMP_STRUCT_VALUE(fp, oxcf, frame_parallel_first_pass);
+
   DUMP_STRUCT_VALUE(fp, oxcf, max_threads);
 
   DUMP_STRUCT_VALUE(fp, oxcf, target_level);
@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <assert.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -55,11 +57,17 @@ static vpx_codec_err_t decoder_init(vpx_codec_ctx_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static void release_frame_workers(vpx_codec_alg_priv_t *ctx);
+
 static vpx_codec_err_t decoder_destroy(vpx_codec_alg_priv_t *ctx) {
-  if (ctx->pbi != NULL) {
+  if (ctx->num_frame_workers > 0) {
+    release_frame_workers(ctx);
+  } else if (ctx->pbi != NULL) {
     vp9_decoder_remove(ctx->pbi);
   }
 
+  vpx_thread_pool_client_destroy(ctx->pool_client);
+
   if (ctx->buffer_pool) {
     vp9_free_ref_frame_buffers(ctx->buffer_pool);
     vp9_free_internal_frame_buffers(&ctx->buffer_pool->int_frame_buffers);
@@ -92,10 +100,21 @@ static int parse_bitdepth_colorspace_sampling(BITSTREAM_PROFILE profile,
   return 1;
 }
 
+// Frame header fields read by decoder_peek_si_internal() on top of the
+// stream info.
+typedef struct FrameHeaderInfo {
+  int show_existing_frame;
+  int frame_to_show;
+  int intra_only;
+  int error_resilient;
+  int reset_frame_context;
+  int refresh_frame_flags;
+} FrameHeaderInfo;
+
 static vpx_codec_err_t decoder_peek_si_internal(
     const uint8_t *data, unsigned int data_sz, vpx_codec_stream_info_t *si,
-    int *is_intra_only, vpx_decrypt_cb decrypt_cb, void *decrypt_state) {
-  int intra_only_flag = 0;
+    FrameHeaderInfo *hdr, vpx_decrypt_cb decrypt_cb, void *decrypt_state) {
+  FrameHeaderInfo info = { 0, 0, 0, 0, 0, 0 };
   uint8_t clear_buffer[11];
 
   if (data + data_sz <= data) return VPX_CODEC_INVALID_PARAM;
@@ -115,7 +134,6 @@ static vpx_codec_err_t decoder_peek_si_internal(
 
   {
     int show_frame;
-    int error_resilient;
     struct vpx_read_bit_buffer rb = { data, data + data_sz, 0, NULL, NULL };
     const int frame_marker = vpx_rb_read_literal(&rb, 2);
     const BITSTREAM_PROFILE profile = vp9_read_profile(&rb);
@@ -128,7 +146,9 @@ static vpx_codec_err_t decoder_peek_si_internal(
       // If profile is > 2 and show_existing_frame is true, then at least 1 more
       // byte (6+3=9 bits) is needed.
       if (profile > 2 && data_sz < 2) return VPX_CODEC_UNSUP_BITSTREAM;
-      vpx_rb_read_literal(&rb, 3);  // Frame buffer to show.
+      info.show_existing_frame = 1;
+      info.frame_to_show = vpx_rb_read_literal(&rb, 3);
+      if (hdr != NULL) *hdr = info;
       return VPX_CODEC_OK;
     }
 
@@ -139,7 +159,7 @@ static vpx_codec_err_t decoder_peek_si_internal(
 
     si->is_kf = !vpx_rb_read_bit(&rb);
     show_frame = vpx_rb_read_bit(&rb);
-    error_resilient = vpx_rb_read_bit(&rb);
+    info.error_resilient = vpx_rb_read_bit(&rb);
 
     if (si->is_kf) {
       if (!vp9_read_sync_code(&rb)) return VPX_CODEC_UNSUP_BITSTREAM;
@@ -147,12 +167,14 @@ static vpx_codec_err_t decoder_peek_si_internal(
       if (!parse_bitdepth_colorspace_sampling(profile, &rb))
         return VPX_CODEC_UNSUP_BITSTREAM;
       vp9_read_frame_size(&rb, (int *)&si->w, (int *)&si->h);
+      info.refresh_frame_flags = (1 << REF_FRAMES) - 1;
     } else {
-      intra_only_flag = show_frame ? 0 : vpx_rb_read_bit(&rb);
+      info.intra_only = show_frame ? 0 : vpx_rb_read_bit(&rb);
 
-      rb.bit_offset += error_resilient ? 0 : 2;  // reset_frame_context
+      info.reset_frame_context =
+          info.error_resilient ? 0 : vpx_rb_read_literal(&rb, 2);
 
-      if (intra_only_flag) {
+      if (info.intra_only) {
         if (!vp9_read_sync_code(&rb)) return VPX_CODEC_UNSUP_BITSTREAM;
         if (profile > PROFILE_0) {
           if (!parse_bitdepth_colorspace_sampling(profile, &rb))
@@ -161,12 +183,14 @@ static vpx_codec_err_t decoder_peek_si_internal(
           // bytes.
           if (data_sz < 11) return VPX_CODEC_UNSUP_BITSTREAM;
         }
-        rb.bit_offset += REF_FRAMES;  // refresh_frame_flags
+        info.refresh_frame_flags = vpx_rb_read_literal(&rb, REF_FRAMES);
         vp9_read_frame_size(&rb, (int *)&si->w, (int *)&si->h);
+      } else {
+        info.refresh_frame_flags = vpx_rb_read_literal(&rb, REF_FRAMES);
       }
     }
   }
-  if (is_intra_only != NULL) *is_intra_only = intra_only_flag;
+  if (hdr != NULL) *hdr = info;
   return VPX_CODEC_OK;
 }
 
@@ -206,7 +230,6 @@ static vpx_codec_err_t init_buffer_callbacks(vpx_codec_alg_priv_t *ctx) {
 
   cm->new_fb_idx = INVALID_IDX;
   cm->byte_alignment = ctx->byte_alignment;
-  cm->skip_loop_filter = ctx->skip_loop_filter;
 
   if (ctx->get_ext_fb_cb != NULL && ctx->release_ext_fb_cb != NULL) {
     pool->get_fb_cb = ctx->get_ext_fb_cb;
@@ -241,6 +264,255 @@ static void set_ppflags(const vpx_codec_alg_priv_t *ctx, vp9_ppflags_t *flags) {
   flags->noise_level = ctx->postproc_cfg.noise_level;
 }
 
+static void release_frame_workers(vpx_codec_alg_priv_t *ctx) {
+  BufferPool *const pool = ctx->buffer_pool;
+  int i;
+
+  for (i = 0; i < ctx->num_frame_workers; ++i) {
+    FrameWorkerData *const fwd = &ctx->frame_workers[i];
+    vp9_frame_worker_sync(fwd->pbi);
+    decrease_ref_count(fwd->output_fb_idx, pool->frame_bufs, pool);
+  }
+  for (i = 0; i < ctx->num_outputs; ++i)
+    decrease_ref_count(ctx->outputs[i].fb_idx, pool->frame_bufs, pool);
+  ctx->num_outputs = 0;
+  ctx->next_output = 0;
+
+  for (i = 0; i < ctx->num_frame_workers; ++i)
+    vp9_decoder_remove(ctx->frame_workers[i].pbi);
+  ctx->num_frame_workers = 0;
+  ctx->pbi = NULL;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_destroy(&pool->row_mutex);
+  pthread_cond_destroy(&pool->row_cond);
+#endif
+}
+
+// Row based multithreading parses each superblock into buffers before
+// reconstructing it. Low memory decoders only do so when there are threads to
+// share the work.
+static int get_row_mt(const vpx_codec_alg_priv_t *ctx) {
+  return ctx->row_mt && !(ctx->low_memory && ctx->cfg.threads <= 1);
+}
+
+// Sets up one decoder instance, each with its own thread, per frame decoded
+// in parallel. The instance created by init_decoder() is the first of them.
+// If the workers cannot be set up the frames are decoded serially.
+static void init_frame_workers(vpx_codec_alg_priv_t *ctx) {
+#if CONFIG_MULTITHREAD
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  BufferPool *const pool = ctx->buffer_pool;
+  const int num_workers = VPXMIN((int)ctx->cfg.threads, MAX_FRAME_WORKERS);
+  int i;
+
+  if (pthread_mutex_init(&pool->row_mutex, NULL)) return;
+  if (pthread_cond_init(&pool->row_cond, NULL)) {
+    pthread_mutex_destroy(&pool->row_mutex);
+    return;
+  }
+  for (i = 0; i < FRAME_BUFFERS; ++i)
+    vpx_atomic_init(&pool->frame_bufs[i].row, INT_MAX);
+
+  ctx->num_frame_workers = 0;
+  for (i = 0; i < num_workers; ++i) {
+    FrameWorkerData *const fwd = &ctx->frame_workers[i];
+    VP9Decoder *const pbi = i == 0 ? ctx->pbi : vp9_decoder_create(pool);
+    if (pbi == NULL) break;
+    fwd->pbi = pbi;
+    fwd->user_priv = NULL;
+    fwd->output_fb_idx = INVALID_IDX;
+    ++ctx->num_frame_workers;
+
+    pbi->pool_client = ctx->pool_client;
+    pbi->frame_worker.pool_client = ctx->pool_client;
+    pbi->frame_parallel_decode = 1;
+    pbi->max_threads = 1;
+    pbi->row_mt = 1;
+    pbi->lpf_mt_opt = 0;
+    pbi->low_memory = ctx->low_memory;
+    pbi->frame_border = ctx->pbi->frame_border;
+    pbi->common.new_fb_idx = INVALID_IDX;
+    pbi->common.byte_alignment = ctx->byte_alignment;
+    if (!winterface->reset(&pbi->frame_worker)) break;
+  }
+
+  if (i < num_workers) {
+    // Fall back to serial decode, keeping the first decoder instance.
+    for (i = 1; i < ctx->num_frame_workers; ++i)
+      vp9_decoder_remove(ctx->frame_workers[i].pbi);
+    winterface->end(&ctx->pbi->frame_worker);
+    ctx->pbi->frame_parallel_decode = 0;
+    ctx->pbi->max_threads = ctx->cfg.threads;
+    ctx->pbi->row_mt = get_row_mt(ctx);
+    ctx->pbi->lpf_mt_opt = ctx->lpf_opt && ctx->pool_client == NULL;
+    ctx->num_frame_workers = 0;
+    pthread_mutex_destroy(&pool->row_mutex);
+    pthread_cond_destroy(&pool->row_cond);
+    return;
+  }
+
+  ctx->next_submit_worker = 0;
+  ctx->next_retire_worker = 0;
+  ctx->num_pending_workers = 0;
+  ctx->num_outputs = 0;
+  ctx->next_output = 0;
+#else
+  (void)ctx;
+#endif  // CONFIG_MULTITHREAD
+}
+
+// Waits for the frame of 'fwd' to be decoded. A frame that fails to
+// reconstruct is not output and, as in serial decode, the decoder then waits
+// for a key frame or intra-only frame.
+static void sync_frame_worker(vpx_codec_alg_priv_t *ctx,
+                              FrameWorkerData *const fwd) {
+  BufferPool *const pool = ctx->buffer_pool;
+  if (!vp9_frame_worker_sync(fwd->pbi)) {
+    decrease_ref_count(fwd->output_fb_idx, pool->frame_bufs, pool);
+    fwd->output_fb_idx = INVALID_IDX;
+    ctx->pbi->need_resync = 1;
+    ctx->need_resync = 1;
+  }
+}
+
+static void sync_frame_workers(vpx_codec_alg_priv_t *ctx) {
+  int i;
+  for (i = 0; i < ctx->num_frame_workers; ++i)
+    sync_frame_worker(ctx, &ctx->frame_workers[i]);
+}
+
+// Waits for the oldest frame in flight and moves its output, if any, to the
+// output queue.
+static void retire_frame_worker(vpx_codec_alg_priv_t *ctx) {
+  BufferPool *const pool = ctx->buffer_pool;
+  FrameWorkerData *const fwd = &ctx->frame_workers[ctx->next_retire_worker];
+
+  assert(ctx->num_pending_workers > 0);
+  sync_frame_worker(ctx, fwd);
+  if (fwd->output_fb_idx != INVALID_IDX) {
+    if (ctx->num_outputs < (int)(sizeof(ctx->outputs) / sizeof(*ctx->outputs))) {
+      ctx->outputs[ctx->num_outputs].fb_idx = fwd->output_fb_idx;
+      ctx->outputs[ctx->num_outputs].user_priv = fwd->user_priv;
+      ctx->outputs[ctx->num_outputs].complexity_level =
+          fwd->pbi->complexity_level;
+      ++ctx->num_outputs;
+    } else {
+      decrease_ref_count(fwd->output_fb_idx, pool->frame_bufs, pool);
+    }
+    fwd->output_fb_idx = INVALID_IDX;
+  }
+  ctx->next_retire_worker =
+      (ctx->next_retire_worker + 1) % ctx->num_frame_workers;
+  --ctx->num_pending_workers;
+}
+
+// Releases the frames already returned from the output queue. The frames
+// returned by decoder_get_frame() stay valid until the next call to
+// decoder_decode().
+static void release_outputs(vpx_codec_alg_priv_t *ctx) {
+  BufferPool *const pool = ctx->buffer_pool;
+  int i;
+  for (i = 0; i < ctx->next_output; ++i)
+    decrease_ref_count(ctx->outputs[i].fb_idx, pool->frame_bufs, pool);
+  ctx->num_outputs -= ctx->next_output;
+  memmove(ctx->outputs, ctx->outputs + ctx->next_output,
+          ctx->num_outputs * sizeof(*ctx->outputs));
+  ctx->next_output = 0;
+}
+
+static int has_free_frame_buffer(const BufferPool *const pool) {
+  int i;
+  for (i = 0; i < FRAME_BUFFERS; ++i) {
+    if (pool->frame_bufs[i].ref_count == 0) return 1;
+  }
+  return 0;
+}
+
+// Picks the frame worker for the next frame and hands it the decoder state
+// left by the previous frame.
+static vpx_codec_err_t acquire_frame_worker(vpx_codec_alg_priv_t *ctx) {
+  BufferPool *const pool = ctx->buffer_pool;
+  VP9Decoder *pbi;
+
+  if (ctx->num_pending_workers == ctx->num_frame_workers)
+    retire_frame_worker(ctx);
+
+  // Frames in flight and in the output queue hold frame buffers on top of the
+  // reference frames. Give them up, oldest first, if none is left.
+  while (!has_free_frame_buffer(pool) && ctx->num_pending_workers > 0)
+    retire_frame_worker(ctx);
+  while (!has_free_frame_buffer(pool) && ctx->next_output < ctx->num_outputs) {
+    FrameOutput *const output = &ctx->outputs[ctx->next_output++];
+    decrease_ref_count(output->fb_idx, pool->frame_bufs, pool);
+    output->fb_idx = INVALID_IDX;
+  }
+
+  pbi = ctx->frame_workers[ctx->next_submit_worker].pbi;
+  if (pbi != ctx->pbi) {
+    const vpx_codec_err_t res = vp9_frame_worker_copy_context(pbi, ctx->pbi);
+    if (res != VPX_CODEC_OK) {
+      set_error_detail(ctx, "Failed to allocate frame worker context");
+      return res;
+    }
+    ctx->pbi = pbi;
+  }
+  return VPX_CODEC_OK;
+}
+
+// Puts the frame just received by the current frame worker in flight. A frame
+// that fails to parse keeps the worker for the next frame.
+static void submit_frame_worker(vpx_codec_alg_priv_t *ctx, void *user_priv) {
+  ctx->frame_workers[ctx->next_submit_worker].user_priv = user_priv;
+  ctx->next_submit_worker =
+      (ctx->next_submit_worker + 1) % ctx->num_frame_workers;
+  ++ctx->num_pending_workers;
+  ctx->frame_submitted = 1;
+}
+
+// Only the last frame decoded by a decoder_decode() call is output, as in
+// serial decode.
+static void set_frame_worker_output(vpx_codec_alg_priv_t *ctx) {
+  const int last = (ctx->next_submit_worker + ctx->num_frame_workers - 1) %
+                   ctx->num_frame_workers;
+  FrameWorkerData *const fwd = &ctx->frame_workers[last];
+  VP9_COMMON *const cm = &fwd->pbi->common;
+
+  assert(fwd->pbi == ctx->pbi && fwd->output_fb_idx == INVALID_IDX);
+  if (cm->show_frame && !ctx->need_resync &&
+      ctx->decode_mode != VPX_DECODE_REFERENCES) {
+    ++cm->buffer_pool->frame_bufs[cm->new_fb_idx].ref_count;
+    fwd->output_fb_idx = cm->new_fb_idx;
+  }
+}
+
+static vpx_image_t *frame_parallel_get_frame(vpx_codec_alg_priv_t *ctx) {
+  BufferPool *const pool = ctx->buffer_pool;
+
+  // Frames are output once all the frame workers are busy, which keeps the
+  // output delay to num_frame_workers - 1 frames, or when flushing.
+  while (ctx->next_output == ctx->num_outputs &&
+         ctx->num_pending_workers > 0 &&
+         (ctx->flushed ||
+          ctx->num_pending_workers == ctx->num_frame_workers)) {
+    retire_frame_worker(ctx);
+  }
+
+  while (ctx->next_output < ctx->num_outputs) {
+    const FrameOutput *const output = &ctx->outputs[ctx->next_output++];
+    RefCntBuffer *buf;
+    if (output->fb_idx == INVALID_IDX) continue;
+    buf = &pool->frame_bufs[output->fb_idx];
+    // A shown existing frame may still be decoded by another frame worker.
+    vp9_frameworker_wait(pool, buf, INT_MAX);
+    ctx->last_show_frame = output->fb_idx;
+    ctx->output_complexity_level = output->complexity_level;
+    yuvconfig2image(&ctx->img, &buf->buf, output->user_priv);
+    ctx->img.fb_priv = buf->raw_frame_buffer.priv;
+    return &ctx->img;
+  }
+  return NULL;
+}
+
 #undef ERROR
 #define ERROR(str)                  \
   do {                              \
@@ -273,11 +545,34 @@ static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
   ctx->pbi->max_threads = ctx->cfg.threads;
   ctx->pbi->inv_tile_order = ctx->invert_tile_order;
 
+  if (ctx->thread_pool != NULL && ctx->pool_client == NULL) {
+    ctx->pool_client = vpx_thread_pool_client_create(ctx->thread_pool);
+    if (ctx->pool_client == NULL) {
+      vpx_free(ctx->buffer_pool);
+      ctx->buffer_pool = NULL;
+      vp9_decoder_remove(ctx->pbi);
+      ctx->pbi = NULL;
+      set_error_detail(ctx, "Failed to attach to thread pool");
+      return VPX_CODEC_MEM_ERROR;
+    }
+  }
+  ctx->pbi->pool_client = ctx->pool_client;
+
+  RANGE_CHECK(ctx, low_memory, 0, 1);
+  ctx->pbi->low_memory = ctx->low_memory;
+  // Post-processing reads outside of the frame.
+  if (ctx->low_memory && !(ctx->base.init_flags & VPX_CODEC_USE_POSTPROC))
+    ctx->pbi->frame_border = 0;
+
   RANGE_CHECK(ctx, row_mt, 0, 1);
-  ctx->pbi->row_mt = ctx->row_mt;
+  ctx->pbi->row_mt = get_row_mt(ctx);
 
   RANGE_CHECK(ctx, lpf_opt, 0, 1);
-  ctx->pbi->lpf_mt_opt = ctx->lpf_opt;
+  // Filtering rows as soon as their tiles are decoded makes a tile worker wait
+  // on tiles owned by workers that a shared pool may not have started yet.
+  ctx->pbi->lpf_mt_opt = ctx->lpf_opt && ctx->pool_client == NULL;
+
+  RANGE_CHECK(ctx, frame_parallel_decode, 0, 1);
 
   // If postprocessing was enabled by the application and a
   // configuration has not been provided, default it.
@@ -290,7 +585,12 @@ static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
     ctx->buffer_pool = NULL;
     vp9_decoder_remove(ctx->pbi);
     ctx->pbi = NULL;
+    return res;
   }
+
+  if (ctx->frame_parallel_decode && ctx->cfg.threads > 1 &&
+      !(ctx->base.init_flags & VPX_CODEC_USE_POSTPROC))
+    init_frame_workers(ctx);
   return res;
 }
 
@@ -302,30 +602,135 @@ static INLINE void check_resync(vpx_codec_alg_priv_t *const ctx,
     ctx->need_resync = 0;
 }
 
+static void rows_ready(void *priv, const RefCntBuffer *buf, int row_start,
+                       int row_end) {
+  const vpx_codec_alg_priv_t *const ctx = (const vpx_codec_alg_priv_t *)priv;
+  vpx_image_t img;
+  yuvconfig2image(&img, &buf->buf, NULL);
+  img.fb_priv = buf->raw_frame_buffer.priv;
+  ctx->rows_ready.cb(ctx->rows_ready.cb_priv, &img, row_start, row_end);
+}
+
+// Returns the memory allocated by the decoder, not counting frame buffers
+// supplied by the application.
+static size_t get_memory_usage(const vpx_codec_alg_priv_t *ctx) {
+  const BufferPool *const pool = ctx->buffer_pool;
+  size_t size = sizeof(*ctx);
+  int i;
+
+  if (pool != NULL) {
+    const InternalFrameBufferList *const list = &pool->int_frame_buffers;
+    size += sizeof(*pool);
+    for (i = 0; i < FRAME_BUFFERS; ++i) {
+      size += (size_t)pool->frame_bufs[i].mi_rows *
+              pool->frame_bufs[i].mi_cols * sizeof(*pool->frame_bufs[i].mvs);
+    }
+    size += list->num_internal_frame_buffers * sizeof(*list->int_fb);
+    for (i = 0; i < list->num_internal_frame_buffers; ++i)
+      size += list->int_fb[i].size;
+  }
+  if (ctx->num_frame_workers > 0) {
+    for (i = 0; i < ctx->num_frame_workers; ++i)
+      size += ctx->frame_workers[i].pbi->memory_usage;
+  } else if (ctx->pbi != NULL) {
+    size += ctx->pbi->memory_usage;
+  }
+  return size;
+}
+
+static void update_peak_memory(vpx_codec_alg_priv_t *ctx) {
+  ctx->peak_memory = VPXMAX(ctx->peak_memory, get_memory_usage(ctx));
+}
+
+// Key frame mode: returns 1 if the frame in 'data' is to be skipped. Key
+// frames are decoded, and so are intra-only frames unless the frame context
+// they use may have been updated by a skipped frame. A shown existing frame is
+// skipped if a skipped frame replaced it.
+static int skip_frame(vpx_codec_alg_priv_t *ctx, const uint8_t *data,
+                      unsigned int data_sz) {
+  vpx_codec_stream_info_t si;
+  FrameHeaderInfo hdr;
+
+  // Let the decoder report invalid frames.
+  if (decoder_peek_si_internal(data, data_sz, &si, &hdr, ctx->decrypt_cb,
+                               ctx->decrypt_state) != VPX_CODEC_OK) {
+    return 0;
+  }
+  if (hdr.show_existing_frame)
+    return (ctx->stale_refs >> hdr.frame_to_show) & 1;
+  if (si.is_kf) return 0;
+  if (hdr.intra_only && (!ctx->stale_contexts || hdr.error_resilient ||
+                         hdr.reset_frame_context >= 2)) {
+    return 0;
+  }
+  ctx->stale_refs |= hdr.refresh_frame_flags;
+  ctx->stale_contexts = 1;
+  return 1;
+}
+
+// Clears the stale state of key frame mode that the frame just decoded
+// replaced.
+static void update_stale_refs(vpx_codec_alg_priv_t *ctx) {
+  const VP9_COMMON *const cm = &ctx->pbi->common;
+  if (cm->show_existing_frame) return;
+  ctx->stale_refs &= ~ctx->pbi->refresh_frame_flags;
+  if (cm->frame_type == KEY_FRAME || cm->error_resilient_mode ||
+      (cm->intra_only && cm->reset_frame_context == 3)) {
+    ctx->stale_contexts = 0;
+  }
+}
+
 static vpx_codec_err_t decode_one(vpx_codec_alg_priv_t *ctx,
                                   const uint8_t **data, unsigned int data_sz,
                                   void *user_priv) {
   // Determine the stream parameters. Note that we rely on peek_si to
   // validate that we have a buffer that does not wrap around the top
   // of the heap.
+  if (ctx->decode_mode == VPX_DECODE_KEY_FRAMES &&
+      skip_frame(ctx, *data, data_sz)) {
+    *data += data_sz;
+    return VPX_CODEC_OK;
+  }
+
   if (!ctx->si.h) {
-    int is_intra_only = 0;
+    FrameHeaderInfo hdr;
     const vpx_codec_err_t res =
-        decoder_peek_si_internal(*data, data_sz, &ctx->si, &is_intra_only,
+        decoder_peek_si_internal(*data, data_sz, &ctx->si, &hdr,
                                  ctx->decrypt_cb, ctx->decrypt_state);
     if (res != VPX_CODEC_OK) return res;
 
-    if (!ctx->si.is_kf && !is_intra_only) return VPX_CODEC_ERROR;
+    if (!ctx->si.is_kf && !hdr.intra_only) return VPX_CODEC_ERROR;
   }
 
   ctx->user_priv = user_priv;
 
+  if (ctx->num_frame_workers > 0) {
+    const vpx_codec_err_t res = acquire_frame_worker(ctx);
+    if (res != VPX_CODEC_OK) return res;
+  }
+
   // Set these even if already initialized.  The caller may have changed the
   // decrypt config between frames.
   ctx->pbi->decrypt_cb = ctx->decrypt_cb;
   ctx->pbi->decrypt_state = ctx->decrypt_state;
 
+  // Postprocessing outputs a copy of the frame, which is only made once the
+  // frame is fully decoded. Nothing is output in references mode.
+  ctx->pbi->references_only = ctx->decode_mode == VPX_DECODE_REFERENCES;
+  ctx->pbi->skip_loop_filter = ctx->skip_loop_filter;
+  ctx->pbi->complexity_level = ctx->complexity_level;
+  ctx->pbi->rows_ready_cb = ctx->rows_ready.cb != NULL ? rows_ready : NULL;
+  if (ctx->pbi->references_only) ctx->pbi->rows_ready_cb = NULL;
+#if CONFIG_VP9_POSTPROC
+  if ((ctx->base.init_flags & VPX_CODEC_USE_POSTPROC) &&
+      ctx->postproc_cfg.post_proc_flag) {
+    ctx->pbi->rows_ready_cb = NULL;
+  }
+#endif
+  ctx->pbi->rows_ready_priv = ctx;
+
   if (vp9_receive_compressed_data(ctx->pbi, data_sz, data)) {
+    update_peak_memory(ctx);
     ctx->pbi->cur_buf->buf.corrupted = 1;
     ctx->pbi->need_resync = 1;
     ctx->need_resync = 1;
@@ -333,6 +738,10 @@ static vpx_codec_err_t decode_one(vpx_codec_alg_priv_t *ctx,
   }
 
   check_resync(ctx, ctx->pbi);
+  update_stale_refs(ctx);
+  update_peak_memory(ctx);
+
+  if (ctx->num_frame_workers > 0) submit_frame_worker(ctx, user_priv);
 
   return VPX_CODEC_OK;
 }
@@ -345,6 +754,8 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
   uint32_t frame_sizes[8];
   int frame_count;
 
+  if (ctx->num_frame_workers > 0) release_outputs(ctx);
+
   if (data == NULL && data_sz == 0) {
     ctx->flushed = 1;
     return VPX_CODEC_OK;
@@ -352,6 +763,7 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
 
   // Reset flushed when receiving a valid frame.
   ctx->flushed = 0;
+  ctx->frame_submitted = 0;
 
   // Initialize the decoder on the first frame.
   if (ctx->pbi == NULL) {
@@ -384,6 +796,7 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
 
       data_start += frame_size;
     }
+    if (ctx->frame_submitted) set_frame_worker_output(ctx);
   } else {
     const uint8_t *const data_end = data + data_sz;
     while (data_start < data_end) {
@@ -399,6 +812,7 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
         ++data_start;
       }
     }
+    if (ctx->frame_submitted) set_frame_worker_output(ctx);
   }
 
   return res;
@@ -412,15 +826,24 @@ static vpx_image_t *decoder_get_frame(vpx_codec_alg_priv_t *ctx,
   // always return only 1 frame per decode call.
   (void)iter;
 
+  if (ctx->num_frame_workers > 0) return frame_parallel_get_frame(ctx);
+
   if (ctx->pbi != NULL) {
     YV12_BUFFER_CONFIG sd;
     vp9_ppflags_t flags = { 0, 0, 0 };
+    if (ctx->decode_mode == VPX_DECODE_REFERENCES) {
+      ctx->pbi->ready_for_new_data = 1;
+      return NULL;
+    }
     if (ctx->base.init_flags & VPX_CODEC_USE_POSTPROC) set_ppflags(ctx, &flags);
-    if (vp9_get_raw_frame(ctx->pbi, &sd, &flags) == 0) {
+    const int res = vp9_get_raw_frame(ctx->pbi, &sd, &flags);
+    update_peak_memory(ctx);
+    if (res == 0) {
       VP9_COMMON *const cm = &ctx->pbi->common;
       RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
       ctx->last_show_frame = ctx->pbi->common.new_fb_idx;
       if (ctx->need_resync) return NULL;
+      ctx->output_complexity_level = ctx->pbi->complexity_level;
       yuvconfig2image(&ctx->img, &sd, ctx->user_priv);
       ctx->img.fb_priv = frame_bufs[cm->new_fb_idx].raw_frame_buffer.priv;
       img = &ctx->img;
@@ -456,6 +879,7 @@ static vpx_codec_err_t ctrl_set_reference(vpx_codec_alg_priv_t *ctx,
     YV12_BUFFER_CONFIG sd;
     image2yuvconfig(&frame->img, &sd);
     if (!ctx->pbi) return VPX_CODEC_ERROR;
+    if (ctx->num_frame_workers > 0) sync_frame_workers(ctx);
     return vp9_set_reference_dec(
         &ctx->pbi->common, ref_frame_to_vp9_reframe(frame->frame_type), &sd);
   } else {
@@ -472,6 +896,7 @@ static vpx_codec_err_t ctrl_copy_reference(vpx_codec_alg_priv_t *ctx,
     YV12_BUFFER_CONFIG sd;
     image2yuvconfig(&frame->img, &sd);
     if (!ctx->pbi) return VPX_CODEC_ERROR;
+    if (ctx->num_frame_workers > 0) sync_frame_workers(ctx);
     return vp9_copy_reference_dec(ctx->pbi, (VP9_REFFRAME)frame->frame_type,
                                   &sd);
   } else {
@@ -486,7 +911,9 @@ static vpx_codec_err_t ctrl_get_reference(vpx_codec_alg_priv_t *ctx,
   if (data) {
     if (ctx->pbi) {
       const int fb_idx = ctx->pbi->common.cur_show_frame_fb_idx;
-      YV12_BUFFER_CONFIG *fb = get_buf_frame(&ctx->pbi->common, fb_idx);
+      YV12_BUFFER_CONFIG *fb;
+      if (ctx->num_frame_workers > 0) sync_frame_workers(ctx);
+      fb = get_buf_frame(&ctx->pbi->common, fb_idx);
       if (fb == NULL) return VPX_CODEC_ERROR;
       yuvconfig2image(&data->img, fb, NULL);
       return VPX_CODEC_OK;
@@ -641,7 +1068,11 @@ static vpx_codec_err_t ctrl_set_byte_alignment(vpx_codec_alg_priv_t *ctx,
     return VPX_CODEC_INVALID_PARAM;
 
   ctx->byte_alignment = byte_alignment;
-  if (ctx->pbi != NULL) {
+  if (ctx->num_frame_workers > 0) {
+    int i;
+    for (i = 0; i < ctx->num_frame_workers; ++i)
+      ctx->frame_workers[i].pbi->common.byte_alignment = byte_alignment;
+  } else if (ctx->pbi != NULL) {
     ctx->pbi->common.byte_alignment = byte_alignment;
   }
   return VPX_CODEC_OK;
@@ -650,11 +1081,6 @@ static vpx_codec_err_t ctrl_set_byte_alignment(vpx_codec_alg_priv_t *ctx,
 static vpx_codec_err_t ctrl_set_skip_loop_filter(vpx_codec_alg_priv_t *ctx,
                                                  va_list args) {
   ctx->skip_loop_filter = va_arg(args, int);
-
-  if (ctx->pbi != NULL) {
-    ctx->pbi->common.skip_loop_filter = ctx->skip_loop_filter;
-  }
-
   return VPX_CODEC_OK;
 }
 
@@ -682,6 +1108,92 @@ static vpx_codec_err_t ctrl_enable_lpf_opt(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_frame_parallel(vpx_codec_alg_priv_t *ctx,
+                                               va_list args) {
+  ctx->frame_parallel_decode = va_arg(args, int);
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_thread_pool(vpx_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  // The decoder's workers are created with the first frame.
+  if (ctx->pbi != NULL) return VPX_CODEC_ERROR;
+  ctx->thread_pool = va_arg(args, vpx_thread_pool_t *);
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_rows_ready_cb(vpx_codec_alg_priv_t *ctx,
+                                              va_list args) {
+  const vpx_rows_ready_cb_t *const init = va_arg(args, vpx_rows_ready_cb_t *);
+  // The frame workers read the callback while decoding.
+  if (ctx->pbi != NULL) return VPX_CODEC_ERROR;
+  if (init == NULL) {
+    ctx->rows_ready.cb = NULL;
+    ctx->rows_ready.cb_priv = NULL;
+  } else {
+    ctx->rows_ready = *init;
+  }
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_low_memory(vpx_codec_alg_priv_t *ctx,
+                                           va_list args) {
+  // Frame buffers and working memory are allocated with the first frame.
+  if (ctx->pbi != NULL) return VPX_CODEC_ERROR;
+  ctx->low_memory = va_arg(args, int);
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_get_peak_memory(vpx_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  size_t *const peak_memory = va_arg(args, size_t *);
+
+  if (peak_memory == NULL) return VPX_CODEC_INVALID_PARAM;
+  *peak_memory = ctx->peak_memory;
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_decode_mode(vpx_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  const int decode_mode = va_arg(args, int);
+
+  if (decode_mode < VPX_DECODE_ALL_FRAMES ||
+      decode_mode > VPX_DECODE_REFERENCES) {
+    return VPX_CODEC_INVALID_PARAM;
+  }
+  // Inter frames may predict from frames skipped in key frame mode.
+  if (decode_mode != VPX_DECODE_KEY_FRAMES && ctx->pbi != NULL &&
+      (ctx->stale_refs || ctx->stale_contexts)) {
+    ctx->pbi->need_resync = 1;
+    ctx->need_resync = 1;
+  }
+  ctx->decode_mode = decode_mode;
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_complexity_level(vpx_codec_alg_priv_t *ctx,
+                                                 va_list args) {
+  const int complexity_level = va_arg(args, int);
+
+  if (complexity_level < 0 || complexity_level > VP9_MAX_COMPLEXITY_LEVEL)
+    return VPX_CODEC_INVALID_PARAM;
+  ctx->complexity_level = complexity_level;
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_get_complexity_level(vpx_codec_alg_priv_t *ctx,
+                                                 va_list args) {
+  int *const complexity_level = va_arg(args, int *);
+
+  if (complexity_level == NULL) return VPX_CODEC_INVALID_PARAM;
+  *complexity_level = ctx->output_complexity_level;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { VP8_COPY_REFERENCE, ctrl_copy_reference },
 
@@ -695,6 +1207,12 @@ static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { VP9_DECODE_SVC_SPATIAL_LAYER, ctrl_set_spatial_layer_svc },
   { VP9D_SET_ROW_MT, ctrl_set_row_mt },
   { VP9D_SET_LOOP_FILTER_OPT, ctrl_enable_lpf_opt },
+  { VP9D_SET_FRAME_PARALLEL, ctrl_set_frame_parallel },
+  { VP9D_SET_THREAD_POOL, ctrl_set_thread_pool },
+  { VP9D_SET_ROWS_READY_CB, ctrl_set_rows_ready_cb },
+  { VP9D_SET_LOW_MEMORY, ctrl_set_low_memory },
+  { VP9D_SET_DECODE_MODE, ctrl_set_decode_mode },
+  { VP9D_SET_COMPLEXITY_LEVEL, ctrl_set_complexity_level },
 
   // Getters
   { VPXD_GET_LAST_QUANTIZER, ctrl_get_quantizer },
@@ -704,6 +1222,8 @@ static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { VP9D_GET_DISPLAY_SIZE, ctrl_get_render_size },
   { VP9D_GET_BIT_DEPTH, ctrl_get_bit_depth },
   { VP9D_GET_FRAME_SIZE, ctrl_get_frame_size },
+  { VP9D_GET_PEAK_MEMORY, ctrl_get_peak_memory },
+  { VP9D_GET_COMPLEXITY_LEVEL, ctrl_get_complexity_level },
 
   { -1, NULL },
 };
@@ -15,6 +15,25 @@
 
 typedef vpx_codec_stream_info_t vp9_stream_info_t;
 
+// Maximum number of frames decoded in parallel in frame parallel mode.
+#define MAX_FRAME_WORKERS 4
+
+// Frame parallel decode: a decoder instance and the frame it has in flight.
+typedef struct FrameWorkerData {
+  VP9Decoder *pbi;
+  void *user_priv;
+  // Frame buffer to output once the frame is decoded, held until it is output
+  // or dropped. INVALID_IDX if the frame is not output.
+  int output_fb_idx;
+} FrameWorkerData;
+
+// Frame parallel decode: a decoded frame waiting in the output queue.
+typedef struct FrameOutput {
+  int fb_idx;
+  void *user_priv;
+  int complexity_level;
+} FrameOutput;
+
 struct vpx_codec_alg_priv {
   vpx_codec_priv_t base;
   vpx_codec_dec_cfg_t cfg;
@@ -47,6 +66,44 @@ struct vpx_codec_alg_priv {
   int svc_spatial_layer;
   int row_mt;
   int lpf_opt;
+
+  // Application owned thread pool and this decoder's connection to it.
+  vpx_thread_pool_t *thread_pool;
+  VPxThreadPoolClient *pool_client;
+
+  vpx_rows_ready_cb_t rows_ready;
+
+  int low_memory;
+  // Largest amount of memory allocated by the decoder after any frame.
+  size_t peak_memory;
+
+  // A vpx_decode_mode_t. In key frame mode, stale_refs has a bit set for each
+  // reference slot last written by a skipped frame, and stale_contexts is set
+  // if a skipped frame may have changed the frame contexts.
+  int decode_mode;
+  int stale_refs;
+  int stale_contexts;
+
+  // VP9D_SET_COMPLEXITY_LEVEL, and the level the last output frame was
+  // decoded at.
+  int complexity_level;
+  int output_complexity_level;
+
+  // Frame parallel decode. The frame workers form a ring: frames are
+  // submitted at next_submit_worker and retired, in decode order, from
+  // next_retire_worker into the output queue. num_frame_workers is 0 when
+  // decoding serially.
+  int frame_parallel_decode;
+  int num_frame_workers;
+  FrameWorkerData frame_workers[MAX_FRAME_WORKERS];
+  int next_submit_worker;
+  int next_retire_worker;
+  int num_pending_workers;
+  FrameOutput outputs[2 * MAX_FRAME_WORKERS];
+  int num_outputs;
+  int next_output;
+  // Set if the current decoder_decode() call submitted a frame.
+  int frame_submitted;
 };
 
 #endif  // VPX_VP9_VP9_DX_IFACE_H_
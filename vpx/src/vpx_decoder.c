@@ -12,8 +12,13 @@
  * \brief Provides the high level interface to wrap decoder algorithms.
  *
  */
+#include <limits.h>
 #include <string.h>
+#include "./vpx_config.h"
 #include "vpx/internal/vpx_codec_internal.h"
+#include "vpx_mem/vpx_mem.h"
+#include "vpx_util/vpx_atomics.h"
+#include "vpx_util/vpx_thread.h"
 
 #define SAVE_STATUS(ctx, var) (ctx ? (ctx->err = var) : var)
 
@@ -119,6 +124,99 @@ vpx_codec_err_t vpx_codec_decode(vpx_codec_ctx_t *ctx, const uint8_t *data,
   return SAVE_STATUS(ctx, res);
 }
 
+static void decode_job(vpx_codec_decode_job_t *job) {
+  job->res = vpx_codec_decode(job->ctx, job->data, job->data_sz,
+                              job->user_priv, 0);
+}
+
+#if CONFIG_MULTITHREAD
+typedef struct BatchData {
+  vpx_codec_decode_job_t *jobs;
+  int num_jobs;
+  vpx_atomic_int next_job;
+} BatchData;
+
+// Decodes jobs until none are left. Jobs are claimed one at a time so that a
+// long job does not hold up the others.
+static int decode_batch_worker(void *arg1, void *arg2) {
+  BatchData *const batch = (BatchData *)arg1;
+  int i;
+  (void)arg2;
+  while ((i = vpx_atomic_fetch_add(&batch->next_job, 1)) < batch->num_jobs) {
+    decode_job(&batch->jobs[i]);
+  }
+  return 1;
+}
+
+// Runs decode_batch_worker() on up to num_workers pool threads and on the
+// calling thread. Returns 0 if the workers could not be set up, in which
+// case no job has been started.
+static int decode_batch_on_pool(BatchData *batch, vpx_thread_pool_t *pool,
+                                int num_workers) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  VPxThreadPoolClient *const client = vpx_thread_pool_client_create(pool);
+  VPxWorker *workers;
+  int i;
+
+  if (client == NULL) return 0;
+  workers = (VPxWorker *)vpx_calloc(num_workers, sizeof(*workers));
+  if (workers == NULL) {
+    vpx_thread_pool_client_destroy(client);
+    return 0;
+  }
+  for (i = 0; i < num_workers; ++i) {
+    VPxWorker *const worker = &workers[i];
+    winterface->init(worker);
+    worker->pool_client = client;
+    worker->thread_name = "vpx batch dec";
+    if (!winterface->reset(worker)) break;
+    worker->hook = decode_batch_worker;
+    worker->data1 = batch;
+    winterface->launch(worker);
+  }
+  // Workers that failed to start are covered by the calling thread.
+  decode_batch_worker(batch, NULL);
+  for (i = 0; i < num_workers; ++i) winterface->end(&workers[i]);
+  vpx_free(workers);
+  vpx_thread_pool_client_destroy(client);
+  return 1;
+}
+#endif  // CONFIG_MULTITHREAD
+
+vpx_codec_err_t vpx_codec_decode_batch(vpx_codec_decode_job_t *jobs,
+                                       unsigned int num_jobs,
+                                       vpx_thread_pool_t *pool) {
+  unsigned int i;
+  int decoded = 0;
+
+  if (!jobs && num_jobs) return VPX_CODEC_INVALID_PARAM;
+
+#if CONFIG_MULTITHREAD
+  if (num_jobs > 1 && num_jobs <= INT_MAX) {
+    const int pool_threads = vpx_thread_pool_get_num_threads(pool);
+    const int num_workers =
+        (int)num_jobs - 1 < pool_threads ? (int)num_jobs - 1 : pool_threads;
+    if (num_workers > 0) {
+      BatchData batch;
+      batch.jobs = jobs;
+      batch.num_jobs = (int)num_jobs;
+      vpx_atomic_init(&batch.next_job, 0);
+      decoded = decode_batch_on_pool(&batch, pool, num_workers);
+    }
+  }
+#else
+  (void)pool;
+#endif  // CONFIG_MULTITHREAD
+
+  if (!decoded) {
+    for (i = 0; i < num_jobs; ++i) decode_job(&jobs[i]);
+  }
+  for (i = 0; i < num_jobs; ++i) {
+    if (jobs[i].res != VPX_CODEC_OK) return jobs[i].res;
+  }
+  return VPX_CODEC_OK;
+}
+
 vpx_image_t *vpx_codec_get_frame(vpx_codec_ctx_t *ctx, vpx_codec_iter_t *iter) {
   vpx_image_t *img;
 
@@ -18,6 +18,7 @@
 #include "./vp8.h"
 #include "./vpx_encoder.h"
 #include "./vpx_ext_ratectrl.h"
+#include "./vpx_thread_pool.h"
 
 /*!\file
  * \brief Provides definitions for using VP8 or VP9 encoder algorithm within the
@@ -60,6 +61,30 @@ extern vpx_codec_iface_t vpx_codec_vp9_cx_algo;
 /*!\brief The interface to the VP9 encoder.
  */
 extern vpx_codec_iface_t *vpx_codec_vp9_cx(void);
+
+/*!\brief Merges the first pass stats of the chunks of a clip.
+ *
+ * The first pass of each chunk of consecutive frames of a clip may be run by
+ * a separate VP9 encoder. This gives the stats of the whole clip, as one
+ * first pass would, from the stats of the chunks (the VPX_CODEC_STATS_PKT
+ * packets output by each encoder, concatenated), for the second passes of
+ * the chunks (see #VP9E_SET_TWO_PASS_CHUNK).
+ *
+ * \param[in]     chunk_stats  The first pass stats of each chunk, in order.
+ * \param[in]     num_chunks   The number of chunks.
+ * \param[in,out] stats        The merged stats. stats->buf must hold the sum
+ *                             of the sizes of the chunk stats; stats->sz is
+ *                             set to the size of the merged stats.
+ *
+ * \retval #VPX_CODEC_OK
+ *     The stats were merged.
+ * \retval #VPX_CODEC_INVALID_PARAM
+ *     The stats of a chunk are not complete or stats->buf is too small.
+ * \retval #VPX_CODEC_INCAPABLE
+ *     The library was built without two pass encoding.
+ */
+vpx_codec_err_t vpx_codec_vp9_merge_first_pass_stats(
+    const vpx_fixed_buf_t *chunk_stats, int num_chunks, vpx_fixed_buf_t *stats);
 /*!@} - end algorithm interface member group*/
 
 /*
@@ -786,6 +811,84 @@ enum vp8e_enc_control_id {
    * Supported in codecs: VP9
    */
   VP9E_SET_VALIDATE_HBD_INPUT,
+
+  /*!\brief Codec control function to run the encoder's worker threads on a
+   * shared thread pool.
+   *
+   * The argument is a vpx_thread_pool_t created with vpx_thread_pool_create()
+   * that must outlive the encoder. Must be set before the first frame is
+   * encoded.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_THREAD_POOL,
+
+  /*!\brief Codec control function to enable frame pipelining.
+   *
+   * In two pass encoding with more than one thread, the encoder then filters
+   * the alt-ref frame coded by the next frame on a separate thread while the
+   * current frame is loop filtered and packed. The output is unchanged. To
+   * enable, set this parameter to 1. The default value is 0.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_FRAME_PIPELINING,
+
+  /*!\brief Codec control function to interpolate the q of frame recodes.
+   *
+   * When a frame is recoded to meet its rate constraints and the previous
+   * attempts overshot and undershot the target size, the encoder then picks
+   * the next q from the sizes they gave instead of bisecting the q range,
+   * which usually saves recodes. To enable, set this parameter to 1. The
+   * default value is 0.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_RECODE_INTERPOLATION,
+
+  /*!\brief Codec control function to make the output independent of the
+   * number of threads.
+   *
+   * With row based multi-threading (VP9E_SET_ROW_MT), the encoder then makes
+   * the same coding decisions with any number of threads, as it does with
+   * several threads, so that the bitstream does not depend on g_threads. As
+   * with several threads, tile rows are not used when there are tile
+   * columns. To enable, set this parameter to 1. The default value is 0.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_THREAD_INVARIANT,
+
+  /*!\brief Codec control function to encode a chunk of the clip in the
+   * second pass.
+   *
+   * The stats given by rc_twopass_stats_in are then those of the whole clip
+   * (see vpx_codec_vp9_merge_first_pass_stats()), and the encoder codes the
+   * frames of the chunk, with the share of the bits of the clip that their
+   * first pass stats give them. The chunk starts with a key frame, and key
+   * frame and golden frame groups end with the chunk, so that the chunks of
+   * a clip can be coded by separate encoders and concatenated. The control
+   * must be used before the first frame is passed to the encoder.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_TWO_PASS_CHUNK,
+
+  /*!\brief Codec control function to analyse frames in parallel in the
+   * first pass.
+   *
+   * The first pass then holds back up to g_threads - 1 frames (at most 15)
+   * and analyses them at the same time, one frame per thread, which keeps
+   * the threads busy on clips with few macroblock rows. Each frame is
+   * compared with the source frame before it instead of its reconstruction,
+   * so the stats differ slightly from those of the default first pass, but
+   * have the same format. The stats packets of the held back frames are
+   * output when the encoder is flushed. To enable, set this parameter to 1.
+   * The default value is 0.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_FRAME_PARALLEL_FIRST_PASS,
 };
 
 /*!\brief vpx 1-D scaling mode
@@ -938,6 +1041,17 @@ typedef struct vpx_svc_ref_frame_config {
   int64_t duration[VPX_SS_MAX_LAYERS];      /**< Duration per spatial layer. */
 } vpx_svc_ref_frame_config_t;
 
+/*!\brief vp9 second pass chunk.
+ *
+ * This defines the frames of the clip coded in the second pass.
+ * This is used with the #VP9E_SET_TWO_PASS_CHUNK control.
+ *
+ */
+typedef struct vpx_two_pass_chunk {
+  int first_frame; /**< Index of the first frame of the chunk in the clip. */
+  int num_frames;  /**< Number of frames in the chunk. */
+} vpx_two_pass_chunk_t;
+
 /*!\brief VP9 svc frame dropping mode.
  *
  * This defines the frame drop mode for SVC.
@@ -1119,6 +1233,18 @@ VPX_CTRL_USE_TYPE(VP9E_SET_KEY_FRAME_FILTERING, int)
 #define VPX_CTRL_VP9E_SET_KEY_FRAME_FILTERING
 VPX_CTRL_USE_TYPE(VP9E_SET_VALIDATE_HBD_INPUT, int)
 #define VPX_CTRL_VP9E_SET_VALIDATE_HBD_INPUT
+VPX_CTRL_USE_TYPE(VP9E_SET_THREAD_POOL, vpx_thread_pool_t *)
+#define VPX_CTRL_VP9E_SET_THREAD_POOL
+VPX_CTRL_USE_TYPE(VP9E_SET_FRAME_PIPELINING, int)
+#define VPX_CTRL_VP9E_SET_FRAME_PIPELINING
+VPX_CTRL_USE_TYPE(VP9E_SET_RECODE_INTERPOLATION, int)
+#define VPX_CTRL_VP9E_SET_RECODE_INTERPOLATION
+VPX_CTRL_USE_TYPE(VP9E_SET_THREAD_INVARIANT, int)
+#define VPX_CTRL_VP9E_SET_THREAD_INVARIANT
+VPX_CTRL_USE_TYPE(VP9E_SET_TWO_PASS_CHUNK, vpx_two_pass_chunk_t *)
+#define VPX_CTRL_VP9E_SET_TWO_PASS_CHUNK
+VPX_CTRL_USE_TYPE(VP9E_SET_FRAME_PARALLEL_FIRST_PASS, int)
+#define VPX_CTRL_VP9E_SET_FRAME_PARALLEL_FIRST_PASS
 
 /*!\endcond */
 /*! @} - end defgroup vp8_encoder */
@@ -26,6 +26,7 @@ extern "C" {
 
 /* Include controls common to both the encoder and decoder */
 #include "./vp8.h"
+#include "./vpx_thread_pool.h"
 
 /*!\name Algorithm interface for VP8
  *
@@ -158,6 +159,120 @@ enum vp8_dec_control_id {
    */
   VP9D_SET_LOOP_FILTER_OPT,
 
+  /*!\brief Codec control function to set frame parallel decoding.
+   *
+   * 0 : off, 1 : on
+   *
+   * When on, up to min(threads, 4) frames are decoded at once: each frame is
+   * parsed on the calling thread and reconstructed on its own worker thread,
+   * which waits on the rows of its reference frames before predicting from
+   * them. Decoded frames are returned with a delay of up to 3 frames, so the
+   * application must flush the decoder at the end of the stream. Frame
+   * parallel decoding takes precedence over VP9D_SET_ROW_MT and is not used
+   * with postprocessing. Must be set before the first frame is decoded.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_FRAME_PARALLEL,
+
+  /*!\brief Codec control function to run the decoder's worker threads on a
+   * shared thread pool.
+   *
+   * The argument is a vpx_thread_pool_t created with vpx_thread_pool_create()
+   * that must outlive the decoder. Must be set before the first frame is
+   * decoded. VP9D_SET_LOOP_FILTER_OPT has no effect when a pool is used.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_THREAD_POOL,
+
+  /*!\brief Codec control function to be notified as the rows of a frame are
+   * decoded.
+   *
+   * The argument is a vpx_rows_ready_cb_t. Its callback is called with the
+   * rows of each shown frame as they become final, so the application can
+   * start using the top of a frame before the rest of it is decoded. The
+   * rows are reported as the loop filter finishes them, or, when the loop
+   * filter is off, one superblock row at a time by single threaded and frame
+   * parallel decoding and all at once otherwise. Not used with
+   * postprocessing. Must be set before the first frame is decoded.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_ROWS_READY_CB,
+
+  /*!\brief Codec control function to reduce the memory used by the decoder.
+   *
+   * 0 : off, 1 : on
+   *
+   * Meant for running many decoders of small streams at once. When on, frame
+   * buffers are allocated without a border unless postprocessing is enabled,
+   * a single threaded decoder borrows its per-frame working memory from a
+   * cache shared by all low memory decoders in the process, and
+   * VP9D_SET_ROW_MT is ignored by single threaded decoders. The decoded
+   * frames are the same. Must be set before the first frame is decoded.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_LOW_MEMORY,
+
+  /*!\brief Codec control function to get the peak memory used by the
+   * decoder.
+   *
+   * The argument is a size_t pointer that receives the largest number of
+   * bytes allocated by the decoder instance after any decoded or output
+   * frame, including the working memory it borrowed in low memory mode.
+   * Frame buffers supplied by the application and thread stacks are not
+   * included.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_GET_PEAK_MEMORY,
+
+  /*!\brief Codec control function to choose which frames are decoded.
+   *
+   * The argument is a #vpx_decode_mode_t, VPX_DECODE_ALL_FRAMES by default.
+   * In VPX_DECODE_KEY_FRAMES mode, vpx_codec_decode() returns as soon as it
+   * has read the header of an inter frame, which is not decoded. Key frames
+   * are decoded and output as usual, as are intra-only frames unless they
+   * depend on a skipped frame. In VPX_DECODE_REFERENCES mode, every frame is
+   * decoded for the reference frames it leaves behind but none is output or
+   * postprocessed, and frames that update no reference frame are not loop
+   * filtered. May be changed between frames. Once frames have been skipped,
+   * the other modes wait for a key frame or an intra-only frame.
+   *
+   * A seek to an inter frame can decode the frames from the previous key
+   * frame in VPX_DECODE_REFERENCES mode and the target frame in
+   * VPX_DECODE_ALL_FRAMES mode.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_DECODE_MODE,
+
+  /*!\brief Codec control function to trade decoded quality for speed.
+   *
+   * Meant for shedding load, the level may be changed between frames:
+   * 0 : full decode (default)
+   * 1 : frames that update no reference frame are not loop filtered
+   * 2 : as 1, and these frames are predicted with the bilinear filter
+   * 3 : as 2, and the chroma planes of all frames are not loop filtered
+   * 4 : as 2, and no frame is loop filtered
+   *
+   * Levels 1 and 2 only change frames that no later frame predicts from, so
+   * the loss of quality does not build up. At levels 3 and 4 it builds up
+   * until the next key frame.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_COMPLEXITY_LEVEL,
+
+  /*!\brief Codec control function to get the complexity level the last
+   * frame returned by vpx_codec_get_frame() was decoded at.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_GET_COMPLEXITY_LEVEL,
+
   VP8_DECODER_CTRL_ID_MAX
 };
 
@@ -179,6 +294,40 @@ typedef struct vpx_decrypt_init {
   void *decrypt_state;
 } vpx_decrypt_init;
 
+/*!\brief Rows ready callback
+ *
+ * Called with the luma rows [row_start, row_end) of the frame \p img, whose
+ * chroma rows follow from its subsampling. The rows of a frame are reported
+ * in order, each exactly once, and the last call for a frame has row_end
+ * equal to img->d_h. img->fb_priv is the private data of the frame buffer
+ * when external frame buffers are used. The callback may run on any of the
+ * decoder's threads while the rest of the frame is being decoded, so it
+ * should return quickly and must not call back into the decoder. Rows of a
+ * frame that turns out to be corrupt may already have been reported.
+ */
+typedef void (*vpx_rows_ready_cb_fn_t)(void *cb_priv, const vpx_image_t *img,
+                                       unsigned int row_start,
+                                       unsigned int row_end);
+
+/*!\brief Structure to hold the rows ready callback
+ *
+ * Defines a structure to hold the rows ready callback and its private data.
+ */
+typedef struct vpx_rows_ready_cb {
+  /*! Rows ready callback, or NULL to disable it. */
+  vpx_rows_ready_cb_fn_t cb;
+
+  /*! Private data passed to the callback. */
+  void *cb_priv;
+} vpx_rows_ready_cb_t;
+
+/*!\brief Frames decoded, set with VP9D_SET_DECODE_MODE */
+typedef enum vpx_decode_mode {
+  VPX_DECODE_ALL_FRAMES = 0, /**< Decode and output all frames */
+  VPX_DECODE_KEY_FRAMES = 1, /**< Decode only key and intra-only frames */
+  VPX_DECODE_REFERENCES = 2  /**< Decode all frames, output none */
+} vpx_decode_mode_t;
+
 /*!\cond */
 /*!\brief VP8 decoder control function parameter type
  *
@@ -217,6 +366,22 @@ VPX_CTRL_USE_TYPE(VP9D_SET_ROW_MT, int)
 #define VPX_CTRL_VP9_DECODE_SET_ROW_MT
 VPX_CTRL_USE_TYPE(VP9D_SET_LOOP_FILTER_OPT, int)
 #define VPX_CTRL_VP9_SET_LOOP_FILTER_OPT
+VPX_CTRL_USE_TYPE(VP9D_SET_FRAME_PARALLEL, int)
+#define VPX_CTRL_VP9D_SET_FRAME_PARALLEL
+VPX_CTRL_USE_TYPE(VP9D_SET_THREAD_POOL, vpx_thread_pool_t *)
+#define VPX_CTRL_VP9D_SET_THREAD_POOL
+VPX_CTRL_USE_TYPE(VP9D_SET_ROWS_READY_CB, vpx_rows_ready_cb_t *)
+#define VPX_CTRL_VP9D_SET_ROWS_READY_CB
+VPX_CTRL_USE_TYPE(VP9D_SET_LOW_MEMORY, int)
+#define VPX_CTRL_VP9D_SET_LOW_MEMORY
+VPX_CTRL_USE_TYPE(VP9D_GET_PEAK_MEMORY, size_t *)
+#define VPX_CTRL_VP9D_GET_PEAK_MEMORY
+VPX_CTRL_USE_TYPE(VP9D_SET_DECODE_MODE, int)
+#define VPX_CTRL_VP9D_SET_DECODE_MODE
+VPX_CTRL_USE_TYPE(VP9D_SET_COMPLEXITY_LEVEL, int)
+#define VPX_CTRL_VP9D_SET_COMPLEXITY_LEVEL
+VPX_CTRL_USE_TYPE(VP9D_GET_COMPLEXITY_LEVEL, int *)
+#define VPX_CTRL_VP9D_GET_COMPLEXITY_LEVEL
 
 /*!\endcond */
 /*! @} - end defgroup vp8_decoder */
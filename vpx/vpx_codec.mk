@@ -27,6 +27,7 @@ API_DOC_SRCS-yes += vpx_encoder.h
 API_DOC_SRCS-$(CONFIG_ENCODERS) += vpx_ext_ratectrl.h
 API_DOC_SRCS-yes += vpx_frame_buffer.h
 API_DOC_SRCS-yes += vpx_image.h
+API_DOC_SRCS-yes += vpx_thread_pool.h
 API_DOC_SRCS-$(CONFIG_ENCODERS) += vpx_tpl.h
 
 API_SRCS-yes += src/vpx_decoder.c
@@ -42,5 +43,6 @@ API_SRCS-yes += vpx_codec.mk
 API_SRCS-yes += vpx_frame_buffer.h
 API_SRCS-yes += vpx_image.h
 API_SRCS-yes += vpx_integer.h
+API_SRCS-yes += vpx_thread_pool.h
 API_SRCS-yes += vpx_ext_ratectrl.h
 API_SRCS-yes += vpx_tpl.h
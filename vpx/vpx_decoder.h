@@ -31,6 +31,7 @@ extern "C" {
 
 #include "./vpx_codec.h"  // IWYU pragma: export
 #include "./vpx_frame_buffer.h"
+#include "./vpx_thread_pool.h"
 
 /*!\brief Current ABI version number
  *
@@ -221,6 +222,48 @@ vpx_codec_err_t vpx_codec_decode(vpx_codec_ctx_t *ctx, const uint8_t *data,
                                  unsigned int data_sz, void *user_priv,
                                  long deadline);
 
+/*!\brief Decode job
+ *
+ * One frame of coded data for one decoder instance, see
+ * vpx_codec_decode_batch().
+ */
+typedef struct vpx_codec_decode_job {
+  vpx_codec_ctx_t *ctx;  /**< Instance to decode with */
+  const uint8_t *data;   /**< Coded data, as for vpx_codec_decode() */
+  unsigned int data_sz;  /**< Size of the coded data, in bytes */
+  void *user_priv;       /**< Application specific data for this frame */
+  vpx_codec_err_t res;   /**< Result of decoding, set by the decoder */
+} vpx_codec_decode_job_t;
+
+/*!\brief Decode frames of several streams
+ *
+ * Decodes one frame for each of \p num_jobs independent decoder instances,
+ * as if vpx_codec_decode() were called for each job in turn, but runs the
+ * jobs concurrently on the threads of \p pool and on the calling thread.
+ * This avoids creating threads per instance when many small streams are
+ * decoded. The instances can be configured with a single thread; they may
+ * also be attached to \p pool themselves with VP9D_SET_THREAD_POOL.
+ *
+ * Each instance may appear in at most one job of a batch, and must not be
+ * used otherwise until this function returns. Decoded frames are retrieved
+ * with vpx_codec_get_frame() afterwards, as usual. This function must not be
+ * called from a callback running on a thread of \p pool.
+ *
+ * \param[in,out] jobs      Jobs to decode. The res member of each job is set
+ *                          to the result of decoding it.
+ * \param[in]     num_jobs  Number of jobs
+ * \param[in]     pool      Threads to decode on. If NULL, or if threads are
+ *                          not supported by this build, the jobs are decoded
+ *                          in order on the calling thread.
+ *
+ * \return Returns #VPX_CODEC_OK if every job was decoded without error,
+ *         #VPX_CODEC_INVALID_PARAM if \p jobs is NULL and \p num_jobs is not
+ *         zero, otherwise the result of the first failed job.
+ */
+vpx_codec_err_t vpx_codec_decode_batch(vpx_codec_decode_job_t *jobs,
+                                       unsigned int num_jobs,
+                                       vpx_thread_pool_t *pool);
+
 /*!\brief Decoded frames iterator
  *
  * Iterates over a list of the frames available for display. The iterator
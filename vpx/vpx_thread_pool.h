@@ -0,0 +1,58 @@
+/*
+ *  Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_VPX_VPX_THREAD_POOL_H_
+#define VPX_VPX_VPX_THREAD_POOL_H_
+
+/*!\file
+ * \brief Describes the application owned thread pool interface.
+ *
+ * By default every encoder and decoder instance creates its own worker
+ * threads. A thread pool lets many codec instances share a fixed set of
+ * threads instead. The application creates the pool and attaches it to each
+ * instance with VP9E_SET_THREAD_POOL or VP9D_SET_THREAD_POOL before the first
+ * frame is encoded or decoded. The instance then runs its tile, row, loop
+ * filter and bitstream packing jobs on the pool threads. Pending jobs are
+ * picked from the attached instances in round robin order, so a busy instance
+ * cannot starve the others.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\brief Opaque thread pool handle. */
+typedef struct vpx_thread_pool vpx_thread_pool_t;
+
+/*!\brief Creates a thread pool.
+ *
+ * Starts \p num_threads threads. The number of threads each attached codec
+ * instance uses is still set by its own configuration.
+ *
+ * \param[in] num_threads  Number of pool threads, must be at least 1.
+ *
+ * \return The new pool, or NULL if \p num_threads is invalid, threads are not
+ *         supported by this build or the threads could not be started.
+ */
+vpx_thread_pool_t *vpx_thread_pool_create(int num_threads);
+
+/*!\brief Destroys a thread pool.
+ *
+ * Every codec instance attached to the pool must have been destroyed first.
+ *
+ * \param[in] pool  Pool to destroy, may be NULL.
+ */
+void vpx_thread_pool_destroy(vpx_thread_pool_t *pool);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // VPX_VPX_VPX_THREAD_POOL_H_
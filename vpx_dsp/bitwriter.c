@@ -10,8 +10,10 @@
 
 #include <assert.h>
 #include <limits.h>
+#include <string.h>
 
 #include "./bitwriter.h"
+#include "vpx_mem/vpx_mem.h"
 
 #if CONFIG_BITSTREAM_DEBUG
 #include "vpx_util/vpx_debug_util.h"
@@ -27,6 +29,7 @@ void vpx_start_encode(vpx_writer *br, uint8_t *source, size_t size) {
   if (size > INT_MAX) size = INT_MAX;
   br->size = (unsigned int)size;
   br->buffer = source;
+  br->symbols = NULL;
   vpx_write_bit(br, 0);
 }
 
@@ -53,3 +56,40 @@ int vpx_stop_encode(vpx_writer *br) {
 
   return br->error ? -1 : 0;
 }
+
+void vpx_start_record(vpx_writer *br, vpx_symbol *symbols, size_t size) {
+  assert(symbols != NULL && size > 0);
+  br->error = 0;
+  br->pos = 0;
+  if (size > INT_MAX) size = INT_MAX;
+  br->size = (unsigned int)size;
+  br->buffer = NULL;
+  br->symbols = symbols;
+}
+
+void vpx_grow_record(vpx_writer *br) {
+  vpx_symbol *symbols;
+  if (br->error || br->size > INT_MAX / 2) {
+    br->error = 1;
+    return;
+  }
+  symbols = (vpx_symbol *)vpx_malloc(2 * br->size * sizeof(*symbols));
+  if (symbols == NULL) {
+    br->error = 1;
+    return;
+  }
+  memcpy(symbols, br->symbols, br->pos * sizeof(*symbols));
+  vpx_free(br->symbols);
+  br->symbols = symbols;
+  br->size *= 2;
+}
+
+void vpx_write_symbols(vpx_writer *br, const vpx_symbol *symbols, int count) {
+  // Keep the state of the coder in a local copy, which the compiler can hold
+  // in registers for the whole batch.
+  vpx_writer w = *br;
+  int i;
+  assert(w.symbols == NULL);
+  for (i = 0; i < count; ++i) vpx_write(&w, symbols[i].bit, symbols[i].prob);
+  *br = w;
+}
@@ -25,6 +25,13 @@
 extern "C" {
 #endif
 
+// The inputs of a vpx_write() call, recorded by a writer started with
+// vpx_start_record().
+typedef struct vpx_symbol {
+  uint8_t bit;
+  vpx_prob prob;
+} vpx_symbol;
+
 typedef struct vpx_writer {
   unsigned int lowvalue;
   unsigned int range;
@@ -37,12 +44,28 @@ typedef struct vpx_writer {
   unsigned int pos;
   unsigned int size;
   uint8_t *buffer;
+  // If not NULL, vpx_write() appends its inputs to this array of 'size'
+  // symbols instead of coding them, and 'pos' is the number of symbols
+  // recorded.
+  vpx_symbol *symbols;
 } vpx_writer;
 
 void vpx_start_encode(vpx_writer *br, uint8_t *source, size_t size);
 // Returns 0 on success and returns -1 in case of error.
 int vpx_stop_encode(vpx_writer *br);
 
+// Starts recording the inputs of vpx_write() in 'symbols', an array of 'size'
+// symbols allocated with vpx_malloc(). The array is replaced by a larger one
+// when it is full, so br->symbols and br->size must be read back once done.
+// 'error' is set if the array cannot be grown.
+void vpx_start_record(vpx_writer *br, vpx_symbol *symbols, size_t size);
+// Doubles the size of br->symbols. Called by vpx_write().
+void vpx_grow_record(vpx_writer *br);
+
+// Codes the 'count' symbols recorded by another writer, as vpx_write() would
+// one at a time.
+void vpx_write_symbols(vpx_writer *br, const vpx_symbol *symbols, int count);
+
 static INLINE VPX_NO_UNSIGNED_SHIFT_CHECK void vpx_write(vpx_writer *br,
                                                          int bit,
                                                          int probability) {
@@ -52,6 +75,16 @@ static INLINE VPX_NO_UNSIGNED_SHIFT_CHECK void vpx_write(vpx_writer *br,
   unsigned int lowvalue = br->lowvalue;
   int shift;
 
+  if (br->symbols != NULL) {
+    if (br->pos == br->size) vpx_grow_record(br);
+    if (br->pos < br->size) {
+      br->symbols[br->pos].bit = (uint8_t)bit;
+      br->symbols[br->pos].prob = (vpx_prob)probability;
+      ++br->pos;
+    }
+    return;
+  }
+
 #if CONFIG_BITSTREAM_DEBUG
   /*
   int queue_r = 0;
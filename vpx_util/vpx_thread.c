@@ -31,38 +31,66 @@ struct VPxWorkerImpl {
   pthread_mutex_t mutex_;
   pthread_cond_t condition_;
   pthread_t thread_;
+  VPxWorker *next_;  // next worker queued on the same pool client
+};
+
+struct vpx_thread_pool {
+  pthread_mutex_t mutex_;
+  pthread_cond_t condition_;
+  pthread_t *threads_;
+  int num_threads_;
+  int shutdown_;
+  // Clients with queued workers, in the order they will be served.
+  VPxThreadPoolClient *ready_head_;
+  VPxThreadPoolClient *ready_tail_;
+};
+
+struct VPxThreadPoolClient {
+  vpx_thread_pool_t *pool_;
+  // Launched workers that have not been picked up by a pool thread yet.
+  VPxWorker *head_;
+  VPxWorker *tail_;
+  VPxThreadPoolClient *next_ready_;
 };
 
 //------------------------------------------------------------------------------
 
 static void execute(VPxWorker *const worker);  // Forward declaration.
 
-static THREADFN thread_loop(void *ptr) {
-  VPxWorker *const worker = (VPxWorker *)ptr;
+static void set_thread_name(const char *name) {
 #ifdef HAVE_PTHREAD_SETNAME_NP
 #ifdef __APPLE__
-  if (worker->thread_name != NULL) {
+  if (name != NULL) {
     // Apple's version of pthread_setname_np takes one argument and operates on
     // the current thread only. The maximum size of the thread_name buffer was
     // noted in the Chromium source code and was confirmed by experiments. If
     // thread_name is too long, pthread_setname_np returns -1 with errno
     // ENAMETOOLONG (63).
     char thread_name[64];
-    strncpy(thread_name, worker->thread_name, sizeof(thread_name) - 1);
+    strncpy(thread_name, name, sizeof(thread_name) - 1);
     thread_name[sizeof(thread_name) - 1] = '\0';
     pthread_setname_np(thread_name);
   }
 #elif (defined(__GLIBC__) && !defined(__GNU__)) || defined(__BIONIC__)
-  if (worker->thread_name != NULL) {
+  if (name != NULL) {
     // Linux and Android require names (with nul) fit in 16 chars, otherwise
     // pthread_setname_np() returns ERANGE (34).
     char thread_name[16];
-    strncpy(thread_name, worker->thread_name, sizeof(thread_name) - 1);
+    strncpy(thread_name, name, sizeof(thread_name) - 1);
     thread_name[sizeof(thread_name) - 1] = '\0';
     pthread_setname_np(pthread_self(), thread_name);
   }
+#else
+  (void)name;
 #endif
+#else
+  (void)name;
 #endif
+}
+
+static THREADFN thread_loop(void *ptr) {
+  VPxWorker *const worker = (VPxWorker *)ptr;
+  set_thread_name(worker->thread_name);
   pthread_mutex_lock(&worker->impl_->mutex_);
   for (;;) {
     while (worker->status_ == VPX_WORKER_STATUS_OK) {  // wait in idling mode
@@ -113,6 +141,125 @@ static void change_state(VPxWorker *const worker, VPxWorkerStatus new_status) {
   pthread_mutex_unlock(&worker->impl_->mutex_);
 }
 
+// Marks a worker run by a pool thread as done (for sync()).
+static void finish_pool_job(VPxWorker *const worker) {
+  pthread_mutex_lock(&worker->impl_->mutex_);
+  assert(worker->status_ == VPX_WORKER_STATUS_WORKING);
+  worker->status_ = VPX_WORKER_STATUS_OK;
+  pthread_cond_signal(&worker->impl_->condition_);
+  pthread_mutex_unlock(&worker->impl_->mutex_);
+}
+
+static THREADFN pool_thread_loop(void *ptr) {
+  vpx_thread_pool_t *const pool = (vpx_thread_pool_t *)ptr;
+  set_thread_name("vpx pool");
+  pthread_mutex_lock(&pool->mutex_);
+  for (;;) {
+    VPxThreadPoolClient *client;
+    VPxWorker *worker;
+    while (pool->ready_head_ == NULL && !pool->shutdown_) {
+      pthread_cond_wait(&pool->condition_, &pool->mutex_);
+    }
+    if (pool->ready_head_ == NULL) break;
+
+    // Take one worker from the client at the head and move the client to the
+    // back of the queue if it has more, so clients are served in turn.
+    client = pool->ready_head_;
+    pool->ready_head_ = client->next_ready_;
+    if (pool->ready_head_ == NULL) pool->ready_tail_ = NULL;
+    client->next_ready_ = NULL;
+
+    worker = client->head_;
+    client->head_ = worker->impl_->next_;
+    worker->impl_->next_ = NULL;
+    if (client->head_ == NULL) {
+      client->tail_ = NULL;
+    } else if (pool->ready_tail_ == NULL) {
+      pool->ready_head_ = pool->ready_tail_ = client;
+    } else {
+      pool->ready_tail_->next_ready_ = client;
+      pool->ready_tail_ = client;
+    }
+
+    pthread_mutex_unlock(&pool->mutex_);
+    execute(worker);
+    finish_pool_job(worker);
+    pthread_mutex_lock(&pool->mutex_);
+  }
+  pthread_mutex_unlock(&pool->mutex_);
+  return THREAD_EXIT_SUCCESS;
+}
+
+// Queues a worker whose status_ has been set to VPX_WORKER_STATUS_WORKING.
+static void submit_pool_job(VPxWorker *const worker) {
+  VPxThreadPoolClient *const client = worker->pool_client;
+  vpx_thread_pool_t *const pool = client->pool_;
+
+  pthread_mutex_lock(&pool->mutex_);
+  if (client->tail_ == NULL) {
+    client->head_ = client->tail_ = worker;
+    if (pool->ready_tail_ == NULL) {
+      pool->ready_head_ = pool->ready_tail_ = client;
+    } else {
+      pool->ready_tail_->next_ready_ = client;
+      pool->ready_tail_ = client;
+    }
+  } else {
+    client->tail_->impl_->next_ = worker;
+    client->tail_ = worker;
+  }
+  pthread_cond_signal(&pool->condition_);
+  pthread_mutex_unlock(&pool->mutex_);
+}
+
+// Removes a launched worker from its client's queue if no pool thread has
+// picked it up yet. Returns true if the worker was removed, in which case the
+// caller must run it and call finish_pool_job().
+static int take_pool_job(VPxWorker *const worker) {
+  VPxThreadPoolClient *const client = worker->pool_client;
+  vpx_thread_pool_t *const pool = client->pool_;
+  VPxWorker **link = &client->head_;
+  VPxWorker *prev = NULL;
+
+  pthread_mutex_lock(&pool->mutex_);
+  while (*link != NULL && *link != worker) {
+    prev = *link;
+    link = &prev->impl_->next_;
+  }
+  if (*link == NULL) {
+    pthread_mutex_unlock(&pool->mutex_);
+    return 0;
+  }
+  *link = worker->impl_->next_;
+  worker->impl_->next_ = NULL;
+  if (client->tail_ == worker) client->tail_ = prev;
+
+  // A client is in the ready queue as long as it has queued workers.
+  if (client->head_ == NULL) {
+    VPxThreadPoolClient **ready = &pool->ready_head_;
+    VPxThreadPoolClient *prev_ready = NULL;
+    while (*ready != client) {
+      prev_ready = *ready;
+      ready = &prev_ready->next_ready_;
+    }
+    *ready = client->next_ready_;
+    client->next_ready_ = NULL;
+    if (pool->ready_tail_ == client) pool->ready_tail_ = prev_ready;
+  }
+  pthread_mutex_unlock(&pool->mutex_);
+  return 1;
+}
+
+// Runs a launched pool worker on the calling thread if no pool thread has
+// picked it up yet, rather than waiting for a pool thread to become free.
+static void run_pool_job_if_queued(VPxWorker *const worker) {
+  if (worker->pool_client == NULL || worker->impl_ == NULL) return;
+  if (take_pool_job(worker)) {
+    execute(worker);
+    finish_pool_job(worker);
+  }
+}
+
 #endif  // CONFIG_MULTITHREAD
 
 //------------------------------------------------------------------------------
@@ -124,6 +271,7 @@ static void init(VPxWorker *const worker) {
 
 static int sync(VPxWorker *const worker) {
 #if CONFIG_MULTITHREAD
+  run_pool_job_if_queued(worker);
   change_state(worker, VPX_WORKER_STATUS_OK);
 #endif
   assert(worker->status_ <= VPX_WORKER_STATUS_OK);
@@ -147,7 +295,10 @@ static int reset(VPxWorker *const worker) {
       goto Error;
     }
     pthread_mutex_lock(&worker->impl_->mutex_);
-    ok = !pthread_create(&worker->impl_->thread_, NULL, thread_loop, worker);
+    // Pool workers only need the status handshake, the hook runs on one of
+    // the pool's threads.
+    ok = worker->pool_client != NULL ||
+         !pthread_create(&worker->impl_->thread_, NULL, thread_loop, worker);
     if (ok) worker->status_ = VPX_WORKER_STATUS_OK;
     pthread_mutex_unlock(&worker->impl_->mutex_);
     if (!ok) {
@@ -177,6 +328,9 @@ static void execute(VPxWorker *const worker) {
 static void launch(VPxWorker *const worker) {
 #if CONFIG_MULTITHREAD
   change_state(worker, VPX_WORKER_STATUS_WORKING);
+  if (worker->pool_client != NULL && worker->impl_ != NULL) {
+    submit_pool_job(worker);
+  }
 #else
   execute(worker);
 #endif
@@ -185,8 +339,9 @@ static void launch(VPxWorker *const worker) {
 static void end(VPxWorker *const worker) {
 #if CONFIG_MULTITHREAD
   if (worker->impl_ != NULL) {
+    run_pool_job_if_queued(worker);
     change_state(worker, VPX_WORKER_STATUS_NOT_OK);
-    pthread_join(worker->impl_->thread_, NULL);
+    if (worker->pool_client == NULL) pthread_join(worker->impl_->thread_, NULL);
     pthread_mutex_destroy(&worker->impl_->mutex_);
     pthread_cond_destroy(&worker->impl_->condition_);
     vpx_free(worker->impl_);
@@ -220,3 +375,93 @@ const VPxWorkerInterface *vpx_get_worker_interface(void) {
 }
 
 //------------------------------------------------------------------------------
+
+vpx_thread_pool_t *vpx_thread_pool_create(int num_threads) {
+#if CONFIG_MULTITHREAD
+  vpx_thread_pool_t *pool;
+  int i;
+
+  if (num_threads < 1) return NULL;
+  pool = (vpx_thread_pool_t *)vpx_calloc(1, sizeof(*pool));
+  if (pool == NULL) return NULL;
+  pool->threads_ =
+      (pthread_t *)vpx_calloc(num_threads, sizeof(*pool->threads_));
+  if (pool->threads_ == NULL) goto Error;
+  if (pthread_mutex_init(&pool->mutex_, NULL)) goto Error;
+  if (pthread_cond_init(&pool->condition_, NULL)) {
+    pthread_mutex_destroy(&pool->mutex_);
+    goto Error;
+  }
+  for (i = 0; i < num_threads; ++i) {
+    if (pthread_create(&pool->threads_[i], NULL, pool_thread_loop, pool)) {
+      vpx_thread_pool_destroy(pool);
+      return NULL;
+    }
+    ++pool->num_threads_;
+  }
+  return pool;
+
+Error:
+  vpx_free(pool->threads_);
+  vpx_free(pool);
+  return NULL;
+#else
+  (void)num_threads;
+  return NULL;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void vpx_thread_pool_destroy(vpx_thread_pool_t *pool) {
+#if CONFIG_MULTITHREAD
+  int i;
+  if (pool == NULL) return;
+  pthread_mutex_lock(&pool->mutex_);
+  assert(pool->ready_head_ == NULL);
+  pool->shutdown_ = 1;
+  pthread_cond_broadcast(&pool->condition_);
+  pthread_mutex_unlock(&pool->mutex_);
+  for (i = 0; i < pool->num_threads_; ++i) {
+    pthread_join(pool->threads_[i], NULL);
+  }
+  pthread_mutex_destroy(&pool->mutex_);
+  pthread_cond_destroy(&pool->condition_);
+  vpx_free(pool->threads_);
+  vpx_free(pool);
+#else
+  (void)pool;
+#endif  // CONFIG_MULTITHREAD
+}
+
+int vpx_thread_pool_get_num_threads(const vpx_thread_pool_t *pool) {
+#if CONFIG_MULTITHREAD
+  return pool != NULL ? pool->num_threads_ : 0;
+#else
+  (void)pool;
+  return 0;
+#endif  // CONFIG_MULTITHREAD
+}
+
+VPxThreadPoolClient *vpx_thread_pool_client_create(vpx_thread_pool_t *pool) {
+#if CONFIG_MULTITHREAD
+  VPxThreadPoolClient *client;
+  if (pool == NULL) return NULL;
+  client = (VPxThreadPoolClient *)vpx_calloc(1, sizeof(*client));
+  if (client != NULL) client->pool_ = pool;
+  return client;
+#else
+  (void)pool;
+  return NULL;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void vpx_thread_pool_client_destroy(VPxThreadPoolClient *client) {
+#if CONFIG_MULTITHREAD
+  if (client == NULL) return;
+  assert(client->head_ == NULL);
+  vpx_free(client);
+#else
+  (void)client;
+#endif  // CONFIG_MULTITHREAD
+}
+
+//------------------------------------------------------------------------------
@@ -15,6 +15,8 @@
 #ifndef VPX_VPX_UTIL_VPX_THREAD_H_
 #define VPX_VPX_UTIL_VPX_THREAD_H_
 
+#include "vpx/vpx_thread_pool.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -34,6 +36,11 @@ typedef int (*VPxWorkerHook)(void *, void *);
 // Platform-dependent implementation details for the worker.
 typedef struct VPxWorkerImpl VPxWorkerImpl;
 
+// A codec instance's connection to a shared vpx_thread_pool_t. Workers of the
+// same client are started in launch order. Pool threads take the next worker
+// from each client with pending work in turn.
+typedef struct VPxThreadPoolClient VPxThreadPoolClient;
+
 // Synchronization object used to launch job in the worker thread
 typedef struct {
   VPxWorkerImpl *impl_;
@@ -46,6 +53,12 @@ typedef struct {
   void *data1;         // first argument passed to 'hook'
   void *data2;         // second argument passed to 'hook'
   int had_error;       // true if a call to 'hook' returned false
+  // If not NULL when reset() is called, launch() runs the hook on a thread of
+  // the client's pool instead of a thread owned by the worker. As pool threads
+  // are shared, a launched hook may only wait on work that was launched
+  // before it or that runs on the thread that calls sync(). sync() and end()
+  // run a hook that no pool thread has picked up yet on the calling thread.
+  VPxThreadPoolClient *pool_client;
 } VPxWorker;
 
 // The interface for all thread-worker related functions. All these functions
@@ -83,6 +96,15 @@ int vpx_set_worker_interface(const VPxWorkerInterface *const winterface);
 // Retrieve the currently set thread worker interface.
 const VPxWorkerInterface *vpx_get_worker_interface(void);
 
+// Returns the number of threads of 'pool', 0 if 'pool' is NULL.
+int vpx_thread_pool_get_num_threads(const vpx_thread_pool_t *pool);
+
+// Attaches a new client to 'pool'. Returns NULL on allocation failure.
+VPxThreadPoolClient *vpx_thread_pool_client_create(vpx_thread_pool_t *pool);
+
+// Detaches 'client' from its pool. All workers using it must have been ended.
+void vpx_thread_pool_client_destroy(VPxThreadPoolClient *client);
+
 //------------------------------------------------------------------------------
 
 #ifdef __cplusplus
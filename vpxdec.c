@@ -77,7 +77,7 @@ static const arg_def_t outputfile =
 static const arg_def_t threadsarg =
     ARG_DEF("t", "threads", 1, "Max threads to use");
 static const arg_def_t frameparallelarg =
-    ARG_DEF(NULL, "frame-parallel", 0, "Frame parallel decode (ignored)");
+    ARG_DEF(NULL, "frame-parallel", 0, "Frame parallel decode");
 static const arg_def_t verbosearg =
     ARG_DEF("v", "verbose", 0, "Show version string");
 static const arg_def_t error_concealment =
@@ -530,6 +530,7 @@ static int main_loop(int argc, const char **argv_) {
   int keep_going = 0;
   int enable_row_mt = 0;
   int enable_lpf_opt = 0;
+  int frame_parallel = 0;
   const VpxInterface *interface = NULL;
   const VpxInterface *fourcc_interface = NULL;
   uint64_t dx_time = 0;
@@ -629,9 +630,8 @@ static int main_loop(int argc, const char **argv_) {
     else if (arg_match(&arg, &threadsarg, argi))
       cfg.threads = arg_parse_uint(&arg);
 #if CONFIG_VP9_DECODER
-    else if (arg_match(&arg, &frameparallelarg, argi)) {
-      /* ignored for compatibility */
-    }
+    else if (arg_match(&arg, &frameparallelarg, argi))
+      frame_parallel = 1;
 #endif
     else if (arg_match(&arg, &verbosearg, argi))
       quiet = 0;
@@ -798,6 +798,12 @@ static int main_loop(int argc, const char **argv_) {
             vpx_codec_error(&decoder));
     goto fail;
   }
+  if (interface->fourcc == VP9_FOURCC && frame_parallel &&
+      vpx_codec_control(&decoder, VP9D_SET_FRAME_PARALLEL, frame_parallel)) {
+    fprintf(stderr, "Failed to set decoder in frame parallel mode: %s\n",
+            vpx_codec_error(&decoder));
+    goto fail;
+  }
   if (!quiet) fprintf(stderr, "%s\n", decoder.name);
 
 #if CONFIG_VP8_DECODER
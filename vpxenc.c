@@ -539,6 +539,22 @@ static const arg_def_t validate_hbd_input =
             "Check that input samples are within the valid range "
             "for the chosen bit depth with high bit depth encoding (0: "
             "disabled, 1: enabled (default))");
+static const arg_def_t frame_pipelining =
+    ARG_DEF(NULL, "frame-pipelining", 1,
+            "Filter the next alt-ref frame while the current frame is "
+            "finished in two pass VP9 (0: disabled (default), 1: enabled)");
+static const arg_def_t recode_interpolation =
+    ARG_DEF(NULL, "recode-interpolation", 1,
+            "Pick the q of frame recodes from the sizes of the previous "
+            "attempts (0: disabled (default), 1: enabled)");
+static const arg_def_t thread_invariant =
+    ARG_DEF(NULL, "thread-invariant", 1,
+            "Make the output independent of the number of threads with "
+            "row-mt (0: disabled (default), 1: enabled)");
+static const arg_def_t frame_parallel_first_pass =
+    ARG_DEF(NULL, "frame-parallel-first-pass", 1,
+            "Analyse several frames at once, one per thread, in the first "
+            "pass (0: disabled (default), 1: enabled)");
 #endif
 
 #if CONFIG_VP9_ENCODER
@@ -572,6 +588,10 @@ static const arg_def_t *vp9_args[] = { &cpu_used_vp9,
                                        &row_mt,
                                        &disable_loopfilter,
                                        &validate_hbd_input,
+                                       &frame_pipelining,
+                                       &recode_interpolation,
+                                       &thread_invariant,
+                                       &frame_parallel_first_pass,
 // NOTE: The entries above have a corresponding entry in vp9_arg_ctrl_map. The
 // entries below do not have a corresponding entry in vp9_arg_ctrl_map. They
 // must be listed at the end of vp9_args.
@@ -610,6 +630,10 @@ static const int vp9_arg_ctrl_map[] = { VP8E_SET_CPUUSED,
                                         VP9E_SET_ROW_MT,
                                         VP9E_SET_DISABLE_LOOPFILTER,
                                         VP9E_SET_VALIDATE_HBD_INPUT,
+                                        VP9E_SET_FRAME_PIPELINING,
+                                        VP9E_SET_RECODE_INTERPOLATION,
+                                        VP9E_SET_THREAD_INVARIANT,
+                                        VP9E_SET_FRAME_PARALLEL_FIRST_PASS,
                                         0 };
 #endif
 